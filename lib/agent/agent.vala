@@ -59,6 +59,9 @@ namespace Frida.Agent {
 		private bool unloading = false;
 		private uint filter_id = 0;
 		private uint registration_id = 0;
+#if LINUX
+		private uint ring_registration_id = 0;
+#endif
 		private uint pending_calls = 0;
 		private Promise<bool> pending_close;
 		private Gee.Map<AgentSessionId?, LiveAgentSession> sessions =
@@ -788,8 +791,9 @@ namespace Frida.Agent {
 
 				AgentSessionProvider emulated_provider = yield get_emulated_provider (cancellable);
 
-				var emulated_opts = new SessionOptions ();
-				emulated_opts.persist_timeout = opts.persist_timeout;
+				var emulated_opts = SessionOptions._deserialize (options);
+				emulated_opts.realm = NATIVE;
+				emulated_opts.emulated_agent_path = null;
 
 				try {
 					yield emulated_provider.open (id, emulated_opts._serialize (), cancellable);
@@ -826,7 +830,7 @@ namespace Frida.Agent {
 
 			MainContext dbus_context = yield get_dbus_context ();
 
-			var session = new LiveAgentSession (this, id, opts.persist_timeout, sink, dbus_context);
+			var session = new LiveAgentSession (this, id, opts, sink, dbus_context);
 			sessions[id] = session;
 			session.closed.connect (on_session_closed);
 			session.script_eternalized.connect (on_script_eternalized);
@@ -1116,8 +1120,12 @@ namespace Frida.Agent {
 			var app_info = HostApplicationInfo (identifier, name, pid, make_parameters_dict ());
 			app_info.parameters["system"] = compute_system_parameters ();
 
+			var endpoint_params = new EndpointParameters ();
+			endpoint_params.max_frame_size = options.max_frame_size;
+			endpoint_params.compression = options.compression;
+
 			var client = new PortalClient (this, parse_cluster_address (address), address, options.certificate, options.token,
-				options.acl, app_info);
+				options.acl, app_info, endpoint_params);
 			client.kill.connect (on_kill);
 			yield client.start (cancellable);
 
@@ -1182,6 +1190,11 @@ namespace Frida.Agent {
 				AgentSessionProvider provider = this;
 				registration_id = connection.register_object (ObjectPath.AGENT_SESSION_PROVIDER, provider);
 
+#if LINUX
+				MessageRingProvider ring_provider = new MessageRingService (this);
+				ring_registration_id = connection.register_object (ObjectPath.MESSAGE_RING_PROVIDER, ring_provider);
+#endif
+
 				controller = yield connection.get_proxy (null, ObjectPath.AGENT_CONTROLLER, DO_NOT_LOAD_PROPERTIES, null);
 
 				connection.start_message_processing ();
@@ -1248,6 +1261,13 @@ namespace Frida.Agent {
 				registration_id = 0;
 			}
 
+#if LINUX
+			if (ring_registration_id != 0) {
+				connection.unregister_object (ring_registration_id);
+				ring_registration_id = 0;
+			}
+#endif
+
 			if (filter_id != 0) {
 				connection.remove_filter (filter_id);
 				filter_id = 0;
@@ -1495,6 +1515,34 @@ namespace Frida.Agent {
 			child_gating_changed (subscriber_count);
 		}
 
+#if LINUX
+		private class MessageRingService : Object, MessageRingProvider {
+			private weak Runner runner;
+
+			public MessageRingService (Runner runner) {
+				this.runner = runner;
+			}
+
+			public async void open_message_ring (AgentSessionId id, UnixInputStream memfd, UnixInputStream data_event,
+					UnixInputStream space_event, Cancellable? cancellable) throws Error, IOError {
+				LiveAgentSession? session = runner.sessions[id];
+				if (session == null)
+					throw new Error.INVALID_ARGUMENT ("Invalid session ID");
+
+				// On re-link the host has already closed the previous ring, which then keeps draining into its fallback.
+				AgentMessageSink fallback = session.message_sink;
+				var previous = fallback as MessageRingSink;
+				if (previous != null)
+					fallback = previous.fallback;
+
+				var ring = MessageRing.open (memfd.fd, data_event.fd, space_event.fd);
+				var sink = new MessageRingSink (ring, fallback);
+				session.message_sink = sink;
+				session.closed.connect (() => sink.close ());
+			}
+		}
+
+#endif
 		private class NativeBridgeApi {
 			public Flavor flavor;
 			public NBLoadLibraryFunc load_library;
@@ -1627,13 +1675,14 @@ namespace Frida.Agent {
 			set;
 		}
 
-		public LiveAgentSession (ProcessInvader invader, AgentSessionId id, uint persist_timeout, AgentMessageSink sink,
+		public LiveAgentSession (ProcessInvader invader, AgentSessionId id, SessionOptions opts, AgentMessageSink sink,
 				MainContext dbus_context) {
 			Object (
 				invader: invader,
 				id: id,
-				persist_timeout: persist_timeout,
+				persist_timeout: opts.persist_timeout,
 				message_sink: sink,
+				session_options: opts,
 				frida_context: MainContext.ref_thread_default (),
 				dbus_context: dbus_context
 			);
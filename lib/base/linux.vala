@@ -67,16 +67,45 @@ namespace Frida {
 			return check_kernel_version (3, 17);
 		}
 
-		public static FileDescriptor from_bytes (string name, Bytes bytes) {
+		public static FileDescriptor create (string name) {
 			assert (is_supported ());
 
-			var fd = new FileDescriptor (memfd_create (name, 0));
+			return new FileDescriptor (memfd_create (name, 0));
+		}
+
+		public static FileDescriptor from_bytes (string name, Bytes bytes) {
+			var fd = create (name);
 			unowned uint8[] data = bytes.get_data ();
 			ssize_t n = Posix.write (fd.handle, data, data.length);
 			assert (n == data.length);
 			return fd;
 		}
 
+		public static FileDescriptor create_sealable (string name) {
+			assert (is_supported ());
+
+			int handle = memfd_create (name, MFD_ALLOW_SEALING);
+			if (handle == -1)
+				handle = memfd_create (name, 0);
+			return new FileDescriptor (handle);
+		}
+
+		/*
+		 * Makes the contents immutable so that the same descriptor can safely be shared between injections. Returns false
+		 * if the kernel refuses, e.g. because the memfd was created without sealing support.
+		 */
+		public static bool seal (FileDescriptor fd) {
+			return Posix.fcntl (fd.handle, F_ADD_SEALS, F_SEAL_SEAL | F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE) == 0;
+		}
+
+		private const uint MFD_ALLOW_SEALING = 0x0002;
+
+		private const int F_ADD_SEALS = 1033;
+		private const int F_SEAL_SEAL = 0x0001;
+		private const int F_SEAL_SHRINK = 0x0002;
+		private const int F_SEAL_GROW = 0x0004;
+		private const int F_SEAL_WRITE = 0x0008;
+
 		private int memfd_create (string name, uint flags) {
 			return Linux.syscall (SysCall.memfd_create, name, flags);
 		}
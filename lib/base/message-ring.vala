@@ -0,0 +1,552 @@
+namespace Frida {
+	/*
+	 * Single-producer single-consumer ring of AgentMessage batches, living in a memfd shared between an agent (producer)
+	 * and its host (consumer). Each side only kicks the other's eventfd when that side has announced that it's about to
+	 * sleep, so a busy ring costs no syscalls at all.
+	 */
+	public sealed class MessageRing : Object {
+		public FileDescriptor memfd {
+			get;
+			construct;
+		}
+
+		public FileDescriptor data_event {
+			get;
+			construct;
+		}
+
+		public FileDescriptor space_event {
+			get;
+			construct;
+		}
+
+		// Small enough that a record always fits in an empty ring, even when it has to wrap.
+		public size_t max_record_size {
+			get {
+				return capacity / 4;
+			}
+		}
+
+		// Sequence number of the last record that the host has handed to its sink.
+		public uint acked {
+			get {
+				return AtomicUint.get (ref header->acked);
+			}
+		}
+
+		// Set by either side when it stops taking part, after which the producer falls back to D-Bus.
+		public bool closed {
+			get {
+				return AtomicInt.get (ref header->closed) != 0;
+			}
+		}
+
+		private uint capacity;
+		private void * mapping;
+		private size_t mapping_size;
+		private Header * header;
+		private uint8 * data;
+
+		private uint pending_head;
+		private uint consumer_tail = 0;
+
+		private UnixInputStream data_input;
+		private UnixInputStream space_input;
+		private uint8[] event_buffer = new uint8[sizeof (uint64)];
+
+		public const uint DEFAULT_CAPACITY = 4 * 1024 * 1024;
+
+		private const uint MAGIC = 0x474e5247;
+		private const size_t HEADER_SIZE = 4096;
+		private const uint32 WRAP_MARKER = uint32.MAX;
+		private const uint RECORD_ALIGNMENT = 8;
+
+		private struct Header {
+			public uint magic;
+			public uint capacity;
+			public uint head;
+			public uint tail;
+			public uint acked;
+			public int closed;
+			public int reader_waiting;
+			public int writer_waiting;
+		}
+
+		private MessageRing (FileDescriptor memfd, FileDescriptor data_event, FileDescriptor space_event) {
+			Object (memfd: memfd, data_event: data_event, space_event: space_event);
+		}
+
+		construct {
+			data_input = new UnixInputStream (data_event.handle, false);
+			space_input = new UnixInputStream (space_event.handle, false);
+		}
+
+		~MessageRing () {
+			if (mapping != null)
+				Posix.munmap (mapping, mapping_size);
+		}
+
+		public static MessageRing create (uint capacity = DEFAULT_CAPACITY) throws Error {
+			assert (capacity != 0 && (capacity & (capacity - 1)) == 0);
+
+			var memfd = MemoryFileDescriptor.create ("frida-message-ring");
+			if (Posix.ftruncate (memfd.handle, (Posix.off_t) (HEADER_SIZE + capacity)) != 0)
+				throw new Error.NOT_SUPPORTED ("Unable to size message ring: %s", strerror (errno));
+
+			var ring = new MessageRing (memfd, make_event (), make_event ());
+			ring.map (capacity);
+			ring.header->magic = MAGIC;
+			ring.header->capacity = capacity;
+
+			return ring;
+		}
+
+		public static MessageRing open (int memfd, int data_event, int space_event) throws Error {
+			var ring = new MessageRing (new FileDescriptor (Posix.dup (memfd)), new FileDescriptor (Posix.dup (data_event)),
+				new FileDescriptor (Posix.dup (space_event)));
+
+			Posix.Stat st;
+			if (Posix.fstat (ring.memfd.handle, out st) != 0 || st.st_size <= HEADER_SIZE)
+				throw new Error.INVALID_ARGUMENT ("Invalid message ring");
+			uint capacity = (uint) (st.st_size - HEADER_SIZE);
+			if ((capacity & (capacity - 1)) != 0)
+				throw new Error.INVALID_ARGUMENT ("Invalid message ring");
+			ring.map (capacity);
+			if (ring.header->magic != MAGIC || ring.header->capacity != capacity)
+				throw new Error.INVALID_ARGUMENT ("Invalid message ring");
+
+			return ring;
+		}
+
+		private static FileDescriptor make_event () throws Error {
+			int fd = eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+			if (fd == -1)
+				throw new Error.NOT_SUPPORTED ("Unable to create eventfd: %s", strerror (errno));
+			return new FileDescriptor (fd);
+		}
+
+		private void map (uint capacity) throws Error {
+			size_t size = HEADER_SIZE + capacity;
+			void * address = Posix.mmap (null, size, Posix.PROT_READ | Posix.PROT_WRITE, Posix.MAP_SHARED, memfd.handle, 0);
+			if (address == Posix.MAP_FAILED)
+				throw new Error.NOT_SUPPORTED ("Unable to map message ring: %s", strerror (errno));
+
+			this.capacity = capacity;
+			mapping = address;
+			mapping_size = size;
+			header = (Header *) address;
+			data = (uint8 *) address + HEADER_SIZE;
+		}
+
+		public void close () {
+			AtomicInt.set (ref header->closed, 1);
+
+			// The other side may be just about to sleep, so wake it up unconditionally.
+			signal_event (data_event);
+			signal_event (space_event);
+		}
+
+		public uint8 * try_reserve (size_t size) {
+			assert (size <= max_record_size);
+
+			uint needed = record_size (size);
+			uint skip;
+			if (closed || !has_space (needed, out skip))
+				return null;
+
+			uint head = header->head;
+			uint offset = head & (capacity - 1);
+			if (skip != 0) {
+				write_u32 (data + offset, WRAP_MARKER);
+				head += skip;
+				offset = 0;
+			}
+
+			write_u32 (data + offset, (uint32) size);
+			pending_head = head + needed;
+
+			return data + offset + sizeof (uint32);
+		}
+
+		private bool has_space (uint needed, out uint skip) {
+			uint head = header->head;
+			uint tail = AtomicUint.get (ref header->tail);
+			uint contiguous = capacity - (head & (capacity - 1));
+			skip = (needed > contiguous) ? contiguous : 0;
+			return (head - tail) + skip + needed <= capacity;
+		}
+
+		public void commit () {
+			AtomicUint.set (ref header->head, pending_head);
+
+			if (AtomicInt.get (ref header->reader_waiting) != 0)
+				signal_event (data_event);
+		}
+
+		/*
+		 * Copies the next record out of the ring and releases its space. The producer shares the memory, so only our own
+		 * tail is trusted: any inconsistency is reported as an error, after which the ring should be closed.
+		 */
+		public Bytes? try_take () throws Error {
+			uint tail = consumer_tail;
+			uint head = AtomicUint.get (ref header->head);
+			if (tail == head)
+				return null;
+			if (head - tail > capacity)
+				throw new Error.PROTOCOL ("Corrupted message ring");
+
+			uint offset = tail & (capacity - 1);
+			uint32 n = read_u32 (data + offset);
+			if (n == WRAP_MARKER) {
+				tail += capacity - offset;
+				offset = 0;
+				if (tail == head || head - tail > capacity)
+					throw new Error.PROTOCOL ("Corrupted message ring");
+				n = read_u32 (data);
+			}
+
+			if (n > max_record_size || record_size (n) > head - tail || offset + sizeof (uint32) + n > capacity)
+				throw new Error.PROTOCOL ("Corrupted message ring");
+
+			var record = new uint8[n];
+			Memory.copy (record, data + offset + sizeof (uint32), n);
+
+			consumer_tail = tail + record_size (n);
+			AtomicUint.set (ref header->tail, consumer_tail);
+			if (AtomicInt.get (ref header->writer_waiting) != 0)
+				signal_event (space_event);
+
+			return new Bytes.take ((owned) record);
+		}
+
+		public void acknowledge (uint seq) {
+			AtomicUint.set (ref header->acked, seq);
+
+			if (AtomicInt.get (ref header->writer_waiting) != 0)
+				signal_event (space_event);
+		}
+
+		public async void wait_for_data (Cancellable? cancellable) throws IOError {
+			AtomicInt.set (ref header->reader_waiting, 1);
+			try {
+				if (AtomicUint.get (ref header->head) == consumer_tail && !closed)
+					yield data_input.read_async (event_buffer, Priority.DEFAULT, cancellable);
+			} finally {
+				AtomicInt.set (ref header->reader_waiting, 0);
+			}
+		}
+
+		/*
+		 * Waits until the host acknowledges past observed_acked, until there is room for a record of pending_size bytes
+		 * (if non-zero), or until the ring is closed.
+		 */
+		public async void wait_for_progress (uint observed_acked, size_t pending_size, Cancellable? cancellable)
+				throws IOError {
+			AtomicInt.set (ref header->writer_waiting, 1);
+			try {
+				uint skip;
+				if (!closed && acked == observed_acked &&
+						(pending_size == 0 || !has_space (record_size (pending_size), out skip))) {
+					yield space_input.read_async (event_buffer, Priority.DEFAULT, cancellable);
+				}
+			} finally {
+				AtomicInt.set (ref header->writer_waiting, 0);
+			}
+		}
+
+		private static uint record_size (size_t payload_size) {
+			return (uint) ((sizeof (uint32) + payload_size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1));
+		}
+
+		private static void signal_event (FileDescriptor fd) {
+			uint64 one = 1;
+			Posix.write (fd.handle, &one, sizeof (uint64));
+		}
+
+		private static uint32 read_u32 (uint8 * p) {
+			uint32 v;
+			Memory.copy (&v, p, sizeof (uint32));
+			return v;
+		}
+
+		private static void write_u32 (uint8 * p, uint32 v) {
+			Memory.copy (p, &v, sizeof (uint32));
+		}
+	}
+
+	/*
+	 * Producer end, used by the agent in place of its D-Bus AgentMessageSink. A batch only completes once the host has
+	 * handed it to its own sink, just like over D-Bus. Batches too large for the ring go through the fallback sink, but
+	 * only once everything before them has been acknowledged, so that ordering is preserved. Once the ring is closed,
+	 * by either side, everything goes through the fallback sink.
+	 */
+	public sealed class MessageRingSink : Object, AgentMessageSink {
+		public MessageRing ring {
+			get;
+			construct;
+		}
+
+		public AgentMessageSink fallback {
+			get;
+			construct;
+		}
+
+		private Gee.ArrayQueue<PendingBatch> queue = new Gee.ArrayQueue<PendingBatch> ();
+		private Gee.ArrayQueue<PendingBatch> unacked = new Gee.ArrayQueue<PendingBatch> ();
+		private uint next_seq = 1;
+		private bool processing = false;
+		private Cancellable io_cancellable = new Cancellable ();
+
+		public MessageRingSink (MessageRing ring, AgentMessageSink fallback) {
+			Object (ring: ring, fallback: fallback);
+		}
+
+		public void close () {
+			io_cancellable.cancel ();
+			ring.close ();
+		}
+
+		public async void post_messages (AgentMessage[] messages, uint batch_id, Cancellable? cancellable) throws GLib.Error {
+			var batch = new PendingBatch (messages, batch_id);
+			if (!queue.is_empty || !try_write (batch))
+				queue.offer (batch);
+			else
+				unacked.offer (batch);
+			if (!processing)
+				process_batches.begin ();
+
+			yield batch.delivered.future.wait_async (cancellable);
+		}
+
+		private async void process_batches () {
+			processing = true;
+
+			while (!queue.is_empty || !unacked.is_empty) {
+				uint acked = ring.acked;
+				PendingBatch? batch;
+				while ((batch = unacked.peek ()) != null && (int) (acked - batch.seq) >= 0) {
+					unacked.poll ();
+					batch.delivered.resolve (true);
+				}
+
+				bool usable = !ring.closed && !io_cancellable.is_cancelled ();
+				if (!usable) {
+					while ((batch = unacked.poll ()) != null)
+						batch.delivered.reject (new Error.TRANSPORT ("Message ring closed before the batch was consumed"));
+				}
+
+				size_t pending_size = 0;
+				batch = queue.peek ();
+				if (batch != null) {
+					if (usable && batch.size <= ring.max_record_size) {
+						if (try_write (batch)) {
+							queue.poll ();
+							unacked.offer (batch);
+							continue;
+						}
+						pending_size = batch.size;
+					} else if (unacked.is_empty) {
+						queue.poll ();
+						try {
+							yield fallback.post_messages (batch.messages, batch.batch_id, io_cancellable);
+							batch.delivered.resolve (true);
+						} catch (GLib.Error e) {
+							batch.delivered.reject (e);
+						}
+						continue;
+					}
+				}
+
+				try {
+					yield ring.wait_for_progress (acked, pending_size, io_cancellable);
+				} catch (IOError e) {
+					ring.close ();
+				}
+			}
+
+			processing = false;
+		}
+
+		private bool try_write (PendingBatch batch) {
+			if (batch.size > ring.max_record_size || io_cancellable.is_cancelled ())
+				return false;
+
+			uint8 * record = ring.try_reserve (batch.size);
+			if (record == null)
+				return false;
+			batch.seq = next_seq++;
+			MessageRingRecord.encode (batch.messages, batch.batch_id, batch.seq, record);
+			ring.commit ();
+
+			return true;
+		}
+
+		private class PendingBatch {
+			public AgentMessage[] messages;
+			public uint batch_id;
+			public size_t size;
+			public uint seq;
+			public Promise<bool> delivered = new Promise<bool> ();
+
+			public PendingBatch (AgentMessage[] messages, uint batch_id) {
+				this.messages = messages;
+				this.batch_id = batch_id;
+				this.size = MessageRingRecord.measure (messages);
+			}
+		}
+	}
+
+	/*
+	 * Consumer end, used by the host to forward batches from the ring to the AgentMessageSink it would otherwise have
+	 * exposed over D-Bus. A record that fails validation closes the ring, which makes the agent fall back to D-Bus.
+	 */
+	public sealed class MessageRingReader : Object {
+		public MessageRing ring {
+			get;
+			construct;
+		}
+
+		public AgentMessageSink sink {
+			get;
+			construct;
+		}
+
+		private Gee.ArrayQueue<Delivery> deliveries = new Gee.ArrayQueue<Delivery> ();
+		private Cancellable io_cancellable = new Cancellable ();
+
+		public MessageRingReader (MessageRing ring, AgentMessageSink sink) {
+			Object (ring: ring, sink: sink);
+		}
+
+		construct {
+			process_records.begin ();
+		}
+
+		public void close () {
+			io_cancellable.cancel ();
+			ring.close ();
+		}
+
+		private async void process_records () {
+			try {
+				while (true) {
+					Bytes? record;
+					while ((record = ring.try_take ()) != null) {
+						uint seq, batch_id;
+						AgentMessage[] messages = MessageRingRecord.decode (record, out seq, out batch_id);
+						deliver.begin (messages, batch_id, seq);
+					}
+
+					if (ring.closed)
+						break;
+
+					yield ring.wait_for_data (io_cancellable);
+				}
+			} catch (GLib.Error e) {
+				ring.close ();
+			}
+		}
+
+		private async void deliver (AgentMessage[] messages, uint batch_id, uint seq) {
+			var delivery = new Delivery (seq);
+			deliveries.offer (delivery);
+
+			try {
+				yield sink.post_messages (messages, batch_id, io_cancellable);
+			} catch (GLib.Error e) {
+			}
+			delivery.done = true;
+
+			if (io_cancellable.is_cancelled ())
+				return;
+
+			// Acknowledge in order, as the agent treats an acknowledgement as covering every record before it.
+			Delivery? d;
+			while ((d = deliveries.peek ()) != null && d.done) {
+				deliveries.poll ();
+				ring.acknowledge (d.seq);
+			}
+		}
+
+		private class Delivery {
+			public uint seq;
+			public bool done = false;
+
+			public Delivery (uint seq) {
+				this.seq = seq;
+			}
+		}
+	}
+
+	namespace MessageRingRecord {
+		private const size_t BATCH_HEADER_SIZE = 3 * sizeof (uint32);
+		private const size_t MESSAGE_HEADER_SIZE = 4 * sizeof (uint32);
+		private const uint32 NO_DATA = uint32.MAX;
+
+		public size_t measure (AgentMessage[] messages) {
+			size_t size = BATCH_HEADER_SIZE;
+			foreach (unowned AgentMessage m in messages)
+				size += MESSAGE_HEADER_SIZE + m.text.length + m.data.length;
+			return size;
+		}
+
+		public void encode (AgentMessage[] messages, uint batch_id, uint seq, uint8 * record) {
+			uint8 * p = record;
+			p = put_u32 (p, seq);
+			p = put_u32 (p, batch_id);
+			p = put_u32 (p, messages.length);
+			foreach (unowned AgentMessage m in messages) {
+				p = put_u32 (p, m.kind);
+				p = put_u32 (p, m.script_id.handle);
+				p = put_u32 (p, m.text.length);
+				p = put_u32 (p, m.has_data ? m.data.length : NO_DATA);
+
+				Memory.copy (p, m.text, m.text.length);
+				p += m.text.length;
+
+				if (m.has_data) {
+					Memory.copy (p, m.data, m.data.length);
+					p += m.data.length;
+				}
+			}
+		}
+
+		public AgentMessage[] decode (Bytes record, out uint seq, out uint batch_id) throws Error {
+			var reader = new BufferReader (new Buffer (record));
+
+			seq = reader.read_uint32 ();
+			batch_id = reader.read_uint32 ();
+			uint n = reader.read_uint32 ();
+			if (n > reader.available / MESSAGE_HEADER_SIZE)
+				throw new Error.PROTOCOL ("Malformed message ring record");
+
+			var messages = new AgentMessage[n];
+			for (uint i = 0; i != n; i++) {
+				var kind = (AgentMessageKind) reader.read_uint32 ();
+				var script_id = AgentScriptId (reader.read_uint32 ());
+				uint32 text_length = reader.read_uint32 ();
+				uint32 data_length = reader.read_uint32 ();
+
+				string text = reader.read_fixed_string (text_length);
+
+				bool has_data = data_length != NO_DATA;
+				uint8[] data = {};
+				if (has_data) {
+					Bytes bytes = reader.read_bytes (data_length);
+					data = bytes.get_data ();
+				}
+
+				messages[i] = AgentMessage (kind, script_id, text, has_data, data);
+			}
+			if (reader.available != 0)
+				throw new Error.PROTOCOL ("Malformed message ring record");
+
+			return messages;
+		}
+
+		private uint8 * put_u32 (uint8 * p, uint32 v) {
+			Memory.copy (p, &v, sizeof (uint32));
+			return p + sizeof (uint32);
+		}
+	}
+}
@@ -163,6 +163,7 @@ _frida_sctp_connection_create_sctp_socket (FridaSctpConnection * self)
   };
   guint i;
   int recv_rcvinfo;
+  int interleave;
   struct sctp_assoc_value assoc;
 
   usrsctp_register_address (self);
@@ -193,6 +194,18 @@ _frida_sctp_connection_create_sctp_socket (FridaSctpConnection * self)
   assoc.assoc_value = SCTP_ENABLE_RESET_STREAM_REQ | SCTP_ENABLE_CHANGE_ASSOC_REQ;
   usrsctp_setsockopt (sock, IPPROTO_SCTP, SCTP_ENABLE_STREAM_RESET, &assoc, sizeof (assoc));
 
+  /* Let fragments of different messages interleave (RFC 8260) so one large message cannot block other streams. */
+  interleave = 2;
+  usrsctp_setsockopt (sock, IPPROTO_SCTP, SCTP_FRAGMENT_INTERLEAVE, &interleave, sizeof (interleave));
+
+  assoc.assoc_id = SCTP_FUTURE_ASSOC;
+  assoc.assoc_value = 1;
+  usrsctp_setsockopt (sock, IPPROTO_SCTP, SCTP_INTERLEAVING_SUPPORTED, &assoc, sizeof (assoc));
+
+  assoc.assoc_id = SCTP_FUTURE_ASSOC;
+  assoc.assoc_value = SCTP_SS_PRIORITY;
+  usrsctp_setsockopt (sock, IPPROTO_SCTP, SCTP_PLUGGABLE_SS, &assoc, sizeof (assoc));
+
   return sock;
 }
 
@@ -313,7 +326,7 @@ propagate_usrsctp_error:
 
 gssize
 _frida_sctp_connection_send (void * sock, guint16 stream_id, FridaPayloadProtocolId protocol_id, guint8 * data, gint data_length,
-      GError ** error)
+      FridaSctpSendFlags flags, GError ** error)
 {
   gssize n;
   struct sctp_sendv_spa spa;
@@ -324,10 +337,19 @@ _frida_sctp_connection_send (void * sock, guint16 stream_id, FridaPayloadProtoco
   si = &spa.sendv_sndinfo;
   si->snd_sid = stream_id;
   si->snd_flags = SCTP_EOR;
+  if ((flags & FRIDA_SCTP_SEND_FLAGS_UNORDERED) != 0)
+    si->snd_flags |= SCTP_UNORDERED;
   si->snd_ppid = htonl (protocol_id);
   si->snd_context = 0;
   si->snd_assoc_id = 0;
 
+  if ((flags & FRIDA_SCTP_SEND_FLAGS_NO_RETRANSMIT) != 0)
+  {
+    spa.sendv_flags |= SCTP_SEND_PRINFO_VALID;
+    spa.sendv_prinfo.pr_policy = SCTP_PR_SCTP_RTX;
+    spa.sendv_prinfo.pr_value = 0;
+  }
+
   n = usrsctp_sendv (sock, data, data_length, NULL, 0, &spa, sizeof (spa), SCTP_SENDV_SPA, 0);
   if (n == -1)
     goto propagate_usrsctp_error;
@@ -341,6 +363,18 @@ propagate_usrsctp_error:
   }
 }
 
+void
+_frida_sctp_connection_set_stream_priority (void * sock, guint16 stream_id, guint16 priority)
+{
+  struct sctp_stream_value value;
+
+  value.assoc_id = SCTP_ALL_ASSOC;
+  value.stream_id = stream_id;
+  /* The priority scheduler serves lower values first, whereas WebRTC priorities grow with importance. */
+  value.stream_value = G_MAXUINT16 - priority;
+  usrsctp_setsockopt (sock, IPPROTO_SCTP, SCTP_STREAM_SCHEDULER_VALUE, &value, sizeof (value));
+}
+
 gint
 _frida_sctp_timer_source_get_timeout (void)
 {
@@ -594,6 +594,15 @@ namespace Frida {
 		private uint16 stream_id;
 		private ByteArray dcep_message = new ByteArray ();
 
+		private Gee.Map<uint, SctpChannel> channels = new Gee.HashMap<uint, SctpChannel> ();
+		private uint16 next_channel_stream_id;
+
+		private const uint16 SESSION_PRIORITY = (uint16) MessagePriority.NORMAL;
+		private const uint16 MAX_STREAMS = 1024;
+		private const size_t DCEP_OPEN_HEADER_SIZE = 12;
+
+		public signal void channel_opened (SctpChannel channel);
+
 		public SctpConnection (DatagramBased transport_socket, PeerSetup setup, uint16 port, size_t max_message_size) {
 			Object (
 				transport_socket: transport_socket,
@@ -610,6 +619,8 @@ namespace Frida {
 		protected extern static void _initialize_sctp_backend ();
 
 		construct {
+			next_channel_stream_id = (setup == ACTIVE) ? 3 : 2;
+
 			sctp_socket = _create_sctp_socket ();
 			_connect_sctp_socket (sctp_socket, port);
 
@@ -641,6 +652,9 @@ namespace Frida {
 		protected extern static IOCondition _query_sctp_socket_events (void * sock);
 
 		protected override void handle_close () {
+			lock (channels)
+				channels.clear ();
+
 			sctp_source.destroy ();
 			transport_source.destroy ();
 
@@ -678,6 +692,9 @@ namespace Frida {
 					throw new IOError.WOULD_BLOCK ("Resource temporarily unavailable");
 				} else if (protocol_id == NONE || state != OPEN) {
 					throw new IOError.WOULD_BLOCK ("Resource temporarily unavailable");
+				} else if (stream_id != this.stream_id) {
+					handle_channel_data (stream_id, buffer[0:n], (msg_flags & SctpMessageFlags.END_OF_RECORD) != 0);
+					throw new IOError.WOULD_BLOCK ("Resource temporarily unavailable");
 				}
 			} finally {
 				update_pending_io ();
@@ -693,12 +710,142 @@ namespace Frida {
 			ssize_t n = ssize_t.min (buffer.length, (ssize_t) max_message_size);
 
 			try {
-				return _send (sctp_socket, stream_id, WEBRTC_BINARY, buffer[0:n]);
+				return _send (sctp_socket, stream_id, WEBRTC_BINARY, buffer[0:n], NONE);
+			} finally {
+				update_pending_io ();
+			}
+		}
+
+		public SctpChannel open_channel (string label, uint16 priority, MessageDelivery delivery) throws IOError {
+			if (state != OPEN)
+				throw new IOError.NOT_CONNECTED ("Connection is not open");
+
+			uint16 id = next_channel_stream_id;
+			if (id >= MAX_STREAMS)
+				throw new IOError.NO_SPACE ("No more streams available");
+			next_channel_stream_id += 2;
+
+			var channel = new SctpChannel (this, label, id, priority, delivery);
+
+			try {
+				_send (sctp_socket, id, WEBRTC_DCEP, make_dcep_open_message (label, priority, delivery), NONE);
+			} finally {
+				update_pending_io ();
+			}
+			_set_stream_priority (sctp_socket, id, priority);
+
+			lock (channels)
+				channels[id] = channel;
+
+			return channel;
+		}
+
+		internal bool send_on_channel (SctpChannel channel, uint8[] data) throws IOError {
+			if (state != OPEN)
+				throw new IOError.NOT_CONNECTED ("Connection is not open");
+			if (data.length > max_message_size)
+				throw new IOError.MESSAGE_TOO_LARGE ("Message exceeds the maximum message size");
+
+			bool lossy = channel.delivery == LOSSY;
+
+			SctpSendFlags flags = NONE;
+			if (lossy) {
+				flags |= NO_RETRANSMIT;
+				/* RFC 8832: stay ordered until the peer has acknowledged the channel. */
+				if (channel.acknowledged)
+					flags |= UNORDERED;
+			}
+
+			try {
+				_send (sctp_socket, channel.stream_id, WEBRTC_BINARY, data, flags);
+				return true;
+			} catch (IOError e) {
+				if (lossy && e is IOError.WOULD_BLOCK)
+					return false;
+				throw e;
 			} finally {
 				update_pending_io ();
 			}
 		}
 
+		internal void close_channel (SctpChannel channel) {
+			lock (channels)
+				channels.unset (channel.stream_id);
+		}
+
+		private void handle_channel_open (uint16 stream_id, uint8[] message) throws IOError {
+			if (message.length < DCEP_OPEN_HEADER_SIZE)
+				return;
+
+			var buf = new Buffer (new Bytes (message), BIG_ENDIAN);
+			uint8 channel_type = buf.read_uint8 (1);
+			uint16 priority = buf.read_uint16 (2);
+			uint16 label_length = buf.read_uint16 (8);
+			if (DCEP_OPEN_HEADER_SIZE + label_length > message.length)
+				return;
+			string label;
+			try {
+				label = buf.read_fixed_string (DCEP_OPEN_HEADER_SIZE, label_length);
+			} catch (Error e) {
+				return;
+			}
+
+			MessageDelivery delivery = ((channel_type & DcepChannelType.PARTIAL_RELIABLE_REXMIT) != 0)
+				? MessageDelivery.LOSSY
+				: MessageDelivery.RELIABLE;
+
+			var channel = new SctpChannel (this, label, stream_id, priority, delivery);
+			channel.acknowledged = true;
+
+			uint8[] reply = { DcepMessageType.DATA_CHANNEL_ACK };
+			_send (sctp_socket, stream_id, WEBRTC_DCEP, reply, NONE);
+			_set_stream_priority (sctp_socket, stream_id, priority);
+
+			lock (channels)
+				channels[stream_id] = channel;
+
+			var source = new IdleSource ();
+			source.set_callback (() => {
+				channel_opened (channel);
+				return Source.REMOVE;
+			});
+			source.attach (main_context);
+		}
+
+		private void handle_channel_data (uint16 stream_id, uint8[] data, bool end_of_record) {
+			SctpChannel? channel;
+			lock (channels)
+				channel = channels[stream_id];
+			if (channel == null)
+				return;
+
+			Bytes? message = channel.assemble (data, end_of_record, max_message_size);
+			if (message == null)
+				return;
+
+			var source = new IdleSource ();
+			source.set_callback (() => {
+				channel.message (message);
+				return Source.REMOVE;
+			});
+			source.attach (main_context);
+		}
+
+		private static uint8[] make_dcep_open_message (string label, uint16 priority, MessageDelivery delivery) {
+			var builder = new BufferBuilder (BIG_ENDIAN);
+			builder
+				.append_uint8 (DcepMessageType.DATA_CHANNEL_OPEN)
+				.append_uint8 ((delivery == LOSSY)
+					? DcepChannelType.PARTIAL_RELIABLE_REXMIT_UNORDERED
+					: DcepChannelType.RELIABLE)
+				.append_uint16 (priority)
+				.append_uint32 (0)
+				.append_uint16 ((uint16) label.length)
+				.append_uint16 (0)
+				.append_data (label.data);
+			return builder.build ().get_data ();
+		}
+
 		private bool on_transport_socket_readable (DatagramBased datagram_based, IOCondition condition) {
 			var v = InputVector ();
 			v.buffer = transport_buffer;
@@ -753,7 +900,8 @@ namespace Frida {
 					/* Label: "session" */ 0x73, 0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e
 				};
 				try {
-					_send (sctp_socket, stream_id, WEBRTC_DCEP, open_message);
+					_send (sctp_socket, stream_id, WEBRTC_DCEP, open_message, NONE);
+					_set_stream_priority (sctp_socket, stream_id, SESSION_PRIORITY);
 					state = OPENING;
 				} catch (IOError e) {
 				}
@@ -764,26 +912,43 @@ namespace Frida {
 			out PayloadProtocolId protocol_id, out SctpMessageFlags message_flags) throws IOError;
 
 		protected extern static ssize_t _send (void * sock, uint16 stream_id, PayloadProtocolId protocol_id,
-			uint8[] data) throws IOError;
+			uint8[] data, SctpSendFlags flags) throws IOError;
+
+		protected extern static void _set_stream_priority (void * sock, uint16 stream_id, uint16 priority);
 
 		private void handle_dcep_message (uint16 stream_id, uint8[] message) throws IOError {
 			DcepMessageType type = (DcepMessageType) message[0];
 
 			switch (type) {
 				case DATA_CHANNEL_OPEN: {
+					if (state == OPEN && stream_id != this.stream_id) {
+						handle_channel_open (stream_id, message);
+						return;
+					}
+
 					if (state != CREATED || setup == ACTIVE)
 						return;
 
 					this.stream_id = stream_id;
 
 					uint8[] reply = { DcepMessageType.DATA_CHANNEL_ACK };
-					_send (sctp_socket, stream_id, WEBRTC_DCEP, reply);
+					_send (sctp_socket, stream_id, WEBRTC_DCEP, reply, NONE);
+					_set_stream_priority (sctp_socket, stream_id, SESSION_PRIORITY);
 
 					state = OPEN;
 
 					break;
 				}
 				case DATA_CHANNEL_ACK:
+					if (state == OPEN) {
+						SctpChannel? channel;
+						lock (channels)
+							channel = channels[stream_id];
+						if (channel != null)
+							channel.acknowledged = true;
+						return;
+					}
+
 					if (state != OPENING)
 						return;
 
@@ -822,6 +987,107 @@ namespace Frida {
 		DATA_CHANNEL_ACK = 0x02
 	}
 
+	protected enum DcepChannelType {
+		RELIABLE = 0x00,
+		PARTIAL_RELIABLE_REXMIT = 0x01,
+		RELIABLE_UNORDERED = 0x80,
+		PARTIAL_RELIABLE_REXMIT_UNORDERED = 0x81,
+	}
+
+	[Flags]
+	protected enum SctpSendFlags {
+		NONE = 0,
+		UNORDERED,
+		NO_RETRANSMIT,
+	}
+
+	public sealed class SctpChannel : Object {
+		public signal void message (Bytes data);
+
+		public string label {
+			get;
+			construct;
+		}
+
+		public uint16 stream_id {
+			get;
+			construct;
+		}
+
+		public uint16 priority {
+			get;
+			construct;
+		}
+
+		public MessageDelivery delivery {
+			get;
+			construct;
+		}
+
+		internal bool acknowledged = false;
+
+		private weak SctpConnection? connection;
+		private ByteArray? partial_message;
+		private bool discarding = false;
+
+		internal SctpChannel (SctpConnection connection, string label, uint16 stream_id, uint16 priority,
+				MessageDelivery delivery) {
+			Object (
+				label: label,
+				stream_id: stream_id,
+				priority: priority,
+				delivery: delivery
+			);
+
+			this.connection = connection;
+		}
+
+		/*
+		 * Returns false if a lossy channel had to drop the message due to back-pressure. Reliable channels throw
+		 * IOError.WOULD_BLOCK instead, leaving it to the caller to retry.
+		 */
+		public bool send (uint8[] data) throws IOError {
+			SctpConnection? c = connection;
+			if (c == null)
+				throw new IOError.CLOSED ("Channel is closed");
+			return c.send_on_channel (this, data);
+		}
+
+		public void close () {
+			SctpConnection? c = connection;
+			if (c == null)
+				return;
+			connection = null;
+			c.close_channel (this);
+		}
+
+		internal Bytes? assemble (uint8[] data, bool end_of_record, size_t max_size) {
+			if (partial_message == null && end_of_record && !discarding)
+				return new Bytes (data);
+
+			if (!discarding) {
+				if (partial_message == null)
+					partial_message = new ByteArray ();
+				if (partial_message.len + data.length <= max_size) {
+					partial_message.append (data);
+				} else {
+					partial_message = null;
+					discarding = true;
+				}
+			}
+
+			if (!end_of_record)
+				return null;
+
+			if (discarding) {
+				discarding = false;
+				return null;
+			}
+
+			return ByteArray.free_to_bytes ((owned) partial_message);
+		}
+	}
+
 	private class SctpTimerSource : Source {
 		private static int64 last_process_time = -1;
 
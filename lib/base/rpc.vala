@@ -5,29 +5,32 @@ namespace Frida {
 			construct;
 		}
 
-		private Gee.HashMap<string, PendingResponse> pending_responses = new Gee.HashMap<string, PendingResponse> ();
+		private Gee.HashMap<uint, PendingResponse> pending_responses = new Gee.HashMap<uint, PendingResponse> ();
+		private uint next_request_id = 1;
+
+		private const string SEND_PREFIX = "{\"type\":\"send\",\"payload\":";
+		private const string RPC_SEND_PREFIX = "{\"type\":\"send\",\"payload\":[\"frida:rpc\",";
 
 		public RpcClient (RpcPeer peer) {
 			Object (peer: peer);
 		}
 
 		public async Json.Node call (string method, Json.Node[] args, Bytes? data, Cancellable? cancellable) throws Error, IOError {
-			string request_id = Uuid.string_random ();
-
-			var request = new Json.Builder ();
-			request
-				.begin_array ()
-				.add_string_value ("frida:rpc")
-				.add_string_value (request_id)
-				.add_string_value ("call")
-				.add_string_value (method)
-				.begin_array ();
-			foreach (var arg in args)
-				request.add_value (arg);
-			request
-				.end_array ()
-				.end_array ();
-			string raw_request = Json.to_string (request.get_root (), false);
+			uint request_id = next_request_id++;
+			if (next_request_id == 0)
+				next_request_id = 1;
+
+			var method_node = new Json.Node.alloc ().init_string (method);
+
+			var request = new StringBuilder.sized (64);
+			request.append_printf ("[\"frida:rpc\",%u,\"call\",%s,[", request_id, Json.to_string (method_node, false));
+			for (int i = 0; i != args.length; i++) {
+				if (i != 0)
+					request.append_c (',');
+				request.append (Json.to_string (args[i], false));
+			}
+			request.append ("]]");
+			string raw_request = request.str;
 
 			bool waiting = false;
 
@@ -70,8 +73,24 @@ namespace Frida {
 		}
 
 		public bool try_handle_message (string json) {
-			if (json.index_of ("\"frida:rpc\"") == -1)
+			if (json.has_prefix (SEND_PREFIX)) {
+				/*
+				 * Messages from the script runtime are serialized with "type" first and without whitespace, so
+				 * anything else can be rejected without scanning its payload, and replies to requests that
+				 * aren't ours without parsing them.
+				 */
+				if (!json.has_prefix (RPC_SEND_PREFIX))
+					return false;
+				uint64 request_id;
+				unowned string id_start = (string) ((char *) json + RPC_SEND_PREFIX.length);
+				int id_length = id_start.index_of_char (',');
+				if (id_length <= 0 || !uint64.try_parse (id_start.substring (0, id_length), out request_id))
+					return false;
+				if (request_id > uint.MAX || !pending_responses.has_key ((uint) request_id))
+					return false;
+			} else if (json.index_of ("\"frida:rpc\"") == -1) {
 				return false;
+			}
 
 			var parser = new Json.Parser ();
 			try {
@@ -103,9 +122,12 @@ namespace Frida {
 				return false;
 
 			var request_id_value = rpc_message.get_element (1);
-			if (request_id_value.get_value_type () != typeof (string))
+			if (request_id_value.get_value_type () != typeof (int64))
+				return false;
+			int64 raw_request_id = request_id_value.get_int ();
+			if (raw_request_id <= 0 || raw_request_id > uint.MAX)
 				return false;
-			string request_id = request_id_value.get_string ();
+			uint request_id = (uint) raw_request_id;
 
 			PendingResponse response;
 			if (!pending_responses.unset (request_id, out response))
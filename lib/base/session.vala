@@ -127,6 +127,14 @@ namespace Frida {
 			Cancellable? cancellable) throws GLib.Error;
 	}
 
+#if LINUX
+	[DBus (name = "re.frida.MessageRingProvider17")]
+	public interface MessageRingProvider : Object {
+		public abstract async void open_message_ring (AgentSessionId id, GLib.UnixInputStream memfd,
+			GLib.UnixInputStream data_event, GLib.UnixInputStream space_event, Cancellable? cancellable) throws GLib.Error;
+	}
+#endif
+
 	public struct AgentMessage {
 		public AgentMessageKind kind;
 
@@ -148,13 +156,190 @@ namespace Frida {
 
 	public enum AgentMessageKind {
 		SCRIPT = 1,
-		DEBUGGER
+		DEBUGGER,
+		COMPRESSED_BATCH
+	}
+
+	namespace AgentMessageBatch {
+		public const size_t MIN_COMPRESSIBLE_SIZE = 4096;
+		public const size_t MAX_DECOMPRESSED_SIZE = 128 * 1024 * 1024;
+
+		private const string SIGNATURE = "a(iusbay)";
+
+		public AgentMessage[]? try_compress (AgentMessage[] messages, size_t size_in_bytes, MessageCompression compression) {
+			if (compression == NONE || size_in_bytes < MIN_COMPRESSIBLE_SIZE)
+				return null;
+
+			var builder = new VariantBuilder (new VariantType (SIGNATURE));
+			var byte_array_type = new VariantType ("ay");
+			for (int i = 0; i != messages.length; i++) {
+				AgentMessage * m = &messages[i];
+				var data = new Variant.from_bytes (byte_array_type, new Bytes.static (m->data), true);
+				builder.add ("(iusb@ay)", m->kind, m->script_id.handle, m->text, m->has_data, data);
+			}
+			Bytes raw = builder.end ().get_data_as_bytes ();
+
+			Bytes compressed;
+			try {
+				compressed = convert (new ZlibCompressor (RAW, -1), raw);
+			} catch (Error e) {
+				return null;
+			}
+			if (compressed.get_size () >= raw.get_size ())
+				return null;
+
+			return { AgentMessage (COMPRESSED_BATCH, AgentScriptId (0), compression.to_nick (), true, compressed.get_data ()) };
+		}
+
+		public void decompress (AgentMessage message, AgentMessageFunc func) throws Error {
+			var compression = MessageCompression.from_nick (message.text);
+			if (compression != ZLIB)
+				throw new Error.PROTOCOL ("Unsupported message compression");
+
+			Bytes raw = inflate (new Bytes.static (message.data));
+			var batch = new Variant.from_bytes (new VariantType (SIGNATURE), raw, false);
+
+			var iter = batch.iterator ();
+			Variant? item;
+			while ((item = iter.next_value ()) != null) {
+				int32 kind;
+				uint32 script_id;
+				string text;
+				bool has_data;
+				Variant data;
+				item.get ("(iusb@ay)", out kind, out script_id, out text, out has_data, out data);
+
+				func ((AgentMessageKind) kind, AgentScriptId (script_id), text, has_data ? data.get_data_as_bytes () : null);
+			}
+		}
+
+		private Bytes convert (Converter converter, Bytes input) throws Error {
+			var sink = new MemoryOutputStream.resizable ();
+			var stream = new ConverterOutputStream (sink, converter);
+			try {
+				size_t bytes_written;
+				stream.write_all (input.get_data (), out bytes_written);
+				stream.close ();
+			} catch (GLib.Error e) {
+				throw new Error.PROTOCOL ("Unable to process message batch: %s", e.message);
+			}
+			return sink.steal_as_bytes ();
+		}
+
+		private Bytes inflate (Bytes input) throws Error {
+			var decompressor = new ZlibDecompressor (RAW);
+			var output = new ByteArray ();
+			var buffer = new uint8[64 * 1024];
+			unowned uint8[] remaining = input.get_data ();
+
+			ConverterResult result;
+			do {
+				size_t bytes_read, bytes_written;
+				try {
+					result = decompressor.convert (remaining, buffer, INPUT_AT_END, out bytes_read, out bytes_written);
+				} catch (GLib.Error e) {
+					throw new Error.PROTOCOL ("Unable to process message batch: %s", e.message);
+				}
+
+				if (output.len + bytes_written > MAX_DECOMPRESSED_SIZE)
+					throw new Error.PROTOCOL ("Message batch too large");
+				output.append (buffer[0:bytes_written]);
+				remaining = remaining[bytes_read:remaining.length];
+			} while (result != FINISHED);
+
+			return ByteArray.free_to_bytes ((owned) output);
+		}
 	}
 
+	namespace AgentMessageChannel {
+		private const string SIGNATURE = "(iusb@ay)";
+
+		private const uint8 FRAME_FINAL = 0;
+		private const uint8 FRAME_MORE = 1;
+		private const size_t MAX_MESSAGE_SIZE = 128 * 1024 * 1024;
+
+		/*
+		 * Splits the message into frames no larger than `max_frame_size`. Each frame starts with a flag byte that tells
+		 * whether more frames follow, so reliable channels can carry messages beyond the peer's max-message-size.
+		 */
+		public Bytes[] encode (AgentMessageKind kind, AgentScriptId script_id, string text, Bytes? data,
+				size_t max_frame_size) {
+			var payload = new Variant.from_bytes (new VariantType ("ay"), (data != null) ? data : new Bytes ({}), true);
+			var message = new Variant (SIGNATURE, kind, script_id.handle, text, data != null, payload).get_data_as_bytes ();
+
+			unowned uint8[] raw = message.get_data ();
+			size_t chunk_size = max_frame_size - 1;
+
+			Bytes[] frames = {};
+			size_t offset = 0;
+			do {
+				size_t n = size_t.min (chunk_size, raw.length - offset);
+				var frame = new uint8[1 + n];
+				frame[0] = (offset + n == raw.length) ? FRAME_FINAL : FRAME_MORE;
+				Memory.copy ((uint8 *) frame + 1, (uint8 *) raw + offset, n);
+				frames += new Bytes.take ((owned) frame);
+				offset += n;
+			} while (offset != raw.length);
+
+			return frames;
+		}
+
+		public class Reassembler {
+			private ByteArray? pending;
+
+			public void feed (Bytes frame, AgentMessageFunc func) throws Error {
+				unowned uint8[] raw = frame.get_data ();
+				if (raw.length == 0 || raw[0] > FRAME_MORE) {
+					pending = null;
+					throw new Error.PROTOCOL ("Malformed channel frame");
+				}
+				bool more = raw[0] == FRAME_MORE;
+				unowned uint8[] chunk = raw[1:raw.length];
+
+				if (pending == null && !more) {
+					decode (new Bytes (chunk), func);
+					return;
+				}
+
+				if (pending == null)
+					pending = new ByteArray ();
+				if (pending.len + chunk.length > MAX_MESSAGE_SIZE) {
+					pending = null;
+					throw new Error.PROTOCOL ("Channel message too large");
+				}
+				pending.append (chunk);
+				if (more)
+					return;
+
+				Bytes message = ByteArray.free_to_bytes ((owned) pending);
+				pending = null;
+				decode (message, func);
+			}
+		}
+
+		private void decode (Bytes message, AgentMessageFunc func) throws Error {
+			var item = new Variant.from_bytes (new VariantType (SIGNATURE), message, false);
+			if (!item.is_normal_form ())
+				throw new Error.PROTOCOL ("Malformed channel message");
+
+			int32 kind;
+			uint32 script_id;
+			string text;
+			bool has_data;
+			Variant data;
+			item.get (SIGNATURE, out kind, out script_id, out text, out has_data, out data);
+
+			func ((AgentMessageKind) kind, AgentScriptId (script_id), text, has_data ? data.get_data_as_bytes () : null);
+		}
+	}
+
+	public delegate void AgentMessageFunc (AgentMessageKind kind, AgentScriptId script_id, string text, Bytes? data);
+
 	public sealed class AgentMessageTransmitter : Object {
 		public signal void closed ();
 		public signal void new_candidates (string[] candidate_sdps);
 		public signal void candidate_gathering_done ();
+		public signal void queue_pressure_changed ();
 
 		public weak AgentSession agent_session {
 			get;
@@ -171,6 +356,66 @@ namespace Frida {
 			set;
 		}
 
+		public uint batch_size {
+			get;
+			set;
+			default = 0;
+		}
+
+		public uint flush_latency {
+			get;
+			set;
+			default = 0;
+		}
+
+		public MessageCompression compression {
+			get;
+			set;
+			default = NONE;
+		}
+
+		public size_t window_bytes {
+			get;
+			set;
+			default = 0;
+		}
+
+		public uint window_messages {
+			get;
+			set;
+			default = 0;
+		}
+
+		public size_t queue_limit {
+			get;
+			set;
+			default = 0;
+		}
+
+		public MessageOverflowPolicy overflow_policy {
+			get;
+			set;
+			default = DROP_OLDEST;
+		}
+
+		public bool under_pressure {
+			get { return _under_pressure; }
+		}
+
+		public size_t queued_bytes {
+			get { return _queued_bytes; }
+		}
+
+		public uint dropped_messages {
+			get {
+#if HAVE_NICE
+				return _dropped_messages + AtomicUint.get (ref nice_dropped_messages);
+#else
+				return _dropped_messages;
+#endif
+			}
+		}
+
 		public MainContext frida_context {
 			get;
 			construct;
@@ -188,11 +433,29 @@ namespace Frida {
 		private TimeoutSource? expiry_timer;
 
 		private uint last_rx_batch_id = 0;
-		private Gee.LinkedList<PendingMessage> pending_messages = new Gee.LinkedList<PendingMessage> ();
+		private Gee.ArrayQueue<PendingMessage> pending_messages = new Gee.ArrayQueue<PendingMessage> ();
+		private Gee.ArrayQueue<PendingMessage> spare_messages = new Gee.ArrayQueue<PendingMessage> ();
+		private Gee.ArrayQueue<MessageBatch> spare_batches = new Gee.ArrayQueue<MessageBatch> ();
+		private TimeoutSource? flush_timer;
 		private int next_serial = 1;
 		private uint pending_deliveries = 0;
+		private size_t in_flight_bytes = 0;
+		private uint in_flight_messages = 0;
+		private size_t _queued_bytes = 0;
+		private uint _dropped_messages = 0;
+		private bool _under_pressure = false;
+		private uint overflow_count = 0;
 		private Cancellable delivery_cancellable = new Cancellable ();
 
+		private const size_t MAX_BATCH_SIZE_IN_BYTES = 4 * 1024 * 1024;
+		private const uint OVERFLOW_SAMPLE_INTERVAL = 16;
+		private const uint MAX_SPARE_MESSAGES = 4096;
+		private const uint MAX_SPARE_BATCHES = 4;
+		private const uint MAX_SPARE_BATCH_CAPACITY = 16384;
+
+		private Gee.Map<AgentScriptId?, ScriptRoute> script_routes =
+			new Gee.HashMap<AgentScriptId?, ScriptRoute> (AgentScriptId.hash, AgentScriptId.equal);
+
 #if HAVE_NICE
 		private Nice.Agent? nice_agent;
 		private uint nice_stream_id;
@@ -200,6 +463,11 @@ namespace Frida {
 		private SctpConnection? nice_iostream;
 		private DBusConnection? nice_connection;
 		private uint nice_registration_id;
+		private Gee.Map<AgentScriptId?, ScriptChannel> nice_channels =
+			new Gee.HashMap<AgentScriptId?, ScriptChannel> (AgentScriptId.hash, AgentScriptId.equal);
+		private size_t nice_backlog_bytes = 0;
+		private uint nice_overflow_count = 0;
+		private uint nice_dropped_messages = 0;
 #endif
 		private AgentMessageSink? nice_message_sink;
 		private Cancellable nice_cancellable = new Cancellable ();
@@ -224,6 +492,42 @@ namespace Frida {
 			assert (dbus_context != null);
 		}
 
+		public void configure (SessionOptions options) {
+			batch_size = options.message_batch_size;
+			flush_latency = options.message_flush_latency;
+			compression = options.message_compression;
+			window_bytes = options.message_window_bytes;
+			window_messages = options.message_window_messages;
+			queue_limit = options.message_queue_limit;
+			overflow_policy = options.message_overflow_policy;
+		}
+
+		public void configure_script (AgentScriptId script_id, ScriptOptions options) {
+			if (options.message_delivery == RELIABLE && options.message_priority == NORMAL)
+				return;
+
+			script_routes[script_id] = new ScriptRoute (options.message_delivery, options.message_priority);
+		}
+
+		public void forget_script (AgentScriptId script_id) {
+			if (!script_routes.unset (script_id))
+				return;
+
+#if HAVE_NICE
+			AgentScriptId id = script_id;
+			schedule_on_dbus_thread (() => {
+				ScriptChannel? sc;
+				lock (nice_channels)
+					nice_channels.unset (id, out sc);
+				if (sc != null) {
+					nice_backlog_bytes -= sc.backlog_bytes;
+					sc.channel.close ();
+				}
+				return false;
+			});
+#endif
+		}
+
 		public async void close (Cancellable? cancellable) throws IOError {
 			while (close_request != null) {
 				try {
@@ -236,6 +540,11 @@ namespace Frida {
 			}
 			close_request = new Promise<bool> ();
 
+			if (flush_timer != null) {
+				flush_timer.destroy ();
+				flush_timer = null;
+			}
+
 			nice_cancellable.cancel ();
 
 			delivery_cancellable.cancel ();
@@ -275,7 +584,10 @@ namespace Frida {
 				PendingMessage? m;
 				while ((m = pending_messages.peek ()) != null && m.delivery_attempts > 0 && m.serial <= rx_batch_id) {
 					pending_messages.poll ();
+					_queued_bytes -= m.size;
+					recycle_message (m);
 				}
+				update_queue_pressure ();
 			}
 
 			expiry_timer.destroy ();
@@ -415,7 +727,19 @@ namespace Frida {
 				nice_connection = null;
 			}
 
-			nice_iostream = null;
+			if (nice_iostream != null) {
+				nice_iostream.notify["pending-io"].disconnect (on_nice_pending_io_changed);
+				nice_iostream = null;
+			}
+
+			lock (nice_channels)
+				nice_channels.clear ();
+			nice_backlog_bytes = 0;
+
+			foreach (var route in script_routes.values) {
+				if (route.path == CHANNEL)
+					route.path = DBUS;
+			}
 
 			nice_component_id = 0;
 			nice_stream_id = 0;
@@ -486,6 +810,7 @@ namespace Frida {
 				yield tc.handshake_async (Priority.DEFAULT, nice_cancellable);
 
 				nice_iostream = new SctpConnection (tc, offer.setup, offer.sctp_port, offer.max_message_size);
+				nice_iostream.notify["pending-io"].connect (on_nice_pending_io_changed);
 
 				schedule_on_frida_thread (() => {
 					complete_peer_connection.begin ();
@@ -537,6 +862,175 @@ namespace Frida {
 			}
 		}
 
+		private bool try_post_on_channel (AgentScriptId script_id, string json, Bytes? data) {
+			ScriptRoute? route = script_routes[script_id];
+			if (route == null)
+				return false;
+
+			/*
+			 * A script's messages stay on the path picked for its first message, as the data channel and the
+			 * D-Bus queue are not ordered relative to each other. Reliable routes fragment messages that exceed the
+			 * channel's max-message-size, whereas lossy routes drop them.
+			 */
+			if (route.path == UNDECIDED)
+				route.path = (state == LIVE && nice_message_sink != null) ? ScriptPath.CHANNEL : ScriptPath.DBUS;
+			if (route.path == DBUS)
+				return false;
+
+			SctpConnection connection = nice_iostream;
+			var frames = AgentMessageChannel.encode (SCRIPT, script_id, json, data, connection.max_message_size);
+			if (frames.length > 1 && route.delivery == LOSSY) {
+				_dropped_messages++;
+				return true;
+			}
+
+			var message = new ChannelMessage (json, data, frames);
+			AgentScriptId id = script_id;
+			schedule_on_dbus_thread (() => {
+				send_on_channel (connection, id, route, message);
+				return false;
+			});
+
+			return true;
+		}
+
+		private void send_on_channel (SctpConnection connection, AgentScriptId script_id, ScriptRoute route,
+				ChannelMessage message) {
+			if (route.rerouted) {
+				reroute_to_dbus (script_id, new Gee.ArrayList<ChannelMessage>.wrap ({ message }));
+				return;
+			}
+
+			ScriptChannel? sc;
+			lock (nice_channels)
+				sc = nice_channels[script_id];
+			try {
+				if (sc == null) {
+					var channel = connection.open_channel ("script-%u".printf (script_id.handle), (uint16) route.priority,
+						route.delivery);
+					sc = new ScriptChannel (script_id, route, channel);
+					lock (nice_channels)
+						nice_channels[script_id] = sc;
+				}
+
+				if (!sc.backlog.is_empty || !send_frames (sc, message))
+					add_to_backlog (sc, message);
+			} catch (IOError e) {
+				handle_channel_failure (script_id, route, sc, message);
+			}
+		}
+
+		private bool send_frames (ScriptChannel sc, ChannelMessage message) throws IOError {
+			unowned Bytes[] frames = message.frames;
+			while (message.next_frame != frames.length) {
+				try {
+					if (!sc.channel.send (frames[message.next_frame].get_data ())) {
+						AtomicUint.inc (ref nice_dropped_messages);
+						message.next_frame = frames.length;
+						break;
+					}
+				} catch (IOError e) {
+					if (e is IOError.WOULD_BLOCK)
+						return false;
+					throw e;
+				}
+				message.next_frame++;
+			}
+			return true;
+		}
+
+		private void handle_channel_failure (AgentScriptId script_id, ScriptRoute route, ScriptChannel? sc,
+				ChannelMessage message) {
+			var undelivered = new Gee.ArrayList<ChannelMessage> ();
+			if (sc != null) {
+				lock (nice_channels)
+					nice_channels.unset (script_id);
+				undelivered.add_all (sc.backlog);
+				nice_backlog_bytes -= sc.backlog_bytes;
+				sc.channel.close ();
+			}
+			if (!undelivered.contains (message))
+				undelivered.add (message);
+
+			if (route.delivery == LOSSY) {
+				AtomicUint.add (ref nice_dropped_messages, undelivered.size);
+				return;
+			}
+
+			/*
+			 * Reliable scripts continue on D-Bus. Messages already scheduled for the channel are forwarded from here,
+			 * so they still reach the D-Bus queue in the order they were posted.
+			 */
+			route.rerouted = true;
+			reroute_to_dbus (script_id, undelivered);
+		}
+
+		private void reroute_to_dbus (AgentScriptId script_id, Gee.List<ChannelMessage> messages) {
+			AgentScriptId id = script_id;
+			schedule_on_frida_thread (() => {
+				foreach (var m in messages)
+					enqueue_message (SCRIPT, id, m.text, m.data);
+				return false;
+			});
+		}
+
+		private void add_to_backlog (ScriptChannel sc, ChannelMessage message) {
+			size_t size = message.size;
+
+			if (queue_limit != 0 && nice_backlog_bytes + size > queue_limit) {
+				bool make_room = overflow_policy == DROP_OLDEST ||
+					(overflow_policy == SAMPLE && nice_overflow_count++ % OVERFLOW_SAMPLE_INTERVAL == 0);
+				if (make_room) {
+					ChannelMessage? oldest;
+					while (nice_backlog_bytes + size > queue_limit && (oldest = sc.backlog.peek ()) != null &&
+							oldest.next_frame == 0) {
+						sc.backlog.poll ();
+						sc.backlog_bytes -= oldest.size;
+						nice_backlog_bytes -= oldest.size;
+						AtomicUint.inc (ref nice_dropped_messages);
+					}
+				}
+
+				if (nice_backlog_bytes + size > queue_limit && message.next_frame == 0) {
+					AtomicUint.inc (ref nice_dropped_messages);
+					return;
+				}
+			}
+
+			sc.backlog.offer (message);
+			sc.backlog_bytes += size;
+			nice_backlog_bytes += size;
+		}
+
+		private void on_nice_pending_io_changed (Object object, ParamSpec pspec) {
+			var connection = (SctpConnection) object;
+			if ((connection.pending_io & IOCondition.OUT) == 0)
+				return;
+
+			var channels = new Gee.ArrayList<ScriptChannel> ();
+			lock (nice_channels)
+				channels.add_all (nice_channels.values);
+
+			foreach (var sc in channels) {
+				ChannelMessage? message;
+				while ((message = sc.backlog.peek ()) != null) {
+					try {
+						if (!send_frames (sc, message))
+							return;
+					} catch (IOError e) {
+						handle_channel_failure (sc.script_id, sc.route, sc, message);
+						break;
+					}
+					sc.backlog.poll ();
+					sc.backlog_bytes -= message.size;
+					nice_backlog_bytes -= message.size;
+				}
+			}
+
+			if (nice_backlog_bytes == 0)
+				nice_overflow_count = 0;
+		}
+
 		public void add_candidates (string[] candidate_sdps) throws Error {
 			Nice.Agent? agent = nice_agent;
 			if (agent == null)
@@ -619,16 +1113,96 @@ namespace Frida {
 		}
 
 		public void post_message_from_script (AgentScriptId script_id, string json, Bytes? data) {
-			pending_messages.offer (new PendingMessage (next_serial++, AgentMessageKind.SCRIPT, script_id, json, data));
-			maybe_deliver_pending_messages ();
+#if HAVE_NICE
+			if (try_post_on_channel (script_id, json, data))
+				return;
+#endif
+			enqueue_message (AgentMessageKind.SCRIPT, script_id, json, data);
 		}
 
 		public void post_message_from_debugger (AgentScriptId script_id, string message) {
-			pending_messages.offer (new PendingMessage (next_serial++, AgentMessageKind.DEBUGGER, script_id, message));
-			maybe_deliver_pending_messages ();
+			enqueue_message (AgentMessageKind.DEBUGGER, script_id, message, null);
+		}
+
+		private void enqueue_message (AgentMessageKind kind, AgentScriptId script_id, string text, Bytes? data) {
+			size_t message_size = sizeof (AgentMessage) + text.length + 1 + ((data != null) ? data.length : 0);
+			if (queue_limit != 0 && _queued_bytes + message_size > queue_limit &&
+					(message_size > queue_limit || !make_room_for (message_size))) {
+				_dropped_messages++;
+				update_queue_pressure ();
+				return;
+			}
+
+			PendingMessage? m = spare_messages.poll ();
+			if (m == null)
+				m = new PendingMessage ();
+			m.serial = next_serial++;
+			m.kind = kind;
+			m.script_id = script_id;
+			m.text = text;
+			m.data = data;
+			m.size = message_size;
+			m.delivery_attempts = 0;
+			pending_messages.offer (m);
+			_queued_bytes += message_size;
+
+			bool batch_full = batch_size != 0 && pending_messages.size >= batch_size;
+			if (flush_latency == 0 || batch_full) {
+				maybe_deliver_pending_messages ();
+			} else if (flush_timer == null) {
+				var timer = new TimeoutSource (flush_latency);
+				timer.set_callback (() => {
+					flush_timer = null;
+					maybe_deliver_pending_messages ();
+					return Source.REMOVE;
+				});
+				timer.attach (frida_context);
+				flush_timer = timer;
+			}
+
+			update_queue_pressure ();
+		}
+
+		private bool make_room_for (size_t message_size) {
+			if (overflow_policy == DROP_NEWEST)
+				return false;
+
+			if (overflow_policy == SAMPLE && overflow_count++ % OVERFLOW_SAMPLE_INTERVAL != 0)
+				return false;
+
+			PendingMessage? oldest;
+			while (_queued_bytes + message_size > queue_limit && (oldest = pending_messages.poll ()) != null) {
+				_queued_bytes -= oldest.size;
+				_dropped_messages++;
+				recycle_message (oldest);
+			}
+
+			return true;
+		}
+
+		private void update_queue_pressure () {
+			if (queue_limit == 0)
+				return;
+
+			bool pressure = _under_pressure
+				? _queued_bytes > queue_limit / 4
+				: _queued_bytes >= queue_limit / 2;
+			if (pressure == _under_pressure)
+				return;
+
+			_under_pressure = pressure;
+			if (!pressure)
+				overflow_count = 0;
+
+			queue_pressure_changed ();
 		}
 
 		private void maybe_deliver_pending_messages () {
+			if (flush_timer != null) {
+				flush_timer.destroy ();
+				flush_timer = null;
+			}
+
 			if (state != LIVE)
 				return;
 
@@ -636,82 +1210,161 @@ namespace Frida {
 			if (sink == null)
 				return;
 
-			if (pending_messages.is_empty)
-				return;
+			while (!pending_messages.is_empty && has_credit ()) {
+				MessageBatch batch = take_batch ();
+
+				if (persist_timeout == 0)
+					emit_batch (sink, batch);
+				else
+					deliver_batch.begin (sink, batch);
+			}
+
+			update_queue_pressure ();
+		}
+
+		private bool has_credit () {
+			if (window_bytes != 0 && in_flight_bytes >= window_bytes)
+				return false;
+
+			if (window_messages != 0 && in_flight_messages >= window_messages)
+				return false;
+
+			return true;
+		}
+
+		private MessageBatch take_batch () {
+			MessageBatch? batch = spare_batches.poll ();
+			if (batch == null)
+				batch = new MessageBatch ();
+
+			size_t max_size = MAX_BATCH_SIZE_IN_BYTES;
+			if (window_bytes != 0)
+				max_size = size_t.min (max_size, window_bytes - in_flight_bytes);
+
+			uint max_messages = batch_size;
+			if (window_messages != 0) {
+				uint available = window_messages - in_flight_messages;
+				max_messages = (max_messages != 0) ? uint.min (max_messages, available) : available;
+			}
 
-			var batch = new Gee.ArrayList<PendingMessage> ();
-			void * items = null;
-			int n_items = 0;
-			size_t total_size = 0;
-			size_t max_size = 4 * 1024 * 1024;
 			PendingMessage? m;
 			while ((m = pending_messages.peek ()) != null) {
-				size_t message_size = m.estimate_size_in_bytes ();
-				if (total_size + message_size > max_size && !batch.is_empty)
+				if (max_messages != 0 && batch.length == max_messages)
+					break;
+
+				if (batch.size_in_bytes + m.size > max_size && batch.length != 0)
 					break;
 				pending_messages.poll ();
+				_queued_bytes -= m.size;
+
 				batch.add (m);
+			}
 
-				n_items++;
-				items = realloc (items, n_items * sizeof (AgentMessage));
+			return batch;
+		}
 
-				AgentMessage * am = (AgentMessage *) items + n_items - 1;
+		private void emit_batch (AgentMessageSink sink, MessageBatch batch) {
+			size_t size = batch.size_in_bytes;
+			uint n = batch.length;
 
-				am->kind = m.kind;
-				am->script_id = m.script_id;
+			in_flight_bytes += size;
+			in_flight_messages += n;
 
-				*((void **) &am->text) = m.text;
+			AsyncReadyCallback on_complete = (obj, res) => {
+				try {
+					sink.post_messages.end (res);
+				} catch (GLib.Error e) {
+				}
 
-				unowned Bytes? data = m.data;
-				am->has_data = data != null;
-				*((void **) &am->data) = am->has_data ? data.get_data () : null;
-				am->data.length = am->has_data ? data.length : 0;
+				in_flight_bytes -= size;
+				in_flight_messages -= n;
 
-				total_size += message_size;
-			}
+				if (flush_timer == null)
+					maybe_deliver_pending_messages ();
+			};
 
-			if (persist_timeout == 0)
-				emit_batch (sink, batch, items);
+			AgentMessage[]? compressed = AgentMessageBatch.try_compress (batch.get_items (), batch.size_in_bytes, compression);
+			if (compressed != null)
+				sink.post_messages.begin (compressed, 0, delivery_cancellable, on_complete);
 			else
-				deliver_batch.begin (sink, batch, items);
-		}
-
-		private void emit_batch (AgentMessageSink sink, Gee.ArrayList<PendingMessage> messages, void * items) {
-			unowned AgentMessage[] items_arr = (AgentMessage[]) items;
-			items_arr.length = messages.size;
-
-			sink.post_messages.begin (items_arr, 0, delivery_cancellable);
+				sink.post_messages.begin (batch.get_items (), 0, delivery_cancellable, on_complete);
 
-			free (items);
+			for (int i = 0; i != batch.length; i++)
+				recycle_message (batch.messages[i]);
+			recycle_batch (batch);
 		}
 
-		private async void deliver_batch (AgentMessageSink sink, Gee.ArrayList<PendingMessage> messages, void * items) {
+		private async void deliver_batch (AgentMessageSink sink, MessageBatch batch) {
 			bool success = false;
+			size_t size = batch.size_in_bytes;
+			uint n = batch.length;
+
 			pending_deliveries++;
+			in_flight_bytes += size;
+			in_flight_messages += n;
 			try {
-				int n = messages.size;
-
-				foreach (var message in messages)
-					message.delivery_attempts++;
+				for (int i = 0; i != n; i++)
+					batch.messages[i].delivery_attempts++;
 
-				unowned AgentMessage[] items_arr = (AgentMessage[]) items;
-				items_arr.length = n;
+				uint batch_id = batch.messages[n - 1].serial;
 
-				uint batch_id = messages[n - 1].serial;
+				AgentMessage[]? compressed = AgentMessageBatch.try_compress (batch.get_items (), batch.size_in_bytes,
+					compression);
+				if (compressed != null)
+					yield sink.post_messages (compressed, batch_id, delivery_cancellable);
+				else
+					yield sink.post_messages (batch.get_items (), batch_id, delivery_cancellable);
 
-				yield sink.post_messages (items_arr, batch_id, delivery_cancellable);
+				for (int i = 0; i != n; i++)
+					recycle_message (batch.messages[i]);
 
 				success = true;
 			} catch (GLib.Error e) {
-				pending_messages.add_all (messages);
-				pending_messages.sort ((a, b) => a.serial - b.serial);
+				requeue_batch (batch);
 			} finally {
 				pending_deliveries--;
 				if (pending_deliveries == 0 && success)
 					next_serial = 1;
 
-				free (items);
+				in_flight_bytes -= size;
+				in_flight_messages -= n;
+
+				recycle_batch (batch);
+			}
+
+			if (success)
+				maybe_deliver_pending_messages ();
+		}
+
+		private void requeue_batch (MessageBatch batch) {
+			var messages = new Gee.ArrayList<PendingMessage> ();
+			messages.add_all (pending_messages);
+			for (int i = 0; i != batch.length; i++) {
+				PendingMessage m = batch.messages[i];
+				messages.add (m);
+				_queued_bytes += m.size;
 			}
+			messages.sort ((a, b) => a.serial - b.serial);
+
+			pending_messages.clear ();
+			pending_messages.add_all (messages);
+
+			update_queue_pressure ();
+		}
+
+		private void recycle_message (PendingMessage m) {
+			m.text = null;
+			m.data = null;
+
+			if (spare_messages.size < MAX_SPARE_MESSAGES)
+				spare_messages.offer (m);
+		}
+
+		private void recycle_batch (MessageBatch batch) {
+			batch.reset ();
+
+			if (spare_batches.size < MAX_SPARE_BATCHES && batch.capacity <= MAX_SPARE_BATCH_CAPACITY)
+				spare_batches.offer (batch);
 		}
 
 		protected void schedule_on_frida_thread (owned SourceFunc function) {
@@ -726,25 +1379,119 @@ namespace Frida {
 			source.attach (dbus_context);
 		}
 
+		private class ScriptRoute {
+			public MessageDelivery delivery;
+			public MessagePriority priority;
+			public ScriptPath path = UNDECIDED;
+			public bool rerouted = false;
+
+			public ScriptRoute (MessageDelivery delivery, MessagePriority priority) {
+				this.delivery = delivery;
+				this.priority = priority;
+			}
+		}
+
+		private enum ScriptPath {
+			UNDECIDED,
+			CHANNEL,
+			DBUS
+		}
+
+#if HAVE_NICE
+		private class ScriptChannel {
+			public AgentScriptId script_id;
+			public ScriptRoute route;
+			public SctpChannel channel;
+			public Gee.Queue<ChannelMessage> backlog = new Gee.ArrayQueue<ChannelMessage> ();
+			public size_t backlog_bytes = 0;
+
+			public ScriptChannel (AgentScriptId script_id, ScriptRoute route, SctpChannel channel) {
+				this.script_id = script_id;
+				this.route = route;
+				this.channel = channel;
+			}
+		}
+
+		private class ChannelMessage {
+			public string text;
+			public Bytes? data;
+			public Bytes[] frames;
+			public uint next_frame = 0;
+			public size_t size = 0;
+
+			public ChannelMessage (string text, Bytes? data, Bytes[] frames) {
+				this.text = text;
+				this.data = data;
+				this.frames = frames;
+				foreach (var frame in frames)
+					size += frame.get_size ();
+			}
+		}
+#endif
+
 		private class PendingMessage {
 			public int serial;
 			public AgentMessageKind kind;
 			public AgentScriptId script_id;
-			public string text;
+			public string? text;
 			public Bytes? data;
+			public size_t size;
 			public uint delivery_attempts;
+		}
 
-			public PendingMessage (int serial, AgentMessageKind kind, AgentScriptId script_id, string text,
-					Bytes? data = null) {
-				this.serial = serial;
-				this.kind = kind;
-				this.script_id = script_id;
-				this.text = text;
-				this.data = data;
+		private class MessageBatch {
+			public PendingMessage[] messages;
+			public int length = 0;
+			public int capacity = 16;
+			public size_t size_in_bytes = 0;
+
+			private AgentMessage * items;
+
+			public MessageBatch () {
+				messages = new PendingMessage[capacity];
+				items = malloc (capacity * sizeof (AgentMessage));
 			}
 
-			public size_t estimate_size_in_bytes () {
-				return sizeof (AgentMessage) + text.length + 1 + ((data != null) ? data.length : 0);
+			~MessageBatch () {
+				free (items);
+			}
+
+			public void add (PendingMessage m) {
+				if (length == capacity) {
+					capacity *= 2;
+					messages.resize (capacity);
+					items = realloc (items, capacity * sizeof (AgentMessage));
+				}
+
+				messages[length] = m;
+
+				AgentMessage * am = items + length;
+
+				am->kind = m.kind;
+				am->script_id = m.script_id;
+
+				*((void **) &am->text) = m.text;
+
+				unowned Bytes? data = m.data;
+				am->has_data = data != null;
+				*((void **) &am->data) = am->has_data ? data.get_data () : null;
+				am->data.length = am->has_data ? data.length : 0;
+
+				length++;
+				size_in_bytes += m.size;
+			}
+
+			public unowned AgentMessage[] get_items () {
+				unowned AgentMessage[] items_arr = (AgentMessage[]) items;
+				items_arr.length = length;
+				return items_arr;
+			}
+
+			public void reset () {
+				for (int i = 0; i != length; i++)
+					messages[i] = null;
+				length = 0;
+				size_in_bytes = 0;
 			}
 		}
 	}
@@ -957,6 +1704,61 @@ namespace Frida {
 		}
 	}
 
+	public enum MessageOverflowPolicy {
+		DROP_OLDEST,
+		DROP_NEWEST,
+		SAMPLE;
+
+		public static MessageOverflowPolicy from_nick (string nick) throws Error {
+			return Marshal.enum_from_nick<MessageOverflowPolicy> (nick);
+		}
+
+		public string to_nick () {
+			return Marshal.enum_to_nick<MessageOverflowPolicy> (this);
+		}
+	}
+
+	public enum MessageCompression {
+		NONE,
+		ZLIB;
+
+		public static MessageCompression from_nick (string nick) throws Error {
+			return Marshal.enum_from_nick<MessageCompression> (nick);
+		}
+
+		public string to_nick () {
+			return Marshal.enum_to_nick<MessageCompression> (this);
+		}
+	}
+
+	public enum MessageDelivery {
+		RELIABLE,
+		LOSSY;
+
+		public static MessageDelivery from_nick (string nick) throws Error {
+			return Marshal.enum_from_nick<MessageDelivery> (nick);
+		}
+
+		public string to_nick () {
+			return Marshal.enum_to_nick<MessageDelivery> (this);
+		}
+	}
+
+	public enum MessagePriority {
+		BELOW_NORMAL = 128,
+		NORMAL = 256,
+		HIGH = 512,
+		EXTRA_HIGH = 1024;
+
+		public static MessagePriority from_nick (string nick) throws Error {
+			return Marshal.enum_from_nick<MessagePriority> (nick);
+		}
+
+		public string to_nick () {
+			return Marshal.enum_to_nick<MessagePriority> (this);
+		}
+	}
+
 	public enum SpawnStartState {
 		RUNNING,
 		SUSPENDED;
@@ -1222,6 +2024,13 @@ namespace Frida {
 			default = MINIMAL;
 		}
 
+		// Diff against the previous query made with the same snapshot name; vanished processes are flagged as such.
+		// Names are private to each client, and only the Linux backend supports this.
+		public string? snapshot {
+			get;
+			set;
+		}
+
 		private Gee.List<uint> pids = new Gee.ArrayList<uint> ();
 
 		public void select_pid (uint pid) {
@@ -1246,6 +2055,9 @@ namespace Frida {
 			if (scope != MINIMAL)
 				dict["scope"] = new Variant.string (scope.to_nick ());
 
+			if (snapshot != null)
+				dict["snapshot"] = new Variant.string (snapshot);
+
 			return dict;
 		}
 
@@ -1269,6 +2081,13 @@ namespace Frida {
 				options.scope = Scope.from_nick (scope.get_string ());
 			}
 
+			Variant? snapshot = dict["snapshot"];
+			if (snapshot != null) {
+				if (!snapshot.is_of_type (VariantType.STRING))
+					throw new Error.INVALID_ARGUMENT ("The 'snapshot' option must be a string");
+				options.snapshot = snapshot.get_string ();
+			}
+
 			return options;
 		}
 	}
@@ -1370,6 +2189,48 @@ namespace Frida {
 			default = 0;
 		}
 
+		public uint message_batch_size {
+			get;
+			set;
+			default = 0;
+		}
+
+		public uint message_flush_latency {
+			get;
+			set;
+			default = 0;
+		}
+
+		public MessageCompression message_compression {
+			get;
+			set;
+			default = NONE;
+		}
+
+		public uint message_window_bytes {
+			get;
+			set;
+			default = 0;
+		}
+
+		public uint message_window_messages {
+			get;
+			set;
+			default = 0;
+		}
+
+		public uint message_queue_limit {
+			get;
+			set;
+			default = 0;
+		}
+
+		public MessageOverflowPolicy message_overflow_policy {
+			get;
+			set;
+			default = DROP_OLDEST;
+		}
+
 		public string? emulated_agent_path {
 			get;
 			set;
@@ -1384,6 +2245,27 @@ namespace Frida {
 			if (persist_timeout != 0)
 				dict["persist-timeout"] = new Variant.uint32 (persist_timeout);
 
+			if (message_batch_size != 0)
+				dict["message-batch-size"] = new Variant.uint32 (message_batch_size);
+
+			if (message_flush_latency != 0)
+				dict["message-flush-latency"] = new Variant.uint32 (message_flush_latency);
+
+			if (message_compression != NONE)
+				dict["message-compression"] = new Variant.string (message_compression.to_nick ());
+
+			if (message_window_bytes != 0)
+				dict["message-window-bytes"] = new Variant.uint32 (message_window_bytes);
+
+			if (message_window_messages != 0)
+				dict["message-window-messages"] = new Variant.uint32 (message_window_messages);
+
+			if (message_queue_limit != 0)
+				dict["message-queue-limit"] = new Variant.uint32 (message_queue_limit);
+
+			if (message_overflow_policy != DROP_OLDEST)
+				dict["message-overflow-policy"] = new Variant.string (message_overflow_policy.to_nick ());
+
 			if (emulated_agent_path != null)
 				dict["emulated-agent-path"] = new Variant.string (emulated_agent_path);
 
@@ -1407,6 +2289,55 @@ namespace Frida {
 				options.persist_timeout = persist_timeout.get_uint32 ();
 			}
 
+			Variant? message_batch_size = dict["message-batch-size"];
+			if (message_batch_size != null) {
+				if (!message_batch_size.is_of_type (VariantType.UINT32))
+					throw new Error.INVALID_ARGUMENT ("The 'message-batch-size' option must be a uint32");
+				options.message_batch_size = message_batch_size.get_uint32 ();
+			}
+
+			Variant? message_flush_latency = dict["message-flush-latency"];
+			if (message_flush_latency != null) {
+				if (!message_flush_latency.is_of_type (VariantType.UINT32))
+					throw new Error.INVALID_ARGUMENT ("The 'message-flush-latency' option must be a uint32");
+				options.message_flush_latency = message_flush_latency.get_uint32 ();
+			}
+
+			Variant? message_compression = dict["message-compression"];
+			if (message_compression != null) {
+				if (!message_compression.is_of_type (VariantType.STRING))
+					throw new Error.INVALID_ARGUMENT ("The 'message-compression' option must be a string");
+				options.message_compression = MessageCompression.from_nick (message_compression.get_string ());
+			}
+
+			Variant? message_window_bytes = dict["message-window-bytes"];
+			if (message_window_bytes != null) {
+				if (!message_window_bytes.is_of_type (VariantType.UINT32))
+					throw new Error.INVALID_ARGUMENT ("The 'message-window-bytes' option must be a uint32");
+				options.message_window_bytes = message_window_bytes.get_uint32 ();
+			}
+
+			Variant? message_window_messages = dict["message-window-messages"];
+			if (message_window_messages != null) {
+				if (!message_window_messages.is_of_type (VariantType.UINT32))
+					throw new Error.INVALID_ARGUMENT ("The 'message-window-messages' option must be a uint32");
+				options.message_window_messages = message_window_messages.get_uint32 ();
+			}
+
+			Variant? message_queue_limit = dict["message-queue-limit"];
+			if (message_queue_limit != null) {
+				if (!message_queue_limit.is_of_type (VariantType.UINT32))
+					throw new Error.INVALID_ARGUMENT ("The 'message-queue-limit' option must be a uint32");
+				options.message_queue_limit = message_queue_limit.get_uint32 ();
+			}
+
+			Variant? message_overflow_policy = dict["message-overflow-policy"];
+			if (message_overflow_policy != null) {
+				if (!message_overflow_policy.is_of_type (VariantType.STRING))
+					throw new Error.INVALID_ARGUMENT ("The 'message-overflow-policy' option must be a string");
+				options.message_overflow_policy = MessageOverflowPolicy.from_nick (message_overflow_policy.get_string ());
+			}
+
 			Variant? path = dict["emulated-agent-path"];
 			if (path != null) {
 				if (!path.is_of_type (VariantType.STRING))
@@ -1625,6 +2556,24 @@ namespace Frida {
 			default = DEFAULT;
 		}
 
+		public MessageDelivery message_delivery {
+			get;
+			set;
+			default = RELIABLE;
+		}
+
+		public MessagePriority message_priority {
+			get;
+			set;
+			default = NORMAL;
+		}
+
+		public bool notify_queue_pressure {
+			get;
+			set;
+			default = false;
+		}
+
 		public HashTable<string, Variant> _serialize () {
 			var dict = make_parameters_dict ();
 
@@ -1643,6 +2592,15 @@ namespace Frida {
 			if (runtime != DEFAULT)
 				dict["runtime"] = new Variant.string (runtime.to_nick ());
 
+			if (message_delivery != RELIABLE)
+				dict["message-delivery"] = new Variant.string (message_delivery.to_nick ());
+
+			if (message_priority != NORMAL)
+				dict["message-priority"] = new Variant.string (message_priority.to_nick ());
+
+			if (notify_queue_pressure)
+				dict["notify-queue-pressure"] = new Variant.boolean (true);
+
 			return dict;
 		}
 
@@ -1683,6 +2641,27 @@ namespace Frida {
 				options.runtime = ScriptRuntime.from_nick (runtime.get_string ());
 			}
 
+			Variant? message_delivery = dict["message-delivery"];
+			if (message_delivery != null) {
+				if (!message_delivery.is_of_type (VariantType.STRING))
+					throw new Error.INVALID_ARGUMENT ("The 'message-delivery' option must be a string");
+				options.message_delivery = MessageDelivery.from_nick (message_delivery.get_string ());
+			}
+
+			Variant? message_priority = dict["message-priority"];
+			if (message_priority != null) {
+				if (!message_priority.is_of_type (VariantType.STRING))
+					throw new Error.INVALID_ARGUMENT ("The 'message-priority' option must be a string");
+				options.message_priority = MessagePriority.from_nick (message_priority.get_string ());
+			}
+
+			Variant? notify_queue_pressure = dict["notify-queue-pressure"];
+			if (notify_queue_pressure != null) {
+				if (!notify_queue_pressure.is_of_type (VariantType.BOOLEAN))
+					throw new Error.INVALID_ARGUMENT ("The 'notify-queue-pressure' option must be a boolean");
+				options.notify_queue_pressure = notify_queue_pressure.get_boolean ();
+			}
+
 			return options;
 		}
 	}
@@ -1783,6 +2762,18 @@ namespace Frida {
 			set;
 		}
 
+		public uint max_frame_size {
+			get;
+			set;
+			default = DEFAULT_WEB_FRAME_SIZE;
+		}
+
+		public WebCompression compression {
+			get;
+			set;
+			default = DEFAULT;
+		}
+
 		public HashTable<string, Variant> _serialize () {
 			var dict = make_parameters_dict ();
 
@@ -1795,6 +2786,12 @@ namespace Frida {
 			if (acl != null)
 				dict["acl"] = new Variant.strv (acl);
 
+			if (max_frame_size != DEFAULT_WEB_FRAME_SIZE)
+				dict["max-frame-size"] = new Variant.uint32 (max_frame_size);
+
+			if (compression != DEFAULT)
+				dict["compression"] = new Variant.string (compression.to_nick ());
+
 			return dict;
 		}
 
@@ -1826,6 +2823,20 @@ namespace Frida {
 				options.acl = acl.get_strv ();
 			}
 
+			Variant? max_frame_size = dict["max-frame-size"];
+			if (max_frame_size != null) {
+				if (!max_frame_size.is_of_type (VariantType.UINT32))
+					throw new Error.INVALID_ARGUMENT ("The 'max-frame-size' option must be a uint32");
+				options.max_frame_size = max_frame_size.get_uint32 ();
+			}
+
+			Variant? compression = dict["compression"];
+			if (compression != null) {
+				if (!compression.is_of_type (VariantType.STRING))
+					throw new Error.INVALID_ARGUMENT ("The 'compression' option must be a string");
+				options.compression = WebCompression.from_nick (compression.get_string ());
+			}
+
 			return options;
 		}
 	}
@@ -2134,6 +3145,7 @@ namespace Frida {
 		public const string AGENT_SESSION = "/re/frida/AgentSession";
 		public const string AGENT_CONTROLLER = "/re/frida/AgentController";
 		public const string AGENT_MESSAGE_SINK = "/re/frida/AgentMessageSink";
+		public const string MESSAGE_RING_PROVIDER = "/re/frida/MessageRingProvider";
 		public const string GADGET_SESSION = "/re/frida/GadgetSession";
 		public const string CHANNEL = "/re/frida/Channel";
 		public const string SERVICE = "/re/frida/Service";
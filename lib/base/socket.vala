@@ -1,6 +1,10 @@
 namespace Frida {
 	public const uint16 DEFAULT_CONTROL_PORT = 27042;
 	public const uint16 DEFAULT_CLUSTER_PORT = 27052;
+	public const uint DEFAULT_WEB_FRAME_SIZE = 256 * 1024;
+	public const uint TETHERED_WEB_FRAME_SIZE = 1024 * 1024;
+
+	private const string MAX_FRAME_SIZE_HEADER = "X-Frida-Max-Frame-Size";
 
 	public SocketConnectable parse_control_address (string? address, uint16 port = 0) throws Error {
 		return parse_socket_address (address, port, "127.0.0.1", DEFAULT_CONTROL_PORT);
@@ -128,6 +132,18 @@ namespace Frida {
 			set;
 		}
 
+		public uint max_frame_size {
+			get;
+			set;
+			default = DEFAULT_WEB_FRAME_SIZE;
+		}
+
+		public WebCompression compression {
+			get;
+			set;
+			default = DEFAULT;
+		}
+
 		public EndpointParameters (string? address = null, uint16 port = 0, TlsCertificate? certificate = null,
 				string? origin = null, AuthenticationService? auth_service = null, File? asset_root = null) {
 			Object (
@@ -142,7 +158,10 @@ namespace Frida {
 	}
 
 	public async IOStream negotiate_connection (IOStream stream, WebServiceTransport transport, string host, string? origin,
-			Cancellable? cancellable) throws Error, IOError {
+			EndpointParameters? endpoint_params, Cancellable? cancellable) throws Error, IOError {
+		uint max_frame_size = (endpoint_params != null) ? endpoint_params.max_frame_size : DEFAULT_WEB_FRAME_SIZE;
+		WebCompression compression = (endpoint_params != null) ? endpoint_params.compression : WebCompression.DEFAULT;
+
 		var input = (DataInputStream) Object.new (typeof (DataInputStream),
 			"base-stream", stream.get_input_stream (),
 			"close-base-stream", false,
@@ -164,6 +183,9 @@ namespace Frida {
 		Soup.websocket_client_prepare_handshake (msg, origin, null, null);
 		msg.request_headers.replace ("Host", make_host_header_value (uri));
 		msg.request_headers.replace ("User-Agent", "Frida/" + _version_string ());
+		msg.request_headers.replace (MAX_FRAME_SIZE_HEADER, max_frame_size.to_string ());
+		if (compression == DEFLATE)
+			msg.request_headers.replace ("Sec-WebSocket-Extensions", "permessage-deflate; client_max_window_bits");
 		msg.request_headers.foreach ((name, val) => {
 			request.append (name + ": " + val + "\r\n");
 		});
@@ -205,14 +227,26 @@ namespace Frida {
 				throw new Error.PROTOCOL ("%s", reason_phrase);
 		}
 
+		var extensions = new List<Soup.WebsocketExtension> ();
+		string? accepted_extensions = headers.get_one ("Sec-WebSocket-Extensions");
+		if (accepted_extensions != null) {
+			if (compression != DEFLATE)
+				throw new Error.PROTOCOL ("Server accepted an extension that was not offered");
+			extensions.append (make_deflate_extension (accepted_extensions));
+		}
+
+		uint max_incoming_frame_size, max_outgoing_frame_size;
+		compute_frame_size_limits (max_frame_size, headers.get_one (MAX_FRAME_SIZE_HEADER), out max_incoming_frame_size,
+			out max_outgoing_frame_size);
+
 		WebConnection connection = null;
 		var frida_context = MainContext.ref_thread_default ();
 		var dbus_context = yield get_dbus_context ();
 		var dbus_source = new IdleSource ();
 		dbus_source.set_callback (() => {
 			var websocket = new Soup.WebsocketConnection (stream, msg.uri, CLIENT, origin, protocol,
-				new List<Soup.WebsocketExtension> ());
-			connection = new WebConnection (websocket);
+				(owned) extensions);
+			connection = new WebConnection (websocket, max_incoming_frame_size, max_outgoing_frame_size);
 
 			var frida_source = new IdleSource ();
 			frida_source.set_callback (negotiate_connection.callback);
@@ -226,6 +260,51 @@ namespace Frida {
 		return connection;
 	}
 
+	private Soup.WebsocketExtension make_deflate_extension (string header_value) throws Error {
+		string[] tokens = header_value.split (";");
+		if (tokens[0].strip () != "permessage-deflate")
+			throw new Error.PROTOCOL ("Unsupported WebSocket extension: %s", tokens[0].strip ());
+
+		var params = new HashTable<string, string> (str_hash, str_equal);
+		foreach (unowned string token in tokens[1:tokens.length]) {
+			string[] pair = token.strip ().split ("=", 2);
+			params[pair[0]] = (pair.length == 2) ? pair[1].strip ().replace ("\"", "") : "";
+		}
+
+		var extension = (Soup.WebsocketExtension) Object.new (typeof (Soup.WebsocketExtensionDeflate));
+		try {
+			extension.configure (CLIENT, params);
+		} catch (GLib.Error e) {
+			throw new Error.PROTOCOL ("%s", e.message);
+		}
+
+		return extension;
+	}
+
+	public EndpointParameters make_tethered_endpoint_params () {
+		var params = new EndpointParameters ();
+		params.max_frame_size = TETHERED_WEB_FRAME_SIZE;
+		return params;
+	}
+
+	/*
+	 * A peer that doesn't advertise its limit predates the header, so it neither knows ours nor sends anything larger
+	 * than the old fixed frame size.
+	 */
+	private void compute_frame_size_limits (uint local_max_frame_size, string? peer_header_value, out uint max_incoming,
+			out uint max_outgoing) {
+		uint64 size;
+		if (peer_header_value == null || !uint64.try_parse (peer_header_value, out size) || size < 1024 ||
+				size > uint32.MAX - 1) {
+			max_incoming = DEFAULT_WEB_FRAME_SIZE;
+			max_outgoing = DEFAULT_WEB_FRAME_SIZE;
+			return;
+		}
+
+		max_incoming = local_max_frame_size;
+		max_outgoing = (uint) size;
+	}
+
 	private string make_host_header_value (Uri uri) {
 		unowned string host = uri.get_host ();
 		if (!Hostname.is_ip_address (host))
@@ -466,6 +545,12 @@ namespace Frida {
 				server = (Soup.Server) Object.new (typeof (Soup.Server),
 					"tls-certificate", endpoint_params.certificate);
 
+				if (endpoint_params.compression == DEFLATE)
+					server.add_websocket_extension (typeof (Soup.WebsocketExtensionDeflate));
+				else if (endpoint_params.compression == NONE)
+					server.remove_websocket_extension (typeof (Soup.WebsocketExtensionDeflate));
+
+				server.request_read.connect (on_request_read);
 				server.add_websocket_handler ("/ws", endpoint_params.origin, null, on_websocket_opened);
 
 				if (endpoint_params.asset_root != null)
@@ -540,9 +625,20 @@ namespace Frida {
 				throw new Error.NOT_SUPPORTED ("%s", e.message);
 			}
 
+			private void on_request_read (Soup.ServerMessage msg) {
+				if (msg.get_uri ().get_path () == "/ws") {
+					msg.get_response_headers ().replace (MAX_FRAME_SIZE_HEADER,
+						endpoint_params.max_frame_size.to_string ());
+				}
+			}
+
 			private void on_websocket_opened (Soup.Server server, Soup.ServerMessage msg, string path,
 					Soup.WebsocketConnection connection) {
-				var peer = new WebConnection (connection);
+				uint max_incoming_frame_size, max_outgoing_frame_size;
+				compute_frame_size_limits (endpoint_params.max_frame_size,
+					msg.get_request_headers ().get_one (MAX_FRAME_SIZE_HEADER), out max_incoming_frame_size,
+					out max_outgoing_frame_size);
+				var peer = new WebConnection (connection, max_incoming_frame_size, max_outgoing_frame_size);
 				peer.websocket_closed.connect (on_websocket_closed);
 				connections.add (peer);
 
@@ -840,6 +936,23 @@ namespace Frida {
 		TLS
 	}
 
+	/*
+	 * DEFAULT leaves libsoup's choice alone: servers accept permessage-deflate, clients don't offer it.
+	 */
+	public enum WebCompression {
+		DEFAULT,
+		NONE,
+		DEFLATE;
+
+		public static WebCompression from_nick (string nick) throws Error {
+			return Marshal.enum_from_nick<WebCompression> (nick);
+		}
+
+		public string to_nick () {
+			return Marshal.enum_to_nick<WebCompression> (this);
+		}
+	}
+
 	public enum WebServiceFlavor {
 		CONTROL,
 		CLUSTER
@@ -883,15 +996,33 @@ namespace Frida {
 			construct;
 		}
 
-		private ByteArray recv_queue = new ByteArray ();
-		private ByteArray send_queue = new ByteArray ();
+		public uint max_incoming_frame_size {
+			get;
+			construct;
+		}
 
-		public WebConnection (Soup.WebsocketConnection websocket) {
-			Object (websocket: websocket);
+		public uint max_outgoing_frame_size {
+			get;
+			construct;
+		}
+
+		private Gee.Queue<Bytes> recv_queue = new Gee.ArrayQueue<Bytes> ();
+		private size_t recv_offset = 0;
+		private Gee.Queue<Bytes> send_queue = new Gee.ArrayQueue<Bytes> ();
+		private size_t send_offset = 0;
+		private size_t send_queue_size = 0;
+
+		public WebConnection (Soup.WebsocketConnection websocket, uint max_incoming_frame_size,
+				uint max_outgoing_frame_size) {
+			Object (
+				websocket: websocket,
+				max_incoming_frame_size: max_incoming_frame_size,
+				max_outgoing_frame_size: max_outgoing_frame_size
+			);
 		}
 
 		construct {
-			websocket.max_incoming_payload_size = (256 * 1024) + 1; // XXX: There's an off-by-one error in libsoup
+			websocket.max_incoming_payload_size = max_incoming_frame_size + 1; // XXX: There's an off-by-one error in libsoup
 
 			websocket.closed.connect (on_closed);
 			websocket.message.connect (on_message);
@@ -916,7 +1047,7 @@ namespace Frida {
 		protected override IOCondition query_events () {
 			IOCondition new_events = 0;
 
-			if (recv_queue.len > 0 || state != OPEN)
+			if (!recv_queue.is_empty || state != OPEN)
 				new_events |= IN;
 
 			if (state == OPEN)
@@ -935,11 +1066,24 @@ namespace Frida {
 		public override ssize_t read (uint8[] buffer) throws IOError {
 			ssize_t n = 0;
 			with_state_lock (() => {
-				n = ssize_t.min (recv_queue.len, buffer.length);
-				if (n > 0) {
-					Memory.copy (buffer, recv_queue.data, n);
-					recv_queue.remove_range (0, (uint) n);
+				size_t capacity = buffer.length;
+				size_t copied = 0;
+				Bytes? head;
+				while (copied != capacity && (head = recv_queue.peek ()) != null) {
+					unowned uint8[] data = head.get_data ();
+					size_t chunk_size = size_t.min (data.length - recv_offset, capacity - copied);
+					Memory.copy ((uint8 *) buffer + copied, (uint8 *) data + recv_offset, chunk_size);
+					copied += chunk_size;
+
+					recv_offset += chunk_size;
+					if (recv_offset == data.length) {
+						recv_queue.poll ();
+						recv_offset = 0;
+					}
+				}
 
+				n = (ssize_t) copied;
+				if (n > 0) {
 					update_pending_io ();
 				} else {
 					if (state == OPEN)
@@ -954,8 +1098,10 @@ namespace Frida {
 		}
 
 		public override ssize_t write (uint8[] buffer) {
+			var bytes = new Bytes (buffer);
 			with_state_lock (() => {
-				send_queue.append (buffer);
+				send_queue.offer (bytes);
+				send_queue_size += bytes.get_size ();
 			});
 
 			if (main_context.is_owner ()) {
@@ -976,21 +1122,49 @@ namespace Frida {
 			if (websocket.state != OPEN)
 				return;
 
-			size_t max_message_size = (size_t) websocket.max_incoming_payload_size - 1;
+			size_t max_message_size = max_outgoing_frame_size;
 
 			while (true) {
-				uint8[]? chunk = null;
+				Bytes? message = null;
 				with_state_lock (() => {
-					size_t n = size_t.min (send_queue.len, max_message_size);
-					if (n == 0)
-						return;
-					chunk = send_queue.data[0:n];
-					send_queue.remove_range (0, (uint) n);
+					message = take_outgoing_message (max_message_size);
 				});
-				if (chunk == null)
+				if (message == null)
 					return;
 
-				websocket.send_binary (chunk);
+				websocket.send_message (BINARY, message);
+			}
+		}
+
+		private Bytes? take_outgoing_message (size_t max_size) {
+			Bytes? head = send_queue.peek ();
+			if (head == null)
+				return null;
+
+			size_t head_remaining = head.get_size () - send_offset;
+			if (head_remaining >= max_size || head_remaining == send_queue_size) {
+				size_t n = size_t.min (head_remaining, max_size);
+				Bytes message = (n == head.get_size ()) ? head : new Bytes.from_bytes (head, send_offset, n);
+				consume_outgoing (head, n);
+				return message;
+			}
+
+			var buffer = new ByteArray.sized ((uint) size_t.min (send_queue_size, max_size));
+			while (buffer.len != max_size && (head = send_queue.peek ()) != null) {
+				unowned uint8[] data = head.get_data ();
+				size_t n = size_t.min (data.length - send_offset, max_size - buffer.len);
+				buffer.append (data[(int) send_offset:(int) (send_offset + n)]);
+				consume_outgoing (head, n);
+			}
+			return ByteArray.free_to_bytes ((owned) buffer);
+		}
+
+		private void consume_outgoing (Bytes head, size_t n) {
+			send_offset += n;
+			send_queue_size -= n;
+			if (send_offset == head.get_size ()) {
+				send_queue.poll ();
+				send_offset = 0;
 			}
 		}
 
@@ -1004,8 +1178,11 @@ namespace Frida {
 		}
 
 		private void on_message (int type, Bytes message) {
+			if (message.get_size () == 0)
+				return;
+
 			with_state_lock (() => {
-				recv_queue.append (message.get_data ());
+				recv_queue.offer (message);
 				update_pending_io ();
 			});
 		}
@@ -24,6 +24,12 @@ namespace Frida.Gadget {
 			default = Gum.CodeSigningPolicy.OPTIONAL;
 		}
 
+		public string? bytecode_cache {
+			get;
+			set;
+			default = null;
+		}
+
 		public bool deserialize_property (string property_name, out Value value, ParamSpec pspec, Json.Node property_node) {
 			if (property_name == "interaction" && property_node.get_node_type () == Json.NodeType.OBJECT) {
 				var interaction_node = property_node.get_object ();
@@ -196,6 +202,18 @@ namespace Frida.Gadget {
 			get;
 			set;
 		}
+
+		public uint max_frame_size {
+			get;
+			set;
+			default = DEFAULT_WEB_FRAME_SIZE;
+		}
+
+		public WebCompression compression {
+			get;
+			set;
+			default = DEFAULT;
+		}
 	}
 
 	private sealed class ListenInteraction : SocketInteraction {
@@ -866,8 +884,12 @@ namespace Frida.Gadget {
 
 		protected async PortalMembershipId join_portal (string address, PortalOptions options,
 				Cancellable? cancellable) throws Error, IOError {
+			var endpoint_params = new EndpointParameters ();
+			endpoint_params.max_frame_size = options.max_frame_size;
+			endpoint_params.compression = options.compression;
+
 			var client = new PortalClient (this, parse_cluster_address (address), address, options.certificate, options.token,
-				options.acl, compute_app_info ());
+				options.acl, compute_app_info (), endpoint_params);
 			client.eternalized.connect (on_eternalized);
 			client.resume.connect (Frida.Gadget.resume);
 			client.kill.connect (Frida.Gadget.kill);
@@ -925,6 +947,7 @@ namespace Frida.Gadget {
 
 	private sealed class ScriptRunner : BaseController {
 		private ScriptEngine engine;
+		private BytecodeCache? bytecode_cache;
 		private Script script;
 
 		public ScriptRunner (Config config, Location location) {
@@ -933,10 +956,11 @@ namespace Frida.Gadget {
 
 		construct {
 			engine = new ScriptEngine (this);
+			bytecode_cache = BytecodeCache.open (config, location);
 
 			var path = resolve_script_path (config, location);
 			var interaction = config.interaction as ScriptInteraction;
-			script = new Script (path, interaction.parameters, interaction.on_change, engine);
+			script = new Script (path, interaction.parameters, interaction.on_change, engine, bytecode_cache);
 		}
 
 		protected override async void on_start () throws Error, IOError {
@@ -978,6 +1002,7 @@ namespace Frida.Gadget {
 		}
 
 		private ScriptEngine engine;
+		private BytecodeCache? bytecode_cache;
 		private Gee.HashMap<string, Script> scripts = new Gee.HashMap<string, Script> ();
 		private bool scan_in_progress = false;
 		private GLib.FileMonitor monitor;
@@ -993,6 +1018,7 @@ namespace Frida.Gadget {
 
 		construct {
 			engine = new ScriptEngine (this);
+			bytecode_cache = BytecodeCache.open (config, location);
 		}
 
 		protected override async void on_start () throws Error, IOError {
@@ -1073,7 +1099,7 @@ namespace Frida.Gadget {
 							}
 
 							if (script == null) {
-								script = new Script (script_path, parameters, on_change, engine);
+								script = new Script (script_path, parameters, on_change, engine, bytecode_cache);
 								yield script.start ();
 							}
 
@@ -1177,7 +1203,7 @@ namespace Frida.Gadget {
 	}
 
 	private sealed class Script : Object, RpcPeer {
-		private const uint8 QUICKJS_BYTECODE_MAGIC =
+		public const uint8 QUICKJS_BYTECODE_MAGIC =
 #if BIG_ENDIAN
 			0x42
 #else
@@ -1212,18 +1238,25 @@ namespace Frida.Gadget {
 			construct;
 		}
 
+		public BytecodeCache? bytecode_cache {
+			get;
+			construct;
+		}
+
 		private AgentScriptId id;
 		private bool load_in_progress = false;
 		private GLib.FileMonitor monitor;
 		private Source unchanged_timeout;
 		private RpcClient rpc_client;
 
-		public Script (string path, Json.Node parameters, ChangeBehavior on_change, ScriptEngine engine) {
+		public Script (string path, Json.Node parameters, ChangeBehavior on_change, ScriptEngine engine,
+				BytecodeCache? bytecode_cache) {
 			Object (
 				path: path,
 				parameters: parameters,
 				on_change: on_change,
-				engine: engine
+				engine: engine,
+				bytecode_cache: bytecode_cache
 			);
 		}
 
@@ -1303,6 +1336,8 @@ namespace Frida.Gadget {
 				ScriptEngine.ScriptInstance instance;
 				if (contents.length > 0 && contents[0] == QUICKJS_BYTECODE_MAGIC)
 					instance = yield engine.create_script (null, contents, options);
+				else if (bytecode_cache != null)
+					instance = yield create_script_using_cache (contents, options);
 				else
 					instance = yield engine.create_script ((string) contents.get_data (), null, options);
 
@@ -1317,6 +1352,31 @@ namespace Frida.Gadget {
 			}
 		}
 
+		private async ScriptEngine.ScriptInstance create_script_using_cache (Bytes source, ScriptOptions options)
+				throws Error {
+			var key = bytecode_cache.compute_key (options.name, source);
+
+			Bytes? bytecode = bytecode_cache.lookup (key);
+			if (bytecode != null && bytecode.length > 0 && bytecode[0] == QUICKJS_BYTECODE_MAGIC) {
+				try {
+					return yield engine.create_script (null, bytecode, options);
+				} catch (Error e) {
+				}
+			}
+			if (bytecode != null)
+				bytecode_cache.invalidate (key);
+
+			unowned string code = (string) source.get_data ();
+			try {
+				bytecode = yield engine.compile_script (code, options);
+			} catch (Error e) {
+				return yield engine.create_script (code, null, options);
+			}
+			bytecode_cache.store (key, bytecode);
+
+			return yield engine.create_script (null, bytecode, options);
+		}
+
 		private async void call_init () {
 			var stage = new Json.Node.alloc ().init_string ((peek_state () == State.CREATED) ? "early" : "late");
 
@@ -1394,6 +1454,186 @@ namespace Frida.Gadget {
 		}
 	}
 
+	private sealed class BytecodeCache : Object {
+		public string directory {
+			get;
+			construct;
+		}
+
+		public string module_id {
+			get;
+			construct;
+		}
+
+		private string runtime_id;
+
+		private const string STAMP_FILENAME = "runtime";
+		private const string ENTRY_SUFFIX = ".qjsbc";
+		private const uint MAX_ENTRIES = 128;
+		private const uint64 MAX_TOTAL_SIZE = 32 * 1024 * 1024;
+
+		public static BytecodeCache? open (Config config, Location location) {
+			string? raw_path = config.bytecode_cache;
+			if (raw_path == null || config.runtime == ScriptRuntime.V8)
+				return null;
+
+			var cache = new BytecodeCache (location.resolve_asset_path (raw_path), compute_module_id (location.path));
+			try {
+				cache.prepare ();
+			} catch (FileError e) {
+				log_warning ("Bytecode cache disabled: %s".printf (e.message));
+				return null;
+			}
+
+			return cache;
+		}
+
+		private BytecodeCache (string directory, string module_id) {
+			Object (directory: directory, module_id: module_id);
+		}
+
+		construct {
+			runtime_id = "%s-%s-qjs%u-%u%s".printf (_version_string (), module_id, Script.QUICKJS_BYTECODE_MAGIC,
+				(uint) (sizeof (void *) * 8),
+#if BIG_ENDIAN
+				"be"
+#else
+				"le"
+#endif
+			);
+		}
+
+		private void prepare () throws FileError {
+			if (DirUtils.create_with_parents (directory, 0755) == -1)
+				throw new FileError.FAILED ("Unable to create %s: %s", directory, strerror (errno));
+
+			var stamp_path = Path.build_filename (directory, STAMP_FILENAME);
+			string? stamp = null;
+			try {
+				FileUtils.get_contents (stamp_path, out stamp);
+			} catch (FileError e) {
+			}
+			if (stamp == runtime_id) {
+				prune ();
+				return;
+			}
+
+			var dir = Dir.open (directory);
+			string? name;
+			while ((name = dir.read_name ()) != null) {
+				if (name.has_suffix (ENTRY_SUFFIX))
+					FileUtils.unlink (Path.build_filename (directory, name));
+			}
+
+			FileUtils.set_contents (stamp_path, runtime_id);
+		}
+
+		/*
+		 * Gum, and thus QuickJS, is linked into the gadget, so the size and mtime of our own module tell development
+		 * builds sharing the same version string apart.
+		 */
+		private static string compute_module_id (string? module_path) {
+			if (module_path == null)
+				return "unknown";
+
+			try {
+				var info = File.new_for_path (module_path).query_info (FileAttribute.STANDARD_SIZE + "," +
+					FileAttribute.TIME_MODIFIED, FileQueryInfoFlags.NONE);
+				return ("%" + uint64.FORMAT_MODIFIER + "x.%" + uint64.FORMAT_MODIFIER + "x").printf (
+					(uint64) info.get_size (), info.get_attribute_uint64 (FileAttribute.TIME_MODIFIED));
+			} catch (GLib.Error e) {
+				return "unknown";
+			}
+		}
+
+		public string compute_key (string name, Bytes source) {
+			uint8[] separator = { 0 };
+
+			var checksum = new Checksum (SHA256);
+			checksum.update (runtime_id.data, runtime_id.length);
+			checksum.update (separator, separator.length);
+			checksum.update (name.data, name.length);
+			checksum.update (separator, separator.length);
+			checksum.update (source.get_data (), source.get_size ());
+
+			return checksum.get_string ();
+		}
+
+		public Bytes? lookup (string key) {
+			var path = entry_path_for (key);
+
+			uint8[] data;
+			try {
+				FileUtils.get_data (path, out data);
+			} catch (FileError e) {
+				return null;
+			}
+
+			try {
+				File.new_for_path (path).set_attribute_uint64 (FileAttribute.TIME_MODIFIED,
+					get_real_time () / 1000000, FileQueryInfoFlags.NONE);
+			} catch (GLib.Error e) {
+			}
+
+			return new Bytes.take ((owned) data);
+		}
+
+		public void store (string key, Bytes bytecode) {
+			try {
+				FileUtils.set_data (entry_path_for (key), bytecode.get_data ());
+			} catch (FileError e) {
+				log_warning ("Unable to cache bytecode: %s".printf (e.message));
+				return;
+			}
+
+			prune ();
+		}
+
+		private void prune () {
+			var entries = new Gee.ArrayList<FileInfo> ();
+			uint64 total_size = 0;
+			try {
+				var enumerator = File.new_for_path (directory).enumerate_children (FileAttribute.STANDARD_NAME + "," +
+					FileAttribute.STANDARD_SIZE + "," + FileAttribute.TIME_MODIFIED, FileQueryInfoFlags.NONE);
+				FileInfo? info;
+				while ((info = enumerator.next_file ()) != null) {
+					if (!info.get_name ().has_suffix (ENTRY_SUFFIX))
+						continue;
+					entries.add (info);
+					total_size += info.get_size ();
+				}
+			} catch (GLib.Error e) {
+				return;
+			}
+
+			uint remaining = entries.size;
+			if (remaining <= MAX_ENTRIES && total_size <= MAX_TOTAL_SIZE)
+				return;
+
+			entries.sort ((a, b) => {
+				uint64 a_time = a.get_attribute_uint64 (FileAttribute.TIME_MODIFIED);
+				uint64 b_time = b.get_attribute_uint64 (FileAttribute.TIME_MODIFIED);
+				return (a_time < b_time) ? -1 : ((a_time > b_time) ? 1 : 0);
+			});
+
+			foreach (var info in entries) {
+				if (remaining <= MAX_ENTRIES && total_size <= MAX_TOTAL_SIZE)
+					break;
+				FileUtils.unlink (Path.build_filename (directory, info.get_name ()));
+				remaining--;
+				total_size -= info.get_size ();
+			}
+		}
+
+		public void invalidate (string key) {
+			FileUtils.unlink (entry_path_for (key));
+		}
+
+		private string entry_path_for (string key) {
+			return Path.build_filename (directory, key + ENTRY_SUFFIX);
+		}
+	}
+
 	private sealed class ControlServer : BaseController {
 		public EndpointParameters endpoint_params {
 			get;
@@ -1436,6 +1676,8 @@ namespace Frida.Gadget {
 
 			var endpoint_params = new EndpointParameters (interaction.address, interaction.port,
 				parse_certificate (interaction.certificate, location), interaction.origin, auth_service, asset_root);
+			endpoint_params.max_frame_size = interaction.max_frame_size;
+			endpoint_params.compression = interaction.compression;
 
 			service = new WebService (endpoint_params, WebServiceFlavor.CONTROL, interaction.on_port_conflict,
 				new TunnelInterfaceObserver ());
@@ -1556,7 +1798,7 @@ namespace Frida.Gadget {
 
 			MainContext dbus_context = yield get_dbus_context ();
 
-			var session = new LiveAgentSession (this, id, opts.persist_timeout, sink, dbus_context);
+			var session = new LiveAgentSession (this, id, opts, sink, dbus_context);
 			sessions[id] = session;
 			session.closed.connect (on_session_closed);
 			session.script_eternalized.connect (on_script_eternalized);
@@ -1792,6 +2034,8 @@ namespace Frida.Gadget {
 			public async HostProcessInfo[] enumerate_processes (HashTable<string, Variant> options,
 					Cancellable? cancellable) throws Error, IOError {
 				var opts = ProcessQueryOptions._deserialize (options);
+				if (opts.snapshot != null)
+					throw new Error.NOT_SUPPORTED ("Process snapshots are not supported by Gadget");
 
 				if (opts.has_selected_pids ()) {
 					bool gadget_is_selected = false;
@@ -1912,13 +2156,14 @@ namespace Frida.Gadget {
 				set;
 			}
 
-			public LiveAgentSession (ProcessInvader invader, AgentSessionId id, uint persist_timeout, AgentMessageSink sink,
+			public LiveAgentSession (ProcessInvader invader, AgentSessionId id, SessionOptions opts, AgentMessageSink sink,
 					MainContext dbus_context) {
 				Object (
 					invader: invader,
 					id: id,
-					persist_timeout: persist_timeout,
+					persist_timeout: opts.persist_timeout,
 					message_sink: sink,
+					session_options: opts,
 					frida_context: MainContext.ref_thread_default (),
 					dbus_context: dbus_context
 				);
@@ -1969,7 +2214,12 @@ namespace Frida.Gadget {
 		}
 
 		construct {
-			client = new PortalClient (this, connectable, host, certificate, token, acl, compute_app_info ());
+			var interaction = (ConnectInteraction) config.interaction;
+			var endpoint_params = new EndpointParameters ();
+			endpoint_params.max_frame_size = interaction.max_frame_size;
+			endpoint_params.compression = interaction.compression;
+
+			client = new PortalClient (this, connectable, host, certificate, token, acl, compute_app_info (), endpoint_params);
 			client.eternalized.connect (on_eternalized);
 			client.resume.connect (Frida.Gadget.resume);
 			client.kill.connect (Frida.Gadget.kill);
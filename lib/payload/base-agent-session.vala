@@ -23,6 +23,11 @@ namespace Frida {
 			set { transmitter.message_sink = value; }
 		}
 
+		public SessionOptions session_options {
+			get;
+			construct;
+		}
+
 		public MainContext frida_context {
 			get;
 			construct;
@@ -40,6 +45,8 @@ namespace Frida {
 
 		private ScriptEngine script_engine;
 		private AgentMessageTransmitter transmitter;
+		private Gee.Set<AgentScriptId?> pressure_subscribers =
+			new Gee.HashSet<AgentScriptId?> (AgentScriptId.hash, AgentScriptId.equal);
 
 		construct {
 			assert (invader != null);
@@ -49,11 +56,14 @@ namespace Frida {
 			script_engine = new ScriptEngine (invader);
 			script_engine.message_from_script.connect (on_message_from_script);
 			script_engine.message_from_debugger.connect (on_message_from_debugger);
+			script_engine.script_detached.connect (on_script_detached);
 
 			transmitter = new AgentMessageTransmitter (this, persist_timeout, frida_context, dbus_context);
+			transmitter.configure (session_options);
 			transmitter.closed.connect (on_transmitter_closed);
 			transmitter.new_candidates.connect (on_transmitter_new_candidates);
 			transmitter.candidate_gathering_done.connect (on_transmitter_candidate_gathering_done);
+			transmitter.queue_pressure_changed.connect (on_transmitter_queue_pressure_changed);
 		}
 
 		public async void close (Cancellable? cancellable) throws IOError {
@@ -139,7 +149,9 @@ namespace Frida {
 				Cancellable? cancellable) throws Error, IOError {
 			check_open ();
 
-			var instance = yield script_engine.create_script (source, null, ScriptOptions._deserialize (options));
+			var opts = ScriptOptions._deserialize (options);
+			var instance = yield script_engine.create_script (source, null, opts);
+			register_script (instance.script_id, opts);
 			return instance.script_id;
 		}
 
@@ -147,10 +159,18 @@ namespace Frida {
 				Cancellable? cancellable) throws Error, IOError {
 			check_open ();
 
-			var instance = yield script_engine.create_script (null, new Bytes (bytes), ScriptOptions._deserialize (options));
+			var opts = ScriptOptions._deserialize (options);
+			var instance = yield script_engine.create_script (null, new Bytes (bytes), opts);
+			register_script (instance.script_id, opts);
 			return instance.script_id;
 		}
 
+		private void register_script (AgentScriptId script_id, ScriptOptions opts) {
+			transmitter.configure_script (script_id, opts);
+			if (opts.notify_queue_pressure)
+				pressure_subscribers.add (script_id);
+		}
+
 		public async uint8[] compile_script (string source, HashTable<string, Variant> options,
 				Cancellable? cancellable) throws Error, IOError {
 			check_open ();
@@ -210,12 +230,31 @@ namespace Frida {
 					case DEBUGGER:
 						script_engine.post_to_debugger (m.script_id, m.text);
 						break;
+					case COMPRESSED_BATCH:
+						AgentMessageBatch.decompress (m, dispatch_message);
+						break;
 				}
 			}
 
 			transmitter.notify_rx_batch_id (batch_id);
 		}
 
+		private void dispatch_message (AgentMessageKind kind, AgentScriptId script_id, string text, Bytes? data) {
+			try {
+				switch (kind) {
+					case SCRIPT:
+						script_engine.post_to_script (script_id, text, data);
+						break;
+					case DEBUGGER:
+						script_engine.post_to_debugger (script_id, text);
+						break;
+					default:
+						break;
+				}
+			} catch (Error e) {
+			}
+		}
+
 		public async PortalMembershipId join_portal (string address, HashTable<string, Variant> options,
 				Cancellable? cancellable) throws Error, IOError {
 			return yield invader.join_portal (address, PortalOptions._deserialize (options), cancellable);
@@ -259,10 +298,16 @@ namespace Frida {
 			transmitter.post_message_from_debugger (script_id, message);
 		}
 
+		private void on_script_detached (AgentScriptId script_id) {
+			pressure_subscribers.remove (script_id);
+			transmitter.forget_script (script_id);
+		}
+
 		private void on_transmitter_closed () {
 			transmitter.closed.disconnect (on_transmitter_closed);
 			transmitter.new_candidates.disconnect (on_transmitter_new_candidates);
 			transmitter.candidate_gathering_done.disconnect (on_transmitter_candidate_gathering_done);
+			transmitter.queue_pressure_changed.disconnect (on_transmitter_queue_pressure_changed);
 
 			closed ();
 		}
@@ -274,5 +319,34 @@ namespace Frida {
 		private void on_transmitter_candidate_gathering_done () {
 			candidate_gathering_done ();
 		}
+
+		private void on_transmitter_queue_pressure_changed () {
+			if (pressure_subscribers.is_empty)
+				return;
+
+			var stanza = new Json.Builder ();
+			stanza
+				.begin_object ()
+				.set_member_name ("type")
+				.add_string_value ("frida:queue-pressure")
+				.set_member_name ("payload")
+				.begin_object ()
+				.set_member_name ("high")
+				.add_boolean_value (transmitter.under_pressure)
+				.set_member_name ("queuedBytes")
+				.add_int_value ((int64) transmitter.queued_bytes)
+				.set_member_name ("droppedMessages")
+				.add_int_value (transmitter.dropped_messages)
+				.end_object ()
+				.end_object ();
+			string json = Json.to_string (stanza.get_root (), false);
+
+			foreach (var script_id in pressure_subscribers) {
+				try {
+					script_engine.post_to_script (script_id, json);
+				} catch (Error e) {
+				}
+			}
+		}
 	}
 }
@@ -38,6 +38,11 @@ namespace Frida {
 			construct;
 		}
 
+		public EndpointParameters? endpoint_params {
+			get;
+			construct;
+		}
+
 		private DBusConnection? connection;
 		private SourceFunc? on_connection_event;
 		private TimeoutSource? reconnect_timer;
@@ -52,7 +57,7 @@ namespace Frida {
 		private Cancellable io_cancellable = new Cancellable ();
 
 		public PortalClient (ProcessInvader invader, SocketConnectable connectable, string host, TlsCertificate? certificate, string? token,
-				string[]? acl, HostApplicationInfo app_info) {
+				string[]? acl, HostApplicationInfo app_info, EndpointParameters? endpoint_params = null) {
 			Object (
 				invader: invader,
 				connectable: connectable,
@@ -60,7 +65,8 @@ namespace Frida {
 				certificate: certificate,
 				token: token,
 				acl: acl,
-				app_info: app_info
+				app_info: app_info,
+				endpoint_params: endpoint_params
 			);
 		}
 
@@ -178,7 +184,7 @@ namespace Frida {
 			var transport = (certificate != null) ? WebServiceTransport.TLS : WebServiceTransport.PLAIN;
 			string? origin = null;
 
-			stream = yield negotiate_connection (stream, transport, host, origin, io_cancellable);
+			stream = yield negotiate_connection (stream, transport, host, origin, endpoint_params, io_cancellable);
 
 			connection = yield new DBusConnection (stream, null, DELAY_MESSAGE_PROCESSING, null, io_cancellable);
 			connection.on_closed.connect (on_connection_closed);
@@ -290,7 +296,7 @@ namespace Frida {
 			LiveAgentSession? session = agent_sessions[id];
 			if (session != null)
 				throw new Error.INVALID_ARGUMENT ("Session already exists");
-			session = new LiveAgentSession (invader, id, opts.persist_timeout, sink, dbus_context);
+			session = new LiveAgentSession (invader, id, opts, sink, dbus_context);
 			agent_sessions[id] = session;
 			session.closed.connect (on_session_closed);
 			session.script_eternalized.connect (on_script_eternalized);
@@ -354,13 +360,14 @@ namespace Frida {
 				set;
 			}
 
-			public LiveAgentSession (ProcessInvader invader, AgentSessionId id, uint persist_timeout, AgentMessageSink sink,
+			public LiveAgentSession (ProcessInvader invader, AgentSessionId id, SessionOptions opts, AgentMessageSink sink,
 					MainContext dbus_context) {
 				Object (
 					invader: invader,
 					id: id,
-					persist_timeout: persist_timeout,
+					persist_timeout: opts.persist_timeout,
 					message_sink: sink,
+					session_options: opts,
 					frida_context: MainContext.ref_thread_default (),
 					dbus_context: dbus_context
 				);
@@ -2,6 +2,7 @@ namespace Frida {
 	public sealed class ScriptEngine : Object {
 		public signal void message_from_script (AgentScriptId script_id, string json, Bytes? data);
 		public signal void message_from_debugger (AgentScriptId script_id, string message);
+		public signal void script_detached (AgentScriptId script_id);
 
 		public weak ProcessInvader invader {
 			get;
@@ -125,6 +126,8 @@ namespace Frida {
 			instance.debug_message.disconnect (on_instance_debug_message);
 
 			instances.unset (instance.script_id);
+
+			script_detached (instance.script_id);
 		}
 
 		public async Bytes compile_script (string source, ScriptOptions options) throws Error {
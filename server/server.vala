@@ -15,6 +15,8 @@ namespace Frida.Server {
 #endif
 	private static string? softener_flavor_str = null;
 	private static bool enable_preload = true;
+	private static bool enable_warm_agents = false;
+	private static bool enable_message_ring = false;
 	private static bool report_crashes = true;
 	private static bool verbose = false;
 
@@ -45,6 +47,10 @@ namespace Frida.Server {
 #endif
 		{ "policy-softener", 0, 0, OptionArg.STRING, ref softener_flavor_str, "Select policy softener", "system|internal" },
 		{ "disable-preload", 'P', OptionFlags.REVERSE, OptionArg.NONE, ref enable_preload, "Disable preload optimization", null },
+		{ "warm-agents", 0, 0, OptionArg.NONE, ref enable_warm_agents,
+			"Keep helpers and agents warm to minimize attach latency", null },
+		{ "message-ring", 0, 0, OptionArg.NONE, ref enable_message_ring,
+			"Deliver agent messages through shared memory when possible", null },
 		{ "ignore-crashes", 'C', OptionFlags.REVERSE, OptionArg.NONE, ref report_crashes,
 			"Disable native crash reporter integration", null },
 		{ "verbose", 'v', 0, OptionArg.NONE, ref verbose, "Be verbose", null },
@@ -90,6 +96,8 @@ namespace Frida.Server {
 
 		var options = new ControlServiceOptions ();
 		options.enable_preload = enable_preload;
+		options.enable_warm_agents = enable_warm_agents;
+		options.enable_message_ring = enable_message_ring;
 		options.report_crashes = report_crashes;
 
 #if (IOS || TVOS) && !HAVE_EMBEDDED_ASSETS
@@ -81,6 +81,10 @@ namespace Frida {
 			}
 
 			var gdb = yield GDB.Client.open (stream, cancellable);
+			try {
+				yield gdb.enable_memory_cache (cancellable);
+			} catch (Error e) {
+			}
 
 			Barebone.Machine machine;
 			switch (gdb.arch) {
@@ -101,6 +105,9 @@ namespace Frida {
 					break;
 			}
 
+			if (gdb.memory_cache_enabled && !gdb.has_ram_regions)
+				yield add_ram_regions_from_page_tables (machine, cancellable);
+
 			size_t page_size;
 			try {
 				page_size = yield machine.query_page_size (cancellable);
@@ -139,6 +146,19 @@ namespace Frida {
 			return host_session;
 		}
 
+		private static async void add_ram_regions_from_page_tables (Barebone.Machine machine, Cancellable? cancellable)
+				throws IOError {
+			var gdb = machine.gdb;
+			try {
+				yield machine.enumerate_ranges (READ, r => {
+					if (r.type == MEMORY)
+						gdb.add_ram_region (r.base_va, r.size);
+					return true;
+				}, cancellable);
+			} catch (Error e) {
+			}
+		}
+
 		public async void destroy (HostSession session, Cancellable? cancellable) throws Error, IOError {
 			if (session != host_session)
 				throw new Error.INVALID_ARGUMENT ("Invalid host session");
@@ -405,20 +425,29 @@ namespace Frida {
 
 			foreach (var m in messages) {
 				switch (m.kind) {
-					case SCRIPT: {
-						BareboneScript? script = scripts[m.script_id];
-						if (script != null)
-							script.post (m.text, m.has_data ? new Bytes (m.data) : null);
+					case SCRIPT:
+						dispatch_message (m.kind, m.script_id, m.text, m.has_data ? new Bytes (m.data) : null);
 						break;
-					}
 					case DEBUGGER:
 						break;
+					case COMPRESSED_BATCH:
+						AgentMessageBatch.decompress (m, dispatch_message);
+						break;
 				}
 			}
 
 			transmitter.notify_rx_batch_id (batch_id);
 		}
 
+		private void dispatch_message (AgentMessageKind kind, AgentScriptId script_id, string text, Bytes? data) {
+			if (kind != SCRIPT)
+				return;
+
+			BareboneScript? script = scripts[script_id];
+			if (script != null)
+				script.post (text, data);
+		}
+
 		private void on_message_from_script (BareboneScript script, string json, Bytes? data) {
 			transmitter.post_message_from_script (script.id, json, data);
 		}
@@ -485,6 +514,19 @@ namespace Frida {
 						break;
 					case DEBUGGER:
 						break;
+					case COMPRESSED_BATCH: {
+						var script_ids = new Gee.ArrayList<uint> ();
+						var texts = new Gee.ArrayList<string> ();
+						AgentMessageBatch.decompress (m, (kind, script_id, text, data) => {
+							if (kind == SCRIPT) {
+								script_ids.add (script_id.handle);
+								texts.add (text);
+							}
+						});
+						for (int i = 0; i != script_ids.size; i++)
+							yield connection.post_script_message (AgentScriptId (script_ids[i]), texts[i], null, cancellable);
+						break;
+					}
 				}
 			}
 
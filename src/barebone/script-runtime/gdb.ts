@@ -5,6 +5,7 @@ export const gdb = $gdb;
 export interface GDBClient {
     state: GDBState;
     exception: GDBException | null;
+    memoryCacheStats: GDBMemoryCacheStats;
     continue(): void;
     stop(): void;
     restart(): void;
@@ -47,6 +48,12 @@ type GDBState =
     | "closed"
     ;
 
+export interface GDBMemoryCacheStats {
+    enabled: boolean;
+    hits: number;
+    misses: number;
+}
+
 export interface GDBException {
     signum: number;
     breakpoint: GDBBreakpoint | null;
@@ -233,6 +233,7 @@ namespace Frida {
 			var gdb_obj = ctx.make_object ();
 			add_getter (gdb_obj, "state", on_gdb_get_state);
 			add_getter (gdb_obj, "exception", on_gdb_get_exception);
+			add_getter (gdb_obj, "memoryCacheStats", on_gdb_get_memory_cache_stats);
 			add_cfunc (gdb_obj, "continue", on_gdb_continue, 0);
 			add_cfunc (gdb_obj, "stop", on_gdb_stop, 0);
 			add_cfunc (gdb_obj, "restart", on_gdb_restart, 0);
@@ -2037,6 +2038,18 @@ namespace Frida {
 			return result;
 		}
 
+		private static QuickJS.Value on_gdb_get_memory_cache_stats (QuickJS.Context ctx, QuickJS.Value this_val,
+				QuickJS.Value[] argv) {
+			BareboneScript * script = ctx.get_opaque ();
+			GDB.Client gdb = script->gdb;
+
+			var result = ctx.make_object ();
+			result.set_property_str (ctx, "enabled", ctx.make_bool (gdb.memory_cache_enabled));
+			result.set_property_str (ctx, "hits", ctx.make_int64 ((int64) gdb.memory_cache_hits));
+			result.set_property_str (ctx, "misses", ctx.make_int64 ((int64) gdb.memory_cache_misses));
+			return result;
+		}
+
 		private static QuickJS.Value on_gdb_continue (QuickJS.Context ctx, QuickJS.Value this_val, QuickJS.Value[] argv) {
 			BareboneScript * script = ctx.get_opaque ();
 
@@ -54,7 +54,9 @@ namespace Frida {
 #endif
 #if LINUX
 			var tempdir = new TemporaryDirectory ();
-			session = new LinuxHostSession (new LinuxHelperProcess (tempdir), tempdir, opts.report_crashes);
+			session = new LinuxHostSession (new LinuxHelperProcess (tempdir), tempdir, opts.report_crashes,
+				opts.enable_warm_agents);
+			((LocalHostSession) session).enable_message_ring = opts.enable_message_ring;
 #endif
 #if FREEBSD
 			session = new FreebsdHostSession ();
@@ -825,6 +827,9 @@ namespace Frida {
 
 			private Gee.Set<uint> registrations = new Gee.HashSet<uint> ();
 			private TimeoutSource? ping_timer;
+			private uint snapshot_scope = next_snapshot_scope++;
+
+			private static uint next_snapshot_scope = 1;
 
 			public ControlChannel (ConnectionHandler parent, DBusConnection connection) {
 				Object (parent: parent, connection: connection);
@@ -893,6 +898,10 @@ namespace Frida {
 
 			public async HostProcessInfo[] enumerate_processes (HashTable<string, Variant> options,
 					Cancellable? cancellable) throws GLib.Error {
+				Variant? snapshot = options["snapshot"];
+				if (snapshot != null && snapshot.is_of_type (VariantType.STRING))
+					options["snapshot"] = new Variant.string ("%u/%s".printf (snapshot_scope, snapshot.get_string ()));
+
 				return yield parent.host_session.enumerate_processes (options, cancellable);
 			}
 
@@ -1142,5 +1151,19 @@ namespace Frida {
 			set;
 			default = true;
 		}
+
+		// Only takes effect together with enable_preload, and currently only on Linux.
+		public bool enable_warm_agents {
+			get;
+			set;
+			default = false;
+		}
+
+		// Currently only supported on Linux.
+		public bool enable_message_ring {
+			get;
+			set;
+			default = false;
+		}
 	}
 }
@@ -236,6 +236,7 @@ namespace Frida {
 		private RemoteServer? current_remote_server;
 		private Timer? last_server_check_timer;
 		private Error? last_server_check_error;
+		private EndpointParameters endpoint_params = make_tethered_endpoint_params ();
 		private Gee.HashMap<AgentSessionId?, AgentSessionId?> remote_agent_sessions =
 			new Gee.HashMap<AgentSessionId?, AgentSessionId?> (AgentSessionId.hash, AgentSessionId.equal);
 
@@ -795,7 +796,7 @@ namespace Frida {
 				WebServiceTransport transport = PLAIN;
 				string? origin = null;
 
-				stream = yield negotiate_connection (stream, transport, "lolcathost", origin, cancellable);
+				stream = yield negotiate_connection (stream, transport, "lolcathost", origin, endpoint_params, cancellable);
 
 				var connection = yield new DBusConnection (stream, null, DBusConnectionFlags.NONE, null, cancellable);
 
@@ -974,7 +975,7 @@ namespace Frida {
 				WebServiceTransport transport = PLAIN;
 				string? origin = null;
 
-				stream = yield negotiate_connection (stream, transport, "lolcathost", origin, cancellable);
+				stream = yield negotiate_connection (stream, transport, "lolcathost", origin, endpoint_params, cancellable);
 
 				connection = yield new DBusConnection (stream, null, DBusConnectionFlags.NONE, null, cancellable);
 
@@ -253,6 +253,9 @@ namespace Frida {
 				int interval = options.keepalive_interval;
 				if (interval != -1)
 					opts["keepalive_interval"] = interval;
+
+				opts["max_frame_size"] = options.max_frame_size;
+				opts["compression"] = options.compression;
 			}
 
 			var device = new Device (this, socket_device.provider, id, name, raw_options);
@@ -603,6 +606,44 @@ namespace Frida {
 			}
 		}
 
+		/*
+		 * Returns how long each phase of attaching to the given process took, with start and end times in microseconds of
+		 * monotonic time. Only local Linux devices record these.
+		 */
+		public async InjectionTimeline query_injection_timeline (uint pid, Cancellable? cancellable = null)
+				throws Error, IOError {
+			check_open ();
+
+#if HAVE_LOCAL_BACKEND && LINUX
+			var linux_session = (yield get_host_session (cancellable)) as LinuxHostSession;
+			if (linux_session != null) {
+				InjectionPhaseInfo[] phases = yield linux_session.query_injection_timeline (pid, cancellable);
+
+				var items = new Gee.ArrayList<InjectionPhase> ();
+				foreach (var phase in phases)
+					items.add (new InjectionPhase (phase.name, phase.start_time, phase.end_time));
+				return new InjectionTimeline (items);
+			}
+#endif
+
+			throw new Error.NOT_SUPPORTED ("Injection timelines are only available on local Linux devices");
+		}
+
+		public InjectionTimeline query_injection_timeline_sync (uint pid, Cancellable? cancellable = null)
+				throws Error, IOError {
+			var task = create<QueryInjectionTimelineTask> ();
+			task.pid = pid;
+			return task.execute (cancellable);
+		}
+
+		private class QueryInjectionTimelineTask : DeviceTask<InjectionTimeline> {
+			public uint pid;
+
+			protected override async InjectionTimeline perform_operation () throws Error, IOError {
+				return yield parent.query_injection_timeline (pid, cancellable);
+			}
+		}
+
 		public async Application? get_frontmost_application (FrontmostQueryOptions? options = null,
 				Cancellable? cancellable = null) throws Error, IOError {
 			check_open ();
@@ -1570,6 +1611,18 @@ namespace Frida {
 			set;
 			default = -1;
 		}
+
+		public uint max_frame_size {
+			get;
+			set;
+			default = DEFAULT_WEB_FRAME_SIZE;
+		}
+
+		public WebCompression compression {
+			get;
+			set;
+			default = DEFAULT;
+		}
 	}
 
 	public sealed class ApplicationList : Object {
@@ -1819,6 +1872,47 @@ namespace Frida {
 		}
 	}
 
+	public sealed class InjectionTimeline : Object {
+		private Gee.List<InjectionPhase> items;
+
+		internal InjectionTimeline (Gee.List<InjectionPhase> items) {
+			this.items = items;
+		}
+
+		public int size () {
+			return items.size;
+		}
+
+		public new InjectionPhase get (int index) {
+			return items.get (index);
+		}
+	}
+
+	public sealed class InjectionPhase : Object {
+		public string name {
+			get;
+			construct;
+		}
+
+		public int64 start_time {
+			get;
+			construct;
+		}
+
+		public int64 end_time {
+			get;
+			construct;
+		}
+
+		internal InjectionPhase (string name, int64 start_time, int64 end_time) {
+			Object (
+				name: name,
+				start_time: start_time,
+				end_time: end_time
+			);
+		}
+	}
+
 	public sealed class Crash : Object {
 		public uint pid {
 			get;
@@ -2641,7 +2735,10 @@ namespace Frida {
 				nice_connection = null;
 			}
 
-			nice_iostream = null;
+			if (nice_iostream != null) {
+				nice_iostream.channel_opened.disconnect (on_nice_channel_opened);
+				nice_iostream = null;
+			}
 
 			nice_component_id = 0;
 			nice_stream_id = 0;
@@ -2715,6 +2812,7 @@ namespace Frida {
 				yield tc.handshake_async (Priority.DEFAULT, nice_cancellable);
 
 				nice_iostream = new SctpConnection (tc, answer.setup, answer.sctp_port, answer.max_message_size);
+				nice_iostream.channel_opened.connect (on_nice_channel_opened);
 
 				schedule_on_frida_thread (() => {
 					promise.resolve (nice_iostream);
@@ -2749,6 +2847,28 @@ namespace Frida {
 				nice_cancellable.cancel ();
 		}
 
+		private void on_nice_channel_opened (SctpChannel channel) {
+			var reassembler = new AgentMessageChannel.Reassembler ();
+			channel.message.connect (frame => {
+				try {
+					reassembler.feed (frame, on_nice_channel_message);
+				} catch (Error e) {
+				}
+			});
+		}
+
+		private void on_nice_channel_message (AgentMessageKind kind, AgentScriptId script_id, string text, Bytes? data) {
+			string text_copy = text;
+			schedule_on_frida_thread (() => {
+				if (state == INTERRUPTED)
+					return false;
+
+				dispatch_message (kind, script_id, text_copy, data);
+
+				return false;
+			});
+		}
+
 		private void on_new_candidates (string[] candidate_sdps) {
 			Nice.Agent? agent = nice_agent;
 			if (agent == null)
@@ -2885,16 +3005,12 @@ namespace Frida {
 
 			foreach (var m in messages) {
 				switch (m.kind) {
-					case SCRIPT: {
-						var script = scripts[m.script_id];
-						if (script != null)
-							script.message (m.text, m.has_data ? new Bytes (m.data) : null);
-						break;
-					}
+					case SCRIPT:
 					case DEBUGGER:
-						var script = scripts[m.script_id];
-						if (script != null)
-							script.on_debugger_message_from_backend (m.text);
+						dispatch_message (m.kind, m.script_id, m.text, m.has_data ? new Bytes (m.data) : null);
+						break;
+					case COMPRESSED_BATCH:
+						AgentMessageBatch.decompress (m, dispatch_message);
 						break;
 				}
 			}
@@ -2902,6 +3018,23 @@ namespace Frida {
 			last_rx_batch_id = batch_id;
 		}
 
+		private void dispatch_message (AgentMessageKind kind, AgentScriptId script_id, string text, Bytes? data) {
+			var script = scripts[script_id];
+			if (script == null)
+				return;
+
+			switch (kind) {
+				case SCRIPT:
+					script.message (text, data);
+					break;
+				case DEBUGGER:
+					script.on_debugger_message_from_backend (text);
+					break;
+				default:
+					break;
+			}
+		}
+
 		internal void _post_to_agent (AgentMessageKind kind, AgentScriptId script_id, string text, Bytes? data = null) {
 			if (state == DETACHED)
 				return;
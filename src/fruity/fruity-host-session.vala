@@ -180,6 +180,7 @@ namespace Frida {
 		private RemoteServer? current_remote_server;
 		private Timer? last_server_check_timer;
 		private Error? last_server_check_error;
+		private EndpointParameters endpoint_params = make_tethered_endpoint_params ();
 		private Gee.HashMap<AgentSessionId?, AgentSessionId?> remote_agent_sessions =
 			new Gee.HashMap<AgentSessionId?, AgentSessionId?> (AgentSessionId.hash, AgentSessionId.equal);
 
@@ -479,6 +480,8 @@ namespace Frida {
 			}
 
 			var opts = ProcessQueryOptions._deserialize (options);
+			if (opts.snapshot != null)
+				throw new Error.NOT_SUPPORTED ("Process snapshots are not supported by this device");
 			var scope = opts.scope;
 
 			var processes_request = new Promise<Gee.List<Fruity.DeviceInfoService.ProcessInfo>> ();
@@ -949,7 +952,7 @@ namespace Frida {
 				WebServiceTransport transport = PLAIN;
 				string? origin = null;
 
-				stream = yield negotiate_connection (stream, transport, "lolcathost", origin, cancellable);
+				stream = yield negotiate_connection (stream, transport, "lolcathost", origin, endpoint_params, cancellable);
 
 				var connection = yield new DBusConnection (stream, null, DBusConnectionFlags.NONE, null, cancellable);
 
@@ -1212,7 +1215,7 @@ namespace Frida {
 				WebServiceTransport transport = PLAIN;
 				string? origin = null;
 
-				stream = yield negotiate_connection (stream, transport, "lolcathost", origin, cancellable);
+				stream = yield negotiate_connection (stream, transport, "lolcathost", origin, endpoint_params, cancellable);
 
 				connection = yield new DBusConnection (stream, null, DBusConnectionFlags.NONE, null, cancellable);
 
@@ -185,6 +185,7 @@ namespace Frida.Fruity {
 		private Gee.Queue<Bytes>? pending_outgoing;
 
 		private Gee.Queue<Request> requests = new Gee.ArrayQueue<Request> ();
+		private bool requests_scheduled = false;
 		private unowned Thread<bool>? lwip_thread;
 
 		private LWIP.NetworkInterface handle;
@@ -283,6 +284,11 @@ namespace Frida.Fruity {
 			return new Ipv6UdpSocket (this);
 		}
 
+		public TcpListener create_tcp_listener (uint16 port) throws Error {
+			check_started ();
+			return new TcpListener (this, port);
+		}
+
 		public void handle_incoming_datagrams (Gee.Collection<Bytes> datagrams) throws Error {
 			check_started ();
 
@@ -361,26 +367,51 @@ namespace Frida.Fruity {
 		internal LWIP.ErrorCode perform_on_lwip_thread (owned WorkFunc work) {
 			var req = new Request ((owned) work);
 
-			if (Thread.self<bool> () == lwip_thread) {
+			if (Thread.self<bool> () == lwip_thread)
 				perform_request (req);
-			} else {
-				lock (requests)
-					requests.offer (req);
-				LWIP.Runtime.schedule (perform_next_request);
-			}
+			else
+				enqueue_request (req);
 
 			return req.join ();
 		}
 
-		private void perform_next_request () {
+		internal void post_to_lwip_thread (owned WorkFunc work) {
+			var req = new Request ((owned) work);
+
+			if (Thread.self<bool> () == lwip_thread)
+				perform_request (req);
+			else
+				enqueue_request (req);
+		}
+
+		private void enqueue_request (Request req) {
+			bool schedule_needed;
+			lock (requests) {
+				requests.offer (req);
+				schedule_needed = !requests_scheduled;
+				requests_scheduled = true;
+			}
+
+			if (schedule_needed)
+				LWIP.Runtime.schedule (perform_pending_requests);
+		}
+
+		private void perform_pending_requests () {
 			if (lwip_thread == null)
 				lwip_thread = Thread.self ();
 
-			Request req;
-			lock (requests)
-				req = requests.poll ();
+			while (true) {
+				Request? req;
+				lock (requests) {
+					req = requests.poll ();
+					if (req == null)
+						requests_scheduled = false;
+				}
+				if (req == null)
+					return;
 
-			perform_request (req);
+				perform_request (req);
+			}
 		}
 
 		private static void perform_request (Request req) {
@@ -445,10 +476,16 @@ namespace Frida.Fruity {
 			private Promise<bool> established = new Promise<bool> ();
 
 			private unowned LWIP.TcpPcb? pcb;
-			private ByteArray rx_buf = new ByteArray.sized (64 * 1024);
+			private Gee.Queue<RxSegment> rx_segments = new Gee.ArrayQueue<RxSegment> ();
+			private Gee.Queue<RxSegment> rx_spent = new Gee.ArrayQueue<RxSegment> ();
+			private size_t rx_unacknowledged = 0;
+			private bool rx_release_pending = false;
 			private bool tx_possible = false;
 			private bool tx_check_pending = false;
 
+			// Consumed bytes are handed back to lwIP in batches; anything below a full window cannot stall the peer.
+			private const size_t RX_WINDOW_UPDATE_THRESHOLD = LWIP.Tcp.WINDOW / 4;
+
 			public static async TcpConnection open (VirtualNetworkStack netstack, InetSocketAddress address,
 					Cancellable? cancellable) throws Error, IOError {
 				var connection = new TcpConnection (netstack, address);
@@ -466,6 +503,24 @@ namespace Frida.Fruity {
 				Object (netstack: netstack, address: address);
 			}
 
+			internal TcpConnection.accepted (VirtualNetworkStack netstack, LWIP.TcpPcb pcb) {
+				Object (
+					netstack: netstack,
+					address: ip6_address_to_inet_socket_address (pcb.remote_ip, pcb.remote_port)
+				);
+
+				attach_to_pcb (pcb);
+
+				tx_possible = true;
+				state = OPEN;
+				established.resolve (true);
+			}
+
+			construct {
+				// May be constructed on the lwIP thread when accepting, so always dispatch to the stack's context.
+				main_context = netstack.main_context;
+			}
+
 			public override void dispose () {
 				stop ();
 
@@ -479,7 +534,7 @@ namespace Frida.Fruity {
 			protected override IOCondition query_events () {
 				IOCondition new_events = 0;
 
-				if (rx_buf.len != 0 || state == CLOSED)
+				if (!rx_segments.is_empty || state == CLOSED)
 					new_events |= IN;
 
 				if (tx_possible)
@@ -502,7 +557,25 @@ namespace Frida.Fruity {
 			}
 
 			private void do_start () {
-				pcb = LWIP.TcpPcb.make (V6);
+				attach_to_pcb (LWIP.TcpPcb.make (V6));
+				pcb.bind_netif (&netstack.handle);
+
+				var err = pcb.connect (ip6_address_from_inet_socket_address (address), address.get_port (), (user_data, pcb, err) => {
+					TcpConnection * self = user_data;
+					if (self != null)
+						self->on_connect ();
+					return OK;
+				});
+				if (err != OK) {
+					schedule_on_frida_thread (() => {
+						established.reject (parse_error (err));
+						return Source.REMOVE;
+					});
+				}
+			}
+
+			private void attach_to_pcb (LWIP.TcpPcb new_pcb) {
+				pcb = new_pcb;
 				pcb.set_user_data (this);
 				pcb.set_recv_callback ((user_data, pcb, pbuf, err) => {
 					TcpConnection * self = user_data;
@@ -529,24 +602,16 @@ namespace Frida.Fruity {
 				});
 				pcb.set_flags (TIMESTAMP | SACK);
 				pcb.nagle_disable ();
-				pcb.bind_netif (&netstack.handle);
-
-				var err = pcb.connect (ip6_address_from_inet_socket_address (address), address.get_port (), (user_data, pcb, err) => {
-					TcpConnection * self = user_data;
-					if (self != null)
-						self->on_connect ();
-					return OK;
-				});
-				if (err != OK) {
-					schedule_on_frida_thread (() => {
-						established.reject (parse_error (err));
-						return Source.REMOVE;
-					});
-				}
 			}
 
 			private void stop () {
 				netstack.perform_on_lwip_thread (() => {
+					// pbufs must be returned to lwIP's pools on its own thread.
+					with_state_lock (() => {
+						rx_segments.clear ();
+						rx_spent.clear ();
+					});
+
 					if (pcb == null)
 						return OK;
 					pcb.set_user_data (null);
@@ -593,10 +658,9 @@ namespace Frida.Fruity {
 					return;
 				}
 
-				var buffer = new uint8[pbuf.tot_len];
-				unowned uint8[] chunk = pbuf.get_contiguous (buffer, pbuf.tot_len);
+				var segment = new RxSegment ((owned) pbuf);
 				with_state_lock (() => {
-					rx_buf.append (chunk[:pbuf.tot_len]);
+					rx_segments.offer (segment);
 					update_pending_io ();
 				});
 			}
@@ -667,32 +731,34 @@ namespace Frida.Fruity {
 
 			public override ssize_t read (uint8[] buffer) throws IOError {
 				ssize_t n = 0;
+				bool release_needed = false;
 
-				netstack.perform_on_lwip_thread (() => {
-					with_state_lock (() => {
-						n = ssize_t.min (buffer.length, rx_buf.len);
-						if (n == 0)
-							return;
-						Memory.copy (buffer, rx_buf.data, n);
-						rx_buf.remove_range (0, (uint) n);
-						update_pending_io ();
-					});
+				with_state_lock (() => {
+					RxSegment? segment;
+					while (n != buffer.length && (segment = rx_segments.peek ()) != null) {
+						uint16 chunk = (uint16) size_t.min (buffer.length - n, segment.remaining);
+						segment.pbuf.copy_partial (buffer[n:n + chunk], chunk, segment.offset);
+						segment.offset += chunk;
+						n += chunk;
+
+						if (segment.remaining == 0)
+							rx_spent.offer (rx_segments.poll ());
+					}
 					if (n == 0)
-						return OK;
+						return;
 
-					if (pcb == null)
-						return OK;
+					update_pending_io ();
 
-					size_t remainder = n;
-					while (remainder != 0) {
-						uint16 chunk = (uint16) size_t.min (remainder, uint16.MAX);
-						pcb.notify_received (chunk);
-						remainder -= chunk;
+					rx_unacknowledged += n;
+					if (rx_unacknowledged >= RX_WINDOW_UPDATE_THRESHOLD && !rx_release_pending) {
+						rx_release_pending = true;
+						release_needed = true;
 					}
-
-					return OK;
 				});
 
+				if (release_needed)
+					netstack.post_to_lwip_thread (release_consumed_rx);
+
 				if (n == 0) {
 					if (state == CLOSED)
 						return 0;
@@ -702,6 +768,33 @@ namespace Frida.Fruity {
 				return n;
 			}
 
+			private LWIP.ErrorCode release_consumed_rx () {
+				size_t consumed = 0;
+				var spent = new Gee.ArrayQueue<RxSegment> ();
+				with_state_lock (() => {
+					consumed = rx_unacknowledged;
+					rx_unacknowledged = 0;
+					rx_release_pending = false;
+
+					RxSegment? segment;
+					while ((segment = rx_spent.poll ()) != null)
+						spent.offer (segment);
+				});
+
+				spent.clear ();
+
+				if (pcb == null)
+					return OK;
+
+				while (consumed != 0) {
+					uint16 chunk = (uint16) size_t.min (consumed, uint16.MAX);
+					pcb.notify_received (chunk);
+					consumed -= chunk;
+				}
+
+				return OK;
+			}
+
 			public override ssize_t write (uint8[] buffer) throws IOError {
 				ssize_t n = 0;
 
@@ -771,6 +864,124 @@ namespace Frida.Fruity {
 				source.set_callback ((owned) function);
 				source.attach (main_context);
 			}
+
+			private class RxSegment {
+				public LWIP.PacketBuffer pbuf;
+				public uint16 offset = 0;
+
+				public uint16 remaining {
+					get {
+						return pbuf.tot_len - offset;
+					}
+				}
+
+				public RxSegment (owned LWIP.PacketBuffer pbuf) {
+					this.pbuf = (owned) pbuf;
+				}
+			}
+		}
+
+		public sealed class TcpListener : Object {
+			public InetSocketAddress local_address {
+				get;
+				construct;
+			}
+
+			private weak VirtualNetworkStack netstack;
+			private unowned LWIP.TcpPcb? pcb;
+			private Gee.Queue<TcpConnection> pending_connections = new Gee.ArrayQueue<TcpConnection> ();
+			private Gee.Queue<Promise<TcpConnection>> pending_accepts = new Gee.ArrayQueue<Promise<TcpConnection>> ();
+
+			private const uint8 BACKLOG = 16;
+
+			internal TcpListener (VirtualNetworkStack netstack, uint16 port) throws Error {
+				Object (local_address: ip6_address_to_inet_socket_address (netstack.raw_ipv6_address, port));
+
+				this.netstack = netstack;
+
+				check (netstack.perform_on_lwip_thread (() => {
+					unowned LWIP.TcpPcb? p = LWIP.TcpPcb.make (V6);
+					p.bind_netif (&netstack.handle);
+
+					var err = p.bind (netstack.raw_ipv6_address, port);
+					if (err != OK) {
+						p.close ();
+						return err;
+					}
+
+					pcb = p.listen (BACKLOG);
+					if (pcb == null) {
+						p.close ();
+						return MEM;
+					}
+					pcb.set_user_data (this);
+					pcb.set_accept_callback ((user_data, new_pcb, err) => {
+						TcpListener * self = user_data;
+						if (self == null || new_pcb == null || err != OK)
+							return ABRT;
+						self->on_accept (new_pcb);
+						return OK;
+					});
+
+					return OK;
+				}));
+			}
+
+			public override void dispose () {
+				close ();
+
+				base.dispose ();
+			}
+
+			public void close () {
+				if (netstack == null)
+					return;
+
+				netstack.perform_on_lwip_thread (() => {
+					if (pcb != null) {
+						pcb.set_user_data (null);
+						pcb.close ();
+						pcb = null;
+					}
+					return OK;
+				});
+				netstack = null;
+
+				Promise<TcpConnection>? promise;
+				while ((promise = pending_accepts.poll ()) != null)
+					promise.reject (new IOError.CLOSED ("Listener is closed"));
+				pending_connections.clear ();
+			}
+
+			public async IOStream accept (Cancellable? cancellable = null) throws Error, IOError {
+				if (netstack == null)
+					throw new Error.INVALID_OPERATION ("Listener is closed");
+
+				TcpConnection? connection = pending_connections.poll ();
+				if (connection != null)
+					return connection;
+
+				var promise = new Promise<TcpConnection> ();
+				pending_accepts.offer (promise);
+				try {
+					return yield promise.future.wait_async (cancellable);
+				} finally {
+					pending_accepts.remove (promise);
+				}
+			}
+
+			private void on_accept (LWIP.TcpPcb new_pcb) {
+				var connection = new TcpConnection.accepted (netstack, new_pcb);
+
+				netstack.schedule_on_frida_thread (() => {
+					Promise<TcpConnection>? promise = pending_accepts.poll ();
+					if (promise != null)
+						promise.resolve (connection);
+					else
+						pending_connections.offer (connection);
+					return Source.REMOVE;
+				});
+			}
 		}
 
 		private class Ipv6UdpSocket : Object, UdpSocket, DatagramBased {
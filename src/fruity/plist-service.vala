@@ -123,10 +123,12 @@ namespace Frida.Fruity {
 				Plist message;
 				try {
 					unowned string message_str = (string) message_buf;
-					if (message_str.has_prefix ("bplist"))
-						message = new Plist.from_binary (message_data);
-					else
+					if (message_str.has_prefix ("bplist")) {
+						var message_bytes = new Bytes.take ((owned) message_buf);
+						message = new Plist.from_binary_bytes (new Bytes.from_bytes (message_bytes, 0, message_size));
+					} else {
 						message = new Plist.from_xml (message_str);
+					}
 				} catch (PlistError e) {
 					throw new PlistServiceError.PROTOCOL ("Malformed message: %s", e.message);
 				}
@@ -13,6 +13,14 @@ namespace Frida.Fruity {
 			this.from_data (data, BINARY);
 		}
 
+		/*
+		 * Nested dicts and arrays are decoded on first access, and keep `bytes` alive until then. Large data values are
+		 * slices of `bytes`, so a plist outliving its input may pin up to twice the size of such values.
+		 */
+		public Plist.from_binary_bytes (Bytes bytes) throws PlistError {
+			BinaryObjectTable.load (bytes).fill_toplevel (this);
+		}
+
 		public Plist.from_xml (string xml) throws PlistError {
 			this.from_data (xml.data, XML);
 		}
@@ -27,8 +35,7 @@ namespace Frida.Fruity {
 				}
 			}
 			if (format == BINARY) {
-				var parser = new BinaryParser (this);
-				parser.parse (data);
+				BinaryObjectTable.load (new Bytes (data)).fill_toplevel (this);
 			} else if (format == XML) {
 				var parser = new XmlParser (this);
 				parser.parse ((string) data);
@@ -61,354 +68,431 @@ namespace Frida.Fruity {
 			return builder.str;
 		}
 
-		private class BinaryParser : Object {
-			public Plist plist {
-				get;
-				construct;
-			}
-
-			private DataInputStream input;
+		internal sealed class BinaryObjectTable {
+			private Bytes bytes;
+			private unowned uint8[] data;
 
 			private uint8 offset_size;
 			private uint8 object_ref_size;
+			private uint64 num_objects;
+			private uint64 top_object_ref;
 			private uint64 offset_table_offset;
 
-			private uint8 object_info;
+			private Value *[] memo;
+			private bool[] duplicate_keys;
 
+			private const size_t HEADER_SIZE = 8;
+			private const size_t TRAILER_SIZE = 32;
 			private const uint64 MAX_OBJECT_SIZE = 100 * 1024 * 1024;
 			private const uint64 MAX_OBJECT_COUNT = 32 * 1024;
+			private const uint MAX_DEPTH = 512;
+			private const double MIN_DATE = -63113904000.0;
+			private const double MAX_DATE = 252423993599.0;
 
-			public BinaryParser (Plist plist) {
-				Object (plist: plist);
-			}
-
-			public void parse (uint8[] data) throws PlistError {
-				unowned string magic = (string) data;
-				if (!magic.has_prefix ("bplist"))
-					throw new PlistError.INVALID_DATA ("Invalid binary plist");
+			private const uint8 UNVISITED = 0;
+			private const uint8 VISITING = 1;
+			private const uint8 VALIDATED = 2;
 
+			public static BinaryObjectTable load (Bytes bytes) throws PlistError {
 				try {
-					input = new DataInputStream (new MemoryInputStream.from_bytes (new Bytes.static (data)));
-					input.byte_order = BIG_ENDIAN;
-
-					input.seek (-26, END);
-					offset_size = input.read_byte ();
-					object_ref_size = input.read_byte ();
-					var num_objects = input.read_uint64 ();
-					if (num_objects > MAX_OBJECT_COUNT)
-						throw new PlistError.INVALID_DATA ("Too many objects");
-					var top_object_ref = input.read_uint64 ();
-					offset_table_offset = input.read_uint64 ();
-
-					var top_object = parse_object (top_object_ref);
-					if (!top_object.holds (typeof (PlistDict)))
-						throw new PlistError.INVALID_DATA ("Toplevel must be a dict");
-					plist.steal_all ((PlistDict) top_object.get_object ());
-				} catch (GLib.Error e) {
+					var table = new BinaryObjectTable (bytes);
+					table.validate ();
+					return table;
+				} catch (PlistError e) {
 					throw new PlistError.INVALID_DATA ("Invalid binary plist: %s", e.message);
 				}
 			}
 
-			private Value? parse_object (uint64 object_ref) throws GLib.Error {
-				Value? obj;
+			private BinaryObjectTable (Bytes bytes) throws PlistError {
+				this.bytes = bytes;
+				this.data = bytes.get_data ();
+
+				if (data.length < HEADER_SIZE + TRAILER_SIZE || Memory.cmp (data, "bplist", 6) != 0)
+					throw new PlistError.INVALID_DATA ("Bad header");
+
+				size_t trailer = data.length - 26;
+				offset_size = data[trailer];
+				object_ref_size = data[trailer + 1];
+				num_objects = read_uint (trailer + 2, 8);
+				top_object_ref = read_uint (trailer + 10, 8);
+				offset_table_offset = read_uint (trailer + 18, 8);
+
+				if (!is_valid_uint_size (offset_size) || !is_valid_uint_size (object_ref_size))
+					throw new PlistError.INVALID_DATA ("Unsupported offset or reference size");
+				if (num_objects == 0 || num_objects > MAX_OBJECT_COUNT)
+					throw new PlistError.INVALID_DATA ("Too many objects");
+				if (top_object_ref >= num_objects)
+					throw new PlistError.INVALID_DATA ("Toplevel reference out of range");
+				uint64 objects_end = data.length - TRAILER_SIZE;
+				if (offset_table_offset < HEADER_SIZE || offset_table_offset > objects_end ||
+						num_objects * offset_size > objects_end - offset_table_offset) {
+					throw new PlistError.INVALID_DATA ("Offset table out of range");
+				}
 
-				var previous_offset = input.tell ();
-				try {
-					seek_to_object (object_ref);
+				memo = new Value *[num_objects];
+			}
 
-					obj = read_value ();
-				} catch (GLib.Error e) {
-					input.seek (previous_offset, SET);
-					throw e;
+			~BinaryObjectTable () {
+				foreach (Value * v in memo) {
+					if (v != null)
+						free_value (v);
 				}
+			}
 
-				input.seek (previous_offset, SET);
+			public void fill_toplevel (Plist plist) throws PlistError {
+				if (lookup_header (top_object_ref).type != 0xd)
+					throw new PlistError.INVALID_DATA ("Toplevel must be a dict");
+				fill_dict (top_object_ref, plist);
+			}
 
-				return obj;
+			public void fill_dict (uint64 object_ref, PlistDict dict) {
+				var header = lookup_header (object_ref);
+				for (uint64 i = 0; i != header.length; i++) {
+					unowned string key = lookup_key (read_ref (header, i));
+					dict.set_raw_value (key, materialize (read_ref (header, header.length + i)));
+				}
 			}
 
-			private void seek_to_object (uint64 object_ref) throws GLib.Error {
-				input.seek ((int64) (offset_table_offset + (object_ref * offset_size)), SET);
-				var offset = read_offset ();
-				input.seek ((int64) offset, SET);
+			public void fill_array (uint64 object_ref, PlistArray array) {
+				var header = lookup_header (object_ref);
+				for (uint64 i = 0; i != header.length; i++)
+					array.add_raw_value (materialize (read_ref (header, i)));
 			}
 
-			private Value? read_value () throws GLib.Error {
-				uint8 marker = input.read_byte ();
-				uint8 object_type = (marker & 0xf0) >> 4;
-				object_info = marker & 0x0f;
+			public bool try_count_children (uint64 object_ref, out int count) {
+				if (duplicate_keys[object_ref]) {
+					count = -1;
+					return false;
+				}
+				count = (int) lookup_header (object_ref).length;
+				return true;
+			}
 
-				switch (object_type) {
-					case 0x0:
-						return read_constant ();
-					case 0x1:
-						return read_integer ();
-					case 0x2:
-						return read_real ();
+			private void validate () throws PlistError {
+				var states = new uint8[num_objects];
+				duplicate_keys = new bool[num_objects];
+				validate_object (top_object_ref, states, 0);
+			}
+
+			private void validate_object (uint64 object_ref, uint8[] states, uint depth) throws PlistError {
+				if (object_ref >= num_objects)
+					throw new PlistError.INVALID_DATA ("Object reference out of range");
+				switch (states[object_ref]) {
+					case VALIDATED:
+						return;
+					case VISITING:
+						throw new PlistError.INVALID_DATA ("Object graph contains a cycle");
+				}
+				if (depth == MAX_DEPTH)
+					throw new PlistError.INVALID_DATA ("Nesting too deep");
+
+				states[object_ref] = VISITING;
+
+				var header = read_header (object_ref);
+				switch (header.type) {
 					case 0x3:
-						return read_date ();
-					case 0x4:
-						return read_data ();
-					case 0x5:
-						return read_ascii_string ();
+						double point_in_time = read_double (header.body);
+						if (!(point_in_time >= MIN_DATE && point_in_time <= MAX_DATE))
+							throw new PlistError.INVALID_DATA ("Date out of range");
+						break;
 					case 0x6:
-						return read_utf16_string ();
-					case 0x8:
-						return read_uid ();
+						check_utf16 (header);
+						break;
 					case 0xa:
-						return read_array ();
+						for (uint64 i = 0; i != header.length; i++)
+							validate_object (read_ref (header, i), states, depth + 1);
+						break;
 					case 0xd:
-						return read_dict ();
-					default:
-						throw new PlistError.INVALID_DATA ("Unsupported object type: 0x%x", object_type);
+						var keys = new Gee.HashSet<string> ();
+						for (uint64 i = 0; i != header.length; i++) {
+							uint64 key_ref = read_ref (header, i);
+							validate_object (key_ref, states, depth + 1);
+							uint8 key_type = lookup_header (key_ref).type;
+							if (key_type != 0x5 && key_type != 0x6)
+								throw new PlistError.INVALID_DATA ("Dict keys must be strings, not type 0x%x", key_type);
+							if (!keys.add (lookup_key (key_ref)))
+								duplicate_keys[object_ref] = true;
+
+							validate_object (read_ref (header, header.length + i), states, depth + 1);
+						}
+						break;
+				}
+
+				states[object_ref] = VALIDATED;
+			}
+
+			private void check_utf16 (ObjectHeader header) throws PlistError {
+				for (uint64 i = 0; i != header.length; i++) {
+					var c = (uint16) read_uint ((size_t) (header.body + (i * 2)), 2);
+					if (c >= 0xd800 && c < 0xdc00) {
+						i++;
+						if (i == header.length)
+							throw new PlistError.INVALID_DATA ("Invalid UTF-16 string");
+						var next = (uint16) read_uint ((size_t) (header.body + (i * 2)), 2);
+						if (next < 0xdc00 || next >= 0xe000)
+							throw new PlistError.INVALID_DATA ("Invalid UTF-16 string");
+					} else if (c >= 0xdc00 && c < 0xe000) {
+						throw new PlistError.INVALID_DATA ("Invalid UTF-16 string");
+					}
 				}
 			}
 
-			private Value? read_constant () throws GLib.Error {
-				Value? gval;
+			private Value * materialize (uint64 object_ref) {
+				Value * shared_val = memo[object_ref];
+				if (shared_val != null)
+					return clone_value (shared_val);
 
-				switch (object_info) {
+				var header = lookup_header (object_ref);
+				Value * v;
+				switch (header.type) {
 					case 0x0:
-						gval = Value (typeof (PlistNull));
-						gval.take_object (new PlistNull ());
-						break;
-					case 0x8:
-					case 0x9:
-						gval = Value (typeof (bool));
-						gval.set_boolean (object_info == 0x9);
-						break;
+						if (header.info == 0x0) {
+							v = make_value (typeof (PlistNull));
+							v.take_object (new PlistNull ());
+						} else {
+							v = make_value (typeof (bool));
+							v.set_boolean (header.info == 0x9);
+						}
+						return v;
+					case 0x1:
+						v = make_value (typeof (int64));
+						v.set_int64 (read_integer (header));
+						return v;
+					case 0x2:
+						if (header.info == 2) {
+							v = make_value (typeof (float));
+							v.set_float (read_float (header.body));
+						} else {
+							v = make_value (typeof (double));
+							v.set_double (read_double (header.body));
+						}
+						return v;
+					case 0xa:
+						var array = new PlistArray ();
+						array.defer_to (this, object_ref);
+						v = make_value (typeof (PlistArray));
+						v.take_object (array);
+						return v;
+					case 0xd:
+						var dict = new PlistDict ();
+						dict.defer_to (this, object_ref);
+						v = make_value (typeof (PlistDict));
+						v.take_object (dict);
+						return v;
 					default:
-						throw new PlistError.INVALID_DATA ("Unsupported constant type: 0x%x", object_info);
+						shared_val = decode_shared (header);
+						memo[object_ref] = shared_val;
+						return clone_value (shared_val);
 				}
-
-				return gval;
 			}
 
-			private Value? read_integer () throws GLib.Error {
-				if (object_info > 4)
-					throw new PlistError.INVALID_DATA ("Integer too large");
-				uint size = 1 << object_info;
+			private unowned string lookup_key (uint64 object_ref) {
+				Value * v = memo[object_ref];
+				if (v == null) {
+					v = decode_shared (lookup_header (object_ref));
+					memo[object_ref] = v;
+				}
+				return v.get_string ();
+			}
 
-				int64 val;
-				switch (size) {
-					case 1:
-						val = input.read_byte ();
+			private Value * decode_shared (ObjectHeader header) {
+				Value * v;
+				switch (header.type) {
+					case 0x3:
+						v = make_value (typeof (PlistDate));
+						v.take_object (new PlistDate (read_date (header.body)));
 						break;
-					case 2:
-						val = input.read_uint16 ();
+					case 0x4:
+						size_t size = (size_t) header.length;
+						v = make_value (typeof (Bytes));
+						if (size >= data.length / 2)
+							v.take_boxed (new Bytes.from_bytes (bytes, header.body, size));
+						else
+							v.take_boxed (new Bytes (data[header.body:header.body + size]));
 						break;
-					case 4:
-						val = input.read_uint32 ();
+					case 0x5:
+						v = make_value (typeof (string));
+						v.take_string (((string) ((char *) data + header.body)).ndup ((size_t) header.length));
 						break;
-					case 8:
-						val = input.read_int64 ();
+					case 0x6:
+						v = make_value (typeof (string));
+						v.take_string (read_utf16_string (header));
+						break;
+					case 0x8:
+						v = make_value (typeof (PlistUid));
+						v.take_object (new PlistUid (read_uint (header.body, header.info + 1)));
 						break;
 					default:
-						throw new PlistError.INVALID_DATA ("Unsupported integer size: %u", size);
+						assert_not_reached ();
 				}
+				return v;
+			}
 
-				var gval = Value (typeof (int64));
-				gval.set_int64 (val);
-				return gval;
+			private ObjectHeader lookup_header (uint64 object_ref) {
+				try {
+					return read_header (object_ref);
+				} catch (PlistError e) {
+					assert_not_reached ();
+				}
 			}
 
-			private Value? read_real () throws GLib.Error {
-				Value? gval;
+			private ObjectHeader read_header (uint64 object_ref) throws PlistError {
+				size_t objects_end = (size_t) offset_table_offset;
 
-				switch (object_info) {
-					case 2:
-						gval = Value (typeof (float));
-						gval.set_float (read_float ());
+				uint64 offset = read_uint ((size_t) (offset_table_offset + (object_ref * offset_size)), offset_size);
+				if (offset < HEADER_SIZE || offset >= objects_end)
+					throw new PlistError.INVALID_DATA ("Object offset out of range");
+
+				uint8 marker = data[offset];
+
+				var header = ObjectHeader ();
+				header.type = marker >> 4;
+				header.info = marker & 0x0f;
+				header.body = (size_t) offset + 1;
+
+				uint64 size;
+				switch (header.type) {
+					case 0x0:
+						if (header.info != 0x0 && header.info != 0x8 && header.info != 0x9)
+							throw new PlistError.INVALID_DATA ("Unsupported constant type: 0x%x", header.info);
+						size = 0;
+						break;
+					case 0x1:
+						if (header.info > 3)
+							throw new PlistError.INVALID_DATA ("Unsupported integer size: %u", 1 << header.info);
+						size = 1 << header.info;
+						break;
+					case 0x2:
+						if (header.info != 2 && header.info != 3)
+							throw new PlistError.INVALID_DATA ("Unsupported number size: %u", 1 << header.info);
+						size = 1 << header.info;
+						break;
+					case 0x3:
+						size = 8;
+						break;
+					case 0x4:
+					case 0x5:
+						size = read_length (ref header);
+						break;
+					case 0x6:
+						size = read_length (ref header) * sizeof (uint16);
+						break;
+					case 0x8:
+						size = header.info + 1;
+						if (!is_valid_uint_size ((uint) size))
+							throw new PlistError.INVALID_DATA ("Unsupported uint size: %u", (uint) size);
 						break;
-					case 3:
-						gval = Value (typeof (double));
-						gval.set_double (read_double ());
+					case 0xa:
+						size = read_length (ref header) * object_ref_size;
+						break;
+					case 0xd:
+						size = read_length (ref header) * (2 * object_ref_size);
 						break;
 					default:
-						throw new PlistError.INVALID_DATA ("Unsupported number size: %u", 1 << object_info);
+						throw new PlistError.INVALID_DATA ("Unsupported object type: 0x%x", header.type);
 				}
 
-				return gval;
-			}
-
-			private float read_float () throws GLib.Error {
-				uint32 bits = input.read_uint32 ();
-				float * val = (float *) &bits;
-				return *val;
-			}
-
-			private double read_double () throws GLib.Error {
-				uint64 bits = input.read_uint64 ();
-				double * val = (double *) &bits;
-				return *val;
-			}
-
-			private Value? read_date () throws GLib.Error {
-				double point_in_time = read_double ();
-				int64 whole_seconds = (int64) point_in_time;
-				var val = new DateTime.from_unix_utc (MAC_EPOCH_DELTA_FROM_UNIX + whole_seconds)
-					.add_seconds (point_in_time - (double) whole_seconds);
+				check_object_size (size);
+				if (size > objects_end - header.body)
+					throw new PlistError.INVALID_DATA ("Object extends beyond the object area");
 
-				var gval = Value (typeof (PlistDate));
-				gval.take_object (new PlistDate (val));
-				return gval;
+				return header;
 			}
 
-			private Value? read_data () throws GLib.Error {
-				uint64 length = object_info;
-				if (object_info == 0xf)
-					length = read_length ();
-				check_object_size (length);
+			private uint64 read_length (ref ObjectHeader header) throws PlistError {
+				if (header.info != 0xf) {
+					header.length = header.info;
+					return header.length;
+				}
 
-				var buf = new uint8[length];
-				size_t bytes_read;
-				input.read_all (buf, out bytes_read);
+				size_t objects_end = (size_t) offset_table_offset;
+				if (header.body == objects_end)
+					throw new PlistError.INVALID_DATA ("Truncated length");
 
-				var gval = Value (typeof (Bytes));
-				gval.take_boxed (new Bytes.take ((owned) buf));
-				return gval;
-			}
+				uint8 marker = data[header.body];
+				if ((marker >> 4) != 0x1)
+					throw new PlistError.INVALID_DATA ("Length must be an integer");
+				uint8 info = marker & 0x0f;
+				if (info > 3)
+					throw new PlistError.INVALID_DATA ("Integer too large");
+				uint size = 1 << info;
+				if (size >= objects_end - header.body)
+					throw new PlistError.INVALID_DATA ("Truncated length");
 
-			private Value? read_ascii_string () throws GLib.Error {
-				uint64 length = object_info;
-				if (object_info == 0xf)
-					length = read_length ();
+				uint64 length = read_uint (header.body + 1, size);
+				if (size == 8 && (int64) length < 0)
+					throw new PlistError.INVALID_DATA ("Length must be positive");
 				check_object_size (length);
 
-				var str_buf = new uint8[length + 1];
-				str_buf[length] = 0;
-				size_t bytes_read;
-				input.read_all (str_buf[0:length], out bytes_read);
-
-				unowned string str = (string) str_buf;
+				header.length = length;
+				header.body += 1 + size;
 
-				var gval = Value (typeof (string));
-				gval.set_string (str);
-				return gval;
+				return length;
 			}
 
-			private Value? read_utf16_string () throws GLib.Error {
-				uint64 length = object_info;
-				if (object_info == 0xf)
-					length = read_length ();
-				uint64 size = length * sizeof (uint16);
-				check_object_size (size);
-
-				var str_chars = new uint16[length + 1];
-				str_chars[length] = 0;
-				unowned uint8[] str_buf = (uint8[]) str_chars;
-				size_t bytes_read;
-				input.read_all (str_buf[0:size], out bytes_read);
-
-				for (uint64 i = 0; i != length; i++)
-					str_chars[i] = uint16.from_big_endian (str_chars[i]);
-
-				unowned string16 str = (string16) str_chars;
-
-				var gval = Value (typeof (string));
-				gval.set_string (str.to_utf8 ());
-				return gval;
+			private uint64 read_ref (ObjectHeader header, uint64 index) {
+				return read_uint ((size_t) (header.body + (index * object_ref_size)), object_ref_size);
 			}
 
-			private Value? read_uid () throws GLib.Error {
-				uint64 val = read_uint_of_size (object_info + 1);
-
-				var gval = Value (typeof (PlistUid));
-				gval.take_object (new PlistUid (val));
-				return gval;
+			private int64 read_integer (ObjectHeader header) {
+				return (int64) read_uint (header.body, 1 << header.info);
 			}
 
-			private Value? read_array () throws GLib.Error {
-				uint64 length = object_info;
-				if (object_info == 0xf)
-					length = read_length ();
-				check_object_size (length * object_ref_size);
-
-				var element_refs = new uint64[length];
-				for (uint64 i = 0; i != length; i++)
-					element_refs[i] = read_ref ();
-
-				var array = new PlistArray ();
-
-				for (uint64 i = 0; i != length; i++) {
-					var element = parse_object (element_refs[i]);
-					array.add_value (element);
-				}
-
-				var gval = Value (typeof (PlistArray));
-				gval.set_object (array);
-				return gval;
+			private DateTime read_date (size_t offset) {
+				double point_in_time = read_double (offset);
+				int64 whole_seconds = (int64) point_in_time;
+				return new DateTime.from_unix_utc (MAC_EPOCH_DELTA_FROM_UNIX + whole_seconds)
+					.add_seconds (point_in_time - (double) whole_seconds);
 			}
 
-			private Value? read_dict () throws GLib.Error {
-				uint64 length = object_info;
-				if (object_info == 0xf)
-					length = read_length ();
-				check_object_size (length * (2 * object_ref_size));
-
-				var key_refs = new uint64[length];
-				var val_refs = new uint64[length];
-				for (uint64 i = 0; i != length; i++)
-					key_refs[i] = read_ref ();
-				for (uint64 i = 0; i != length; i++)
-					val_refs[i] = read_ref ();
-
-				var dict = new PlistDict ();
+			private string read_utf16_string (ObjectHeader header) {
+				var chars = new uint16[header.length + 1];
+				for (uint64 i = 0; i != header.length; i++)
+					chars[i] = (uint16) read_uint ((size_t) (header.body + (i * 2)), 2);
+				chars[header.length] = 0;
 
-				for (uint64 i = 0; i != length; i++) {
-					var key = parse_object (key_refs[i]);
-					var val = parse_object (val_refs[i]);
-
-					if (!key.holds (typeof (string)))
-						throw new PlistError.INVALID_DATA ("Dict keys must be strings, not %s", key.type_name ());
-
-					dict.set_value (key.get_string (), (owned) val);
+				unowned string16 str = (string16) chars;
+				try {
+					return str.to_utf8 ();
+				} catch (ConvertError e) {
+					assert_not_reached ();
 				}
-
-				var gval = Value (typeof (PlistDict));
-				gval.set_object (dict);
-				return gval;
 			}
 
-			private uint64 read_offset () throws GLib.Error {
-				return read_uint_of_size (offset_size);
+			private float read_float (size_t offset) {
+				uint32 bits = (uint32) read_uint (offset, 4);
+				float * val = (float *) &bits;
+				return *val;
 			}
 
-			private uint64 read_ref () throws GLib.Error {
-				return read_uint_of_size (object_ref_size);
+			private double read_double (size_t offset) {
+				uint64 bits = read_uint (offset, 8);
+				double * val = (double *) &bits;
+				return *val;
 			}
 
-			private uint64 read_length () throws GLib.Error {
-				var val = read_value ();
-				if (!val.holds (typeof (int64)))
-					throw new PlistError.INVALID_DATA ("Length must be an integer");
-
-				int64 length = val.get_int64 ();
-				if (length < 0)
-					throw new PlistError.INVALID_DATA ("Length must be positive");
-
-				return length;
+			private uint64 read_uint (size_t offset, uint size) {
+				uint64 val = 0;
+				for (uint i = 0; i != size; i++)
+					val = (val << 8) | data[offset + i];
+				return val;
 			}
 
-			private uint64 read_uint_of_size (uint size) throws GLib.Error {
-				switch (size) {
-					case 1:
-						return input.read_byte ();
-					case 2:
-						return input.read_uint16 ();
-					case 4:
-						return input.read_uint32 ();
-					case 8:
-						return input.read_uint64 ();
-					default:
-						throw new PlistError.INVALID_DATA ("Unsupported uint size: %u", size);
-				}
+			private static bool is_valid_uint_size (uint size) {
+				return size == 1 || size == 2 || size == 4 || size == 8;
 			}
 
-			private void check_object_size (uint64 size) throws PlistError {
+			private static void check_object_size (uint64 size) throws PlistError {
 				if (size > MAX_OBJECT_SIZE)
 					throw new PlistError.INVALID_DATA ("Object too large");
 			}
+
+			private struct ObjectHeader {
+				public uint8 type;
+				public uint8 info;
+				public uint64 length;
+				public size_t body;
+			}
 		}
 
 		private class BinaryWriter {
@@ -1184,12 +1268,15 @@ namespace Frida.Fruity {
 	public class PlistDict : Object {
 		public bool is_empty {
 			get {
-				return storage.is_empty;
+				return size == 0;
 			}
 		}
 
 		public int size {
 			get {
+				int count;
+				if (pending_table != null && pending_table.try_count_children (pending_ref, out count))
+					return count;
 				return storage.size;
 			}
 		}
@@ -1212,10 +1299,30 @@ namespace Frida.Fruity {
 			}
 		}
 
-		private Gee.HashMap<string, Value *> storage = new Gee.HashMap<string, Value *> ();
+		private Gee.HashMap<string, Value *> storage {
+			get {
+				if (pending_table != null)
+					materialize ();
+				return _storage;
+			}
+		}
+
+		private Gee.HashMap<string, Value *> _storage = new Gee.HashMap<string, Value *> ();
+		private Plist.BinaryObjectTable? pending_table;
+		private uint64 pending_ref;
 
 		~PlistDict () {
-			storage.values.foreach (free_value);
+			_storage.values.foreach (free_value);
+		}
+
+		internal void defer_to (Plist.BinaryObjectTable table, uint64 object_ref) {
+			pending_table = table;
+			pending_ref = object_ref;
+		}
+
+		private void materialize () {
+			Plist.BinaryObjectTable table = (owned) pending_table;
+			table.fill_dict (pending_ref, this);
 		}
 
 		public PlistDict clone () {
@@ -1368,12 +1475,15 @@ namespace Frida.Fruity {
 	public sealed class PlistArray : Object {
 		public bool is_empty {
 			get {
-				return storage.is_empty;
+				return length == 0;
 			}
 		}
 
 		public int length {
 			get {
+				int count;
+				if (pending_table != null && pending_table.try_count_children (pending_ref, out count))
+					return count;
 				return storage.size;
 			}
 		}
@@ -1384,10 +1494,30 @@ namespace Frida.Fruity {
 			}
 		}
 
-		private Gee.ArrayList<Value *> storage = new Gee.ArrayList<Value *> ();
+		private Gee.ArrayList<Value *> storage {
+			get {
+				if (pending_table != null)
+					materialize ();
+				return _storage;
+			}
+		}
+
+		private Gee.ArrayList<Value *> _storage = new Gee.ArrayList<Value *> ();
+		private Plist.BinaryObjectTable? pending_table;
+		private uint64 pending_ref;
 
 		~PlistArray () {
-			storage.foreach (free_value);
+			_storage.foreach (free_value);
+		}
+
+		internal void defer_to (Plist.BinaryObjectTable table, uint64 object_ref) {
+			pending_table = table;
+			pending_ref = object_ref;
+		}
+
+		private void materialize () {
+			Plist.BinaryObjectTable table = (owned) pending_table;
+			table.fill_array (pending_ref, this);
 		}
 
 		public void clear () {
@@ -1515,6 +1645,10 @@ namespace Frida.Fruity {
 			storage.add (v);
 		}
 
+		internal void add_raw_value (Value * val) {
+			storage.add (val);
+		}
+
 		private void check_index (int index) throws PlistError {
 			if (index < 0 || index >= storage.size)
 				throw new PlistError.INVALID_INDEX ("Array element does not exist");
@@ -387,7 +387,7 @@ namespace Frida.Fruity {
 
 				Plist kvs;
 				try {
-					kvs = new Plist.from_binary (response.read_member ("deviceKVSData").get_data_value ().get_data ());
+					kvs = new Plist.from_binary_bytes (response.read_member ("deviceKVSData").get_data_value ());
 					response.end_member ();
 				} catch (PlistError e) {
 					throw new Error.PROTOCOL ("%s", e.message);
@@ -45,6 +45,30 @@ namespace Frida.GDB {
 			}
 		}
 
+		public bool memory_cache_enabled {
+			get {
+				return _memory_cache_enabled;
+			}
+		}
+
+		public bool has_ram_regions {
+			get {
+				return !ram_regions.is_empty;
+			}
+		}
+
+		public uint64 memory_cache_hits {
+			get {
+				return _memory_cache_hits;
+			}
+		}
+
+		public uint64 memory_cache_misses {
+			get {
+				return _memory_cache_misses;
+			}
+		}
+
 		private DataInputStream input;
 		private OutputStream output;
 		private Cancellable io_cancellable = new Cancellable ();
@@ -58,6 +82,17 @@ namespace Frida.GDB {
 		private Gee.Queue<Bytes> pending_writes = new Gee.ArrayQueue<Bytes> ();
 		private Promise<uint>? write_request;
 		private Gee.Queue<PendingResponse> pending_responses = new Gee.ArrayQueue<PendingResponse> ();
+		private FeatureSupport binary_transfer = UNKNOWN;
+		private bool _memory_cache_enabled = false;
+		private Gee.Map<uint64?, Bytes> cached_pages = new Gee.HashMap<uint64?, Bytes> (
+			(n) => { return int64_hash ((int64?) n); },
+			(a, b) => { return int64_equal ((int64?) a, (int64?) b); }
+		);
+		private Gee.Queue<uint64?> cached_page_order = new Gee.ArrayQueue<uint64?> ();
+		private uint64 memory_cache_generation = 0;
+		private Gee.List<RamRegion> ram_regions = new Gee.ArrayList<RamRegion> ();
+		private uint64 _memory_cache_hits = 0;
+		private uint64 _memory_cache_misses = 0;
 
 		protected Gee.Set<string> supported_features = new Gee.HashSet<string> ();
 		protected Gee.List<Register>? registers;
@@ -93,6 +128,18 @@ namespace Frida.GDB {
 			ZEROED
 		}
 
+		private enum FeatureSupport {
+			UNKNOWN,
+			SUPPORTED,
+			UNSUPPORTED
+		}
+
+		private const uint MAX_READS_IN_FLIGHT = 8;
+
+		private const uint64 CACHE_PAGE_SIZE = 4096;
+		private const uint MAX_CACHED_PAGES = 1024;
+		private const size_t MAX_CACHED_READ_SIZE = 64 * CACHE_PAGE_SIZE;
+
 		protected const char NOTIFICATION_TYPE_EXIT_STATUS = 'W';
 		protected const char NOTIFICATION_TYPE_EXIT_SIGNAL = 'X';
 		protected const char NOTIFICATION_TYPE_STOP = 'S';
@@ -143,6 +190,8 @@ namespace Frida.GDB {
 
 				string supported_response = yield query_property ("Supported", cancellable);
 				supported_features.add_all_array (supported_response.split (";"));
+				if ("binary-upload+" in supported_features)
+					binary_transfer = SUPPORTED;
 
 				foreach (string feature in supported_features) {
 					if (feature.has_prefix ("PacketSize=")) {
@@ -201,6 +250,9 @@ namespace Frida.GDB {
 		}
 
 		private void change_state (State new_state, Exception? new_exception = null) {
+			if (new_state != STOPPED)
+				invalidate_memory_cache ();
+
 			bool state_differs = new_state != _state;
 			if (state_differs)
 				_state = new_state;
@@ -378,6 +430,8 @@ namespace Frida.GDB {
 		public void restart () throws Error {
 			check_stopped ();
 
+			invalidate_memory_cache ();
+
 			var command = make_packet_builder_sized (5)
 				.append ("R")
 				.build ();
@@ -423,37 +477,225 @@ namespace Frida.GDB {
 
 		public virtual async Bytes read_byte_array (uint64 address, size_t size, Cancellable? cancellable = null)
 				throws Error, IOError {
+			bool cacheable = _memory_cache_enabled && size != 0 && size <= MAX_CACHED_READ_SIZE &&
+				address + size > address;
+			if (!cacheable)
+				return yield fetch_byte_array (address, size, cancellable);
+
+			uint64 first_page = address & ~(CACHE_PAGE_SIZE - 1);
+			uint64 last_page = (address + size - 1) & ~(CACHE_PAGE_SIZE - 1);
+			if (!is_ram (first_page, last_page + CACHE_PAGE_SIZE))
+				return yield fetch_byte_array (address, size, cancellable);
+			uint n_pages = (uint) (((last_page - first_page) / CACHE_PAGE_SIZE) + 1);
+			uint64 generation = memory_cache_generation;
+
+			var pages = new Bytes[n_pages];
+			uint i = 0;
+			while (i != n_pages) {
+				uint64 page = first_page + (i * CACHE_PAGE_SIZE);
+				Bytes? cached = cached_pages[page];
+				if (cached != null) {
+					pages[i++] = cached;
+					_memory_cache_hits++;
+					continue;
+				}
+
+				uint run_length = 1;
+				while (i + run_length != n_pages && !cached_pages.has_key (page + (run_length * CACHE_PAGE_SIZE)))
+					run_length++;
+
+				Bytes run;
+				try {
+					run = yield fetch_byte_array (page, run_length * (size_t) CACHE_PAGE_SIZE, cancellable);
+				} catch (Error e) {
+					// Part of the surrounding page may not be readable, e.g. an MMIO window; read exactly what was asked.
+					return yield fetch_byte_array (address, size, cancellable);
+				}
+				_memory_cache_misses += run_length;
+
+				bool still_valid = memory_cache_generation == generation;
+				for (uint j = 0; j != run_length; j++) {
+					var data = new Bytes.from_bytes (run, j * (size_t) CACHE_PAGE_SIZE, (size_t) CACHE_PAGE_SIZE);
+					if (still_valid)
+						store_cached_page (page + (j * CACHE_PAGE_SIZE), data);
+					pages[i++] = data;
+				}
+			}
+
+			size_t offset_in_first_page = (size_t) (address - first_page);
+			if (n_pages == 1)
+				return new Bytes.from_bytes (pages[0], offset_in_first_page, size);
+
 			var result = new uint8[size];
+			size_t copied = 0;
+			for (i = 0; i != n_pages; i++) {
+				size_t start = (i == 0) ? offset_in_first_page : 0;
+				size_t n = size_t.min ((size_t) CACHE_PAGE_SIZE - start, size - copied);
+				Memory.copy ((uint8 *) result + copied, (uint8 *) pages[i].get_data () + start, n);
+				copied += n;
+			}
+			return new Bytes.take ((owned) result);
+		}
 
-			size_t offset = 0;
-			size_t max_bytes_per_packet = (max_packet_size - Packet.OVERHEAD) / 2;
-			do {
-				size_t chunk_size = size_t.min (size - offset, max_bytes_per_packet);
-
-				var request = make_packet_builder_sized (16)
-					.append_c ('m')
-					.append_address (address + offset)
-					.append_c (',')
-					.append_size (chunk_size)
-					.build ();
-				var response = yield query (request, cancellable);
-
-				Bytes chunk = Protocol.parse_hex_bytes (response.payload);
-				if (chunk.get_size () != chunk_size) {
-					throw new Error.INVALID_ARGUMENT (
-						"Unable to read from 0x%" + uint64.FORMAT_MODIFIER + "x: invalid address", address);
+		private void store_cached_page (uint64 page, Bytes data) {
+			if (cached_pages.size == MAX_CACHED_PAGES) {
+				uint64? oldest = cached_page_order.poll ();
+				cached_pages.unset (oldest);
+			}
+			cached_pages[page] = data;
+			cached_page_order.offer (page);
+		}
+
+		public async void enable_memory_cache (Cancellable? cancellable = null) throws Error, IOError {
+			if (_memory_cache_enabled)
+				return;
+
+			if ("qXfer:memory-map:read+" in supported_features) {
+				string xml = yield fetch_xfer_document ("memory-map", "", cancellable);
+				foreach (var region in RamRegion.parse_memory_map (xml))
+					ram_regions.add (region);
+			}
+
+			_memory_cache_enabled = true;
+		}
+
+		public void disable_memory_cache () {
+			_memory_cache_enabled = false;
+			invalidate_memory_cache ();
+		}
+
+		public void add_ram_region (uint64 address, uint64 size) {
+			ram_regions.add (new RamRegion (address, address + size));
+		}
+
+		private bool is_ram (uint64 start, uint64 end) {
+			foreach (var region in ram_regions) {
+				if (start >= region.start && end <= region.end)
+					return true;
+			}
+			return false;
+		}
+
+		public void invalidate_memory_cache () {
+			memory_cache_generation++;
+
+			if (cached_pages.is_empty)
+				return;
+			cached_pages.clear ();
+			cached_page_order.clear ();
+		}
+
+		private static bool request_may_change_memory (Bytes request) {
+			unowned uint8[] data = request.get_data ();
+			if (data.length < 2 || data[0] != PACKET_CHARACTER)
+				return true;
+
+			switch (data[1]) {
+				case 'm':
+				case 'x':
+				case 'g':
+				case 'p':
+				case 'H':
+				case 'T':
+					return false;
+				case 'q':
+					return request_has_prefix (data, "$qRcmd,");
+				default:
+					return true;
+			}
+		}
+
+		private static bool request_has_prefix (uint8[] data, string prefix) {
+			return data.length >= prefix.length && Memory.cmp (data, prefix, prefix.length) == 0;
+		}
+
+		private async Bytes fetch_byte_array (uint64 address, size_t size, Cancellable? cancellable) throws Error, IOError {
+			var result = new uint8[size];
+			if (size == 0)
+				return new Bytes.take ((owned) result);
+
+			bool binary = binary_transfer == SUPPORTED;
+			size_t max_bytes_per_packet = binary
+				? max_packet_size - 1 - Packet.OVERHEAD
+				: (max_packet_size - Packet.OVERHEAD) / 2;
+
+			// Replies come back in request order, so we only need to keep the link busy once acks are out of the way.
+			uint window = (ack_mode == SKIP_ACKS) ? MAX_READS_IN_FLIGHT : 1;
+			var in_flight = new Gee.ArrayQueue<PendingRead> ();
+			size_t next_offset = 0;
+
+			while (next_offset != size || !in_flight.is_empty) {
+				while (next_offset != size && in_flight.size != window) {
+					size_t chunk_size = size_t.min (size - next_offset, max_bytes_per_packet);
+					in_flight.offer (begin_read (address, next_offset, chunk_size, binary, cancellable));
+					next_offset += chunk_size;
 				}
 
-				Memory.copy ((uint8 *) result + offset, chunk.get_data (), chunk_size);
+				PendingRead read = in_flight.poll ();
+				Packet response = yield read.response.wait_async (cancellable);
 
-				offset += chunk_size;
-			} while (offset != size);
+				size_t n;
+				if (binary) {
+					unowned uint8[] payload = response.payload_bytes.get_data ();
+					if (payload.length < 2 || payload[0] != 'b') {
+						throw new Error.INVALID_ARGUMENT (
+							"Unable to read from 0x%" + uint64.FORMAT_MODIFIER + "x: invalid address",
+							address + read.offset);
+					}
+					n = size_t.min (payload.length - 1, read.size);
+					Memory.copy ((uint8 *) result + read.offset, (uint8 *) payload + 1, n);
+				} else {
+					Bytes chunk = Protocol.parse_hex_bytes (response.payload);
+					if (chunk.get_size () != read.size) {
+						throw new Error.INVALID_ARGUMENT (
+							"Unable to read from 0x%" + uint64.FORMAT_MODIFIER + "x: invalid address",
+							address + read.offset);
+					}
+					n = read.size;
+					Memory.copy ((uint8 *) result + read.offset, chunk.get_data (), n);
+				}
+
+				// Binary replies may come up short when escaping would overflow the packet; ask for the rest.
+				if (n != read.size)
+					in_flight.offer (begin_read (address, read.offset + n, read.size - n, binary, cancellable));
+			}
 
 			return new Bytes.take ((owned) result);
 		}
 
+		private PendingRead begin_read (uint64 address, size_t offset, size_t size, bool binary, Cancellable? cancellable) {
+			var request = make_packet_builder_sized (16)
+				.append_c (binary ? 'x' : 'm')
+				.append_address (address + offset)
+				.append_c (',')
+				.append_size (size)
+				.build ();
+
+			var read = new PendingRead (offset, size);
+			perform_query.begin (request, cancellable, read.promise);
+			return read;
+		}
+
+		private class PendingRead {
+			public size_t offset;
+			public size_t size;
+			public Promise<Packet> promise = new Promise<Packet> ();
+
+			public Future<Packet> response {
+				get {
+					return promise.future;
+				}
+			}
+
+			public PendingRead (size_t offset, size_t size) {
+				this.offset = offset;
+				this.size = size;
+			}
+		}
+
 		public async void write_byte_array (uint64 address, Bytes bytes, Cancellable? cancellable = null)
 				throws Error, IOError {
+			// Worst case every byte needs escaping, which costs as much as hex.
 			size_t max_bytes_per_packet = (max_packet_size - 1 - 16 - 1 - 8 - 1 - Packet.OVERHEAD) / 2;
 
 			var data = bytes.get_data ();
@@ -466,21 +708,41 @@ namespace Frida.GDB {
 				uint64 slice_address = address + offset;
 				size_t slice_size = size_t.min (remaining, max_bytes_per_packet);
 
-				builder
-					.append_c ('M')
-					.append_address (slice_address)
-					.append_c (',')
-					.append_size (slice_size)
-					.append_c (':');
-
-				for (size_t i = 0; i != slice_size; i++) {
-					uint8 byte = data[offset + i];
-					builder.append_hexbyte (byte);
-				}
+				if (binary_transfer != UNSUPPORTED) {
+					builder
+						.append_c ('X')
+						.append_address (slice_address)
+						.append_c (',')
+						.append_size (slice_size)
+						.append_c (':');
+					for (size_t i = 0; i != slice_size; i++)
+						builder.append_c ((char) data[offset + i]);
+
+					Packet response = yield query (builder.build (), cancellable);
+					builder.reset ();
+
+					if (response.payload_bytes.get_size () == 0) {
+						binary_transfer = UNSUPPORTED;
+						continue;
+					}
+					check_execute_response (response);
+				} else {
+					builder
+						.append_c ('M')
+						.append_address (slice_address)
+						.append_c (',')
+						.append_size (slice_size)
+						.append_c (':');
+
+					for (size_t i = 0; i != slice_size; i++) {
+						uint8 byte = data[offset + i];
+						builder.append_hexbyte (byte);
+					}
 
-				yield execute (builder.build (), cancellable);
+					yield execute (builder.build (), cancellable);
 
-				builder.reset ();
+					builder.reset ();
+				}
 
 				offset += slice_size;
 				remaining -= slice_size;
@@ -638,18 +900,25 @@ namespace Frida.GDB {
 
 		private async FeatureDocument fetch_feature_document (string name, uint next_regnum, Cancellable? cancellable)
 				throws Error, IOError {
+			string xml = yield fetch_xfer_document ("features", name, cancellable);
+			return FeatureDocument.from_xml (xml, next_regnum);
+		}
+
+		private async string fetch_xfer_document (string object_name, string annex, Cancellable? cancellable)
+				throws Error, IOError {
 			var xml = new StringBuilder.sized (4096);
 
 			uint offset = 0;
 			char status = 'l';
 			do {
-				var response = yield query_simple ("qXfer:features:read:%s:%x,1ffff".printf (name, offset), cancellable);
+				var response = yield query_simple ("qXfer:%s:read:%s:%x,1ffff".printf (object_name, annex, offset),
+					cancellable);
 
 				string payload = response.payload;
 				if (payload.length == 0)
-					throw new Error.NOT_SUPPORTED ("Feature query not supported by the remote stub");
+					throw new Error.NOT_SUPPORTED ("Transfer of '%s' not supported by the remote stub", object_name);
 				if (payload[0] == 'E')
-					throw new Error.INVALID_ARGUMENT ("Feature document '%s' not found", name);
+					throw new Error.INVALID_ARGUMENT ("Document '%s' not found", (annex != "") ? annex : object_name);
 
 				status = payload[0];
 
@@ -658,7 +927,7 @@ namespace Frida.GDB {
 				offset += chunk->length;
 			} while (status == 'm');
 
-			return FeatureDocument.from_xml (xml.str, next_regnum);
+			return xml.str;
 		}
 
 		private static uint infer_pointer_size_from_arch (TargetArch arch) {
@@ -729,6 +998,14 @@ namespace Frida.GDB {
 			check_execute_response (response);
 		}
 
+		private async void perform_query (Bytes request, Cancellable? cancellable, Promise<Packet> promise) {
+			try {
+				promise.resolve (yield query (request, cancellable));
+			} catch (GLib.Error e) {
+				promise.reject (e);
+			}
+		}
+
 		public async void perform_execute (Bytes command, Cancellable? cancellable, Promise<bool> request) throws Error, IOError {
 			try {
 				yield execute (command, cancellable);
@@ -778,6 +1055,10 @@ namespace Frida.GDB {
 			if (state == CLOSED)
 				throw new Error.INVALID_OPERATION ("Unable to perform query; connection is closed");
 
+			// Raw commands like breakpoint insertion or physical memory mode switches change what memory reads return.
+			if (request_may_change_memory (request))
+				invalidate_memory_cache ();
+
 			var pending = new PendingResponse ((owned) predicate, query_with_predicate.callback);
 			pending_responses.offer (pending);
 
@@ -1392,6 +1673,76 @@ namespace Frida.GDB {
 			}
 		}
 
+		private class RamRegion {
+			public uint64 start;
+			public uint64 end;
+
+			public RamRegion (uint64 start, uint64 end) {
+				this.start = start;
+				this.end = end;
+			}
+
+			public static Gee.List<RamRegion> parse_memory_map (string xml) throws Error {
+				var regions = new Gee.ArrayList<RamRegion> ();
+
+				var parser = new Parser (regions);
+				parser.parse (xml);
+
+				return regions;
+			}
+
+			private class Parser {
+				private Gee.List<RamRegion> regions;
+
+				private const MarkupParser CALLBACKS = {
+					on_start_element,
+					null,
+					null,
+					null,
+					null
+				};
+
+				public Parser (Gee.List<RamRegion> regions) {
+					this.regions = regions;
+				}
+
+				public void parse (string xml) throws Error {
+					try {
+						var context = new MarkupParseContext (CALLBACKS, 0, this, null);
+						context.parse (xml, -1);
+					} catch (MarkupError e) {
+						throw new Error.PROTOCOL ("%s", e.message);
+					}
+				}
+
+				private void on_start_element (MarkupParseContext context, string element_name, string[] attribute_names,
+						string[] attribute_values) throws MarkupError {
+					if (element_name != "memory")
+						return;
+
+					string? type = null;
+					uint64 start = 0;
+					uint64 length = 0;
+					uint i = 0;
+					foreach (unowned string attribute_name in attribute_names) {
+						unowned string val = attribute_values[i];
+
+						if (attribute_name == "type")
+							type = val;
+						else if (attribute_name == "start")
+							start = uint64.parse (val, 16);
+						else if (attribute_name == "length")
+							length = uint64.parse (val, 16);
+
+						i++;
+					}
+
+					if (type == "ram" && length != 0)
+						regions.add (new RamRegion (start, start + length));
+				}
+			}
+		}
+
 		private class FeatureDocument {
 			public TargetArch arch = UNKNOWN;
 
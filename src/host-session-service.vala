@@ -379,6 +379,16 @@ namespace Frida {
 			}
 		}
 
+		/*
+		 * Whether to offer agents a shared-memory ring for their message batches when linking sessions. Control traffic
+		 * stays on D-Bus, and agents that can't take part simply keep using it for everything. Only supported on Linux.
+		 */
+		public bool enable_message_ring {
+			get;
+			set;
+			default = false;
+		}
+
 		private Gee.HashMap<uint, Cancellable> pending_establish_ops = new Gee.HashMap<uint, Cancellable> ();
 
 		private Gee.HashMap<uint, Future<AgentEntry>> agent_entries = new Gee.HashMap<uint, Future<AgentEntry>> ();
@@ -630,6 +640,7 @@ namespace Frida {
 					IOStream stream = yield stream_request.wait_async (io_cancellable);
 
 					uint controller_registration_id;
+					int64 handshake_start = get_monotonic_time ();
 					try {
 						connection = yield new DBusConnection (stream, ServerGuid.HOST_SESSION_SERVICE,
 							AUTHENTICATION_SERVER | AUTHENTICATION_ALLOW_ANONYMOUS | DELAY_MESSAGE_PROCESSING,
@@ -648,6 +659,7 @@ namespace Frida {
 						else
 							throw new Error.PROCESS_NOT_RESPONDING ("%s", e.message);
 					}
+					record_attach_phase (pid, "dbus-handshake", handshake_start);
 
 					entry = new AgentEntry (pid, transport, connection, provider, controller_registration_id);
 				}
@@ -701,6 +713,9 @@ namespace Frida {
 			uninjected (InjectorPayloadId (id));
 		}
 
+		protected virtual void record_attach_phase (uint pid, string name, int64 start_time) {
+		}
+
 		protected abstract async Future<IOStream> perform_attach_to (uint pid, HashTable<string, Variant> options,
 			Cancellable? cancellable, out Object? transport) throws Error, IOError;
 
@@ -761,12 +776,60 @@ namespace Frida {
 				assert_not_reached ();
 			}
 
+#if LINUX
+			if (enable_message_ring)
+				entry.ring_reader = yield try_open_message_ring (connection, id, sink, cancellable);
+#endif
+
 			return session;
 		}
 
+#if LINUX
+		private async MessageRingReader? try_open_message_ring (DBusConnection connection, AgentSessionId id,
+				AgentMessageSink sink, Cancellable? cancellable) throws IOError {
+			if ((connection.get_capabilities () & DBusCapabilityFlags.UNIX_FD_PASSING) == 0 ||
+					!MemoryFileDescriptor.is_supported ()) {
+				return null;
+			}
+
+			try {
+				var ring = MessageRing.create ();
+
+				MessageRingProvider provider = yield connection.get_proxy (null, ObjectPath.MESSAGE_RING_PROVIDER,
+					DO_NOT_LOAD_PROPERTIES, cancellable);
+				yield provider.open_message_ring (id,
+					new UnixInputStream (ring.memfd.handle, false),
+					new UnixInputStream (ring.data_event.handle, false),
+					new UnixInputStream (ring.space_event.handle, false),
+					cancellable);
+
+				return new MessageRingReader (ring, sink);
+			} catch (GLib.Error e) {
+				if (e is IOError.CANCELLED)
+					throw (IOError) e;
+				return null;
+			}
+		}
+
+		public bool is_using_message_ring (AgentSessionId id) {
+			AgentSessionEntry? entry = agent_sessions[id];
+			return entry != null && entry.ring_reader != null && !entry.ring_reader.ring.closed;
+		}
+#endif
+
 		public void unlink_agent_session (AgentSessionId id) {
 			AgentSessionEntry? entry = agent_sessions[id];
-			if (entry == null || entry.sink_registration_id == 0)
+			if (entry == null)
+				return;
+
+#if LINUX
+			if (entry.ring_reader != null) {
+				entry.ring_reader.close ();
+				entry.ring_reader = null;
+			}
+#endif
+
+			if (entry.sink_registration_id == 0)
 				return;
 
 			entry.connection.unregister_object (entry.sink_registration_id);
@@ -1334,11 +1397,23 @@ namespace Frida {
 				set;
 			}
 
+#if LINUX
+			public MessageRingReader? ring_reader {
+				get;
+				set;
+			}
+#endif
+
 			public AgentSessionEntry (DBusConnection connection) {
 				this.connection = connection;
 			}
 
 			~AgentSessionEntry () {
+#if LINUX
+				if (ring_reader != null)
+					ring_reader.close ();
+#endif
+
 				if (sink_registration_id != 0)
 					connection.unregister_object (sink_registration_id);
 			}
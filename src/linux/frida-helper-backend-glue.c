@@ -1,6 +1,12 @@
 #include "frida-helper-backend.h"
 
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
 #include <sys/syscall.h>
+#include <sys/wait.h>
+
+#define FRIDA_CHILD_WATCH_MAX_POLL_INTERVAL 10
 
 gboolean
 _frida_syscall_satisfies (gint syscall_id, FridaLinuxSyscall mask)
@@ -89,3 +95,54 @@ _frida_syscall_satisfies (gint syscall_id, FridaLinuxSyscall mask)
 
   return FALSE;
 }
+
+gboolean
+_frida_await_child_state_change (guint pid, gint wakeup_fd, gint * cancelled)
+{
+  gboolean changed = FALSE;
+  int pidfd = -1;
+  guint interval = 1;
+
+  /*
+   * Ptrace stops are only announced through SIGCHLD, which belongs to the host process, so we check for them with
+   * WNOHANG and back off between checks. Exits wake us right away through the pidfd, and cancellation through the
+   * wakeup fd.
+   */
+#ifdef __NR_pidfd_open
+  pidfd = syscall (__NR_pidfd_open, pid, 0);
+#endif
+
+  while (!g_atomic_int_get (cancelled))
+  {
+    siginfo_t info;
+    struct pollfd fds[2];
+    int res;
+
+    info.si_pid = 0;
+    res = waitid (P_PID, pid, &info, WEXITED | WSTOPPED | WNOWAIT | WNOHANG | __WALL);
+    if (res == -1 && errno == EINTR)
+      continue;
+    if (res == -1 || info.si_pid != 0)
+    {
+      changed = TRUE;
+      break;
+    }
+
+    fds[0].fd = wakeup_fd;
+    fds[0].events = POLLIN;
+    fds[0].revents = 0;
+    fds[1].fd = pidfd;
+    fds[1].events = POLLIN;
+    fds[1].revents = 0;
+
+    if (poll (fds, (pidfd != -1) ? 2 : 1, interval) > 0 && (fds[0].revents & POLLIN) != 0)
+      break;
+
+    interval = MIN (interval * 2, FRIDA_CHILD_WATCH_MAX_POLL_INTERVAL);
+  }
+
+  if (pidfd != -1)
+    close (pidfd);
+
+  return changed;
+}
@@ -14,8 +14,12 @@ namespace Frida {
 		private Gee.Map<uint, PausedSyscallSession> paused_syscalls = new Gee.HashMap<uint, PausedSyscallSession> ();
 		private Gee.Map<uint, RemoteAgent> agents = new Gee.HashMap<uint, RemoteAgent> ();
 		private Gee.Map<uint, Source> agent_expiries = new Gee.HashMap<uint, Source> ();
+		private Gee.Map<uint, InjectionTimelineRecorder> timelines = new Gee.HashMap<uint, InjectionTimelineRecorder> ();
+		private Gee.Queue<uint> timeline_ids = new Gee.ArrayQueue<uint> ();
 		private Gee.Map<uint, Gee.Queue<TaskEntry>> task_queues = new Gee.HashMap<uint, Gee.Queue<TaskEntry>> ();
 
+		private const uint MAX_TIMELINES = 64;
+
 		public async void close (Cancellable? cancellable) throws IOError {
 			if (!is_idle) {
 				var idle_handler = idle.connect (() => {
@@ -29,6 +33,11 @@ namespace Frida {
 				p.close ();
 		}
 
+		public async void prewarm (Cancellable? cancellable) throws Error, IOError {
+			// Runs InjectSession's static construct, which resolves our own libc's mmap/munmap offsets and the fallback ld.
+			typeof (InjectSession).class_ref ();
+		}
+
 		public async uint spawn (string path, HostSpawnOptions options, Cancellable? cancellable) throws Error, IOError {
 			if (!FileUtils.test (path, EXISTS))
 				throw new Error.EXECUTABLE_NOT_FOUND ("Unable to find executable at '%s'", path);
@@ -294,8 +303,28 @@ namespace Frida {
 				AgentFeatures features, uint id, Cancellable? cancellable) throws Error, IOError {
 			var spec = new InjectSpec (library_so, entrypoint, data, features, id);
 			var task = new InjectTask (this, spec);
-			RemoteAgent agent = yield perform (task, pid, cancellable);
-			take_agent (agent);
+			try {
+				RemoteAgent agent = yield perform (task, pid, cancellable);
+				take_agent (agent);
+			} finally {
+				remember_timeline (id, spec.timeline);
+			}
+		}
+
+		public async InjectionPhaseInfo[] query_injection_timeline (uint id, Cancellable? cancellable) throws Error, IOError {
+			InjectionTimelineRecorder? timeline = timelines[id];
+			if (timeline == null)
+				throw new Error.INVALID_ARGUMENT ("Invalid ID");
+			return timeline.to_array ();
+		}
+
+		private void remember_timeline (uint id, InjectionTimelineRecorder timeline) {
+			if (!timelines.has_key (id))
+				timeline_ids.offer (id);
+			timelines[id] = timeline;
+
+			while (timeline_ids.size > MAX_TIMELINES)
+				timelines.unset (timeline_ids.poll ());
 		}
 
 		private class InjectTask : Object, Task<RemoteAgent> {
@@ -308,10 +337,12 @@ namespace Frida {
 			}
 
 			public async RemoteAgent run (uint pid, Cancellable? cancellable) throws Error, IOError {
+				int64 start_time = get_monotonic_time ();
 				PausedSyscallSession? pss = backend.paused_syscalls[pid];
 				if (pss != null)
 					yield pss.interrupt (cancellable);
 				var session = yield InjectSession.open (pid, cancellable);
+				spec.timeline.record ("seize", start_time);
 				RemoteAgent agent = yield session.inject (spec, cancellable);
 				session.close ();
 				return agent;
@@ -812,7 +843,8 @@ namespace Frida {
 		static construct {
 			var libc = Gum.Process.get_libc_module ();
 			uint local_pid = Posix.getpid ();
-			local_libc = ProcMapsSoEntry.find_by_path (local_pid, libc.path);
+			var local_maps = ProcMaps.for_pid (local_pid);
+			local_libc = local_maps.find_so_by_path (libc.path);
 			assert (local_libc != null);
 			mmap_offset = (uint64) (uintptr) libc.find_export_by_name ("mmap") - local_libc.base_address;
 			munmap_offset = (uint64) (uintptr) libc.find_export_by_name ("munmap") - local_libc.base_address;
@@ -833,10 +865,13 @@ namespace Frida {
 			}
 
 #if ANDROID
-			local_android_ld = ProcMapsSoEntry.find_by_path (local_pid, fallback_ld);
+			local_android_ld = local_maps.find_so_by_path (fallback_ld);
 #endif
 		}
 
+		private ProcMaps? remote_maps;
+		private uint remote_maps_generation;
+
 		private InjectSession (uint pid) {
 			Object (pid: pid);
 		}
@@ -857,10 +892,13 @@ namespace Frida {
 			string fallback_address = make_fallback_address ();
 			LoaderLayout loader_layout = compute_loader_layout (spec, fallback_address);
 
-			BootstrapResult bootstrap_result = yield bootstrap (loader_layout.size, cancellable);
+			int64 start_time = get_monotonic_time ();
+			BootstrapResult bootstrap_result = yield bootstrap (loader_layout.size, spec.timeline, cancellable);
 			uint64 loader_base = (uintptr) bootstrap_result.context.allocation_base;
+			spec.timeline.record ("bootstrap", start_time);
 
 			try {
+				start_time = get_monotonic_time ();
 				unowned uint8[] loader_code = Frida.Data.HelperBackend.get_loader_bin_blob ().data;
 				write_memory (loader_base, loader_code);
 				maybe_fixup_helper_code (loader_base, loader_code);
@@ -876,6 +914,7 @@ namespace Frida {
 				write_memory_string (loader_base + loader_layout.agent_entrypoint_offset, spec.entrypoint);
 				write_memory_string (loader_base + loader_layout.agent_data_offset, spec.data);
 				write_memory_string (loader_base + loader_layout.fallback_address_offset, fallback_address);
+				spec.timeline.record ("write-loader", start_time);
 
 				return yield launch_loader (FROM_SCRATCH, spec, bootstrap_result, null, fallback_address, loader_layout,
 					cancellable);
@@ -972,6 +1011,7 @@ namespace Frida {
 			Future<RemoteAgent> future_agent =
 				establish_connection (launch, spec, bres, agent_ctrl, fallback_address, cancellable);
 
+			int64 start_time = get_monotonic_time ();
 			uint64 loader_base = (uintptr) bres.context.allocation_base;
 			GPRegs regs = saved_regs;
 			regs.stack_pointer = bres.allocated_stack.stack_root;
@@ -993,7 +1033,9 @@ namespace Frida {
 						loader_result.regs.to_string ());
 				}
 			}
+			spec.timeline.record ("run-loader", start_time);
 
+			start_time = get_monotonic_time ();
 			var establish_cancellable = new Cancellable ();
 			var main_context = MainContext.get_thread_default ();
 
@@ -1023,11 +1065,13 @@ namespace Frida {
 			}
 
 			agent.ack ();
+			spec.timeline.record ("handshake", start_time);
 
 			return agent;
 		}
 
-		private async BootstrapResult bootstrap (size_t loader_size, Cancellable? cancellable) throws Error, IOError {
+		private async BootstrapResult bootstrap (size_t loader_size, InjectionTimelineRecorder timeline, Cancellable? cancellable)
+				throws Error, IOError {
 			var result = new BootstrapResult ();
 
 			unowned uint8[] bootstrapper_code = Frida.Data.HelperBackend.get_bootstrapper_bin_blob ().data;
@@ -1040,7 +1084,7 @@ namespace Frida {
 
 			uint64 remote_mmap = 0;
 			uint64 remote_munmap = 0;
-			ProcMapsSoEntry? remote_libc = ProcMapsSoEntry.find_by_path (pid, local_libc.path);
+			ProcMapsSoEntry? remote_libc = query_remote_maps ().find_so_by_path (local_libc.path);
 #if ANDROID
 			bool same_libc = false;
 			if (remote_libc != null) {
@@ -1057,11 +1101,12 @@ namespace Frida {
 				remote_munmap = remote_libc.base_address + munmap_offset;
 			}
 
+			int64 start_time = get_monotonic_time ();
 			if (remote_mmap != 0) {
 				allocation_base = yield allocate_memory (remote_mmap, allocation_size,
 					Posix.PROT_READ | Posix.PROT_WRITE | Posix.PROT_EXEC, cancellable);
 			} else {
-				var code_swap = yield new ProcessCodeSwapScope (this, bootstrapper_code, cancellable);
+				var code_swap = yield new ProcessCodeSwapScope (this, bootstrapper_code, timeline, cancellable);
 				uint64 code_start = code_swap.code_start;
 				uint64 code_end = code_start + bootstrapper_size;
 				maybe_fixup_helper_code (code_start, bootstrapper_code);
@@ -1088,6 +1133,7 @@ namespace Frida {
 				allocation_base = (uintptr) bootstrap_ctx.allocation_base;
 				code_swap.revert ();
 			}
+			timeline.record ("allocate", start_time);
 
 			result.allocated_stack.stack_base = (void *) (allocation_base + allocation_size - stack_size);
 			result.allocated_stack.stack_size = stack_size;
@@ -1143,16 +1189,17 @@ namespace Frida {
 					if (!(bootstrap_result.status == COMPLETED && (status == SUCCESS || status == TOO_EARLY)))
 						throw_bootstrap_error (bootstrap_result, status, code_start, code_end);
 
-					uint8[] output_context = read_memory (bootstrap_ctx_location, sizeof (HelperBootstrapContext));
-					Memory.copy (&result.context, output_context, output_context.length);
-
-					uint8[] output_libc = read_memory (libc_api_location, sizeof (HelperLibcApi));
-					Memory.copy (&result.libc, output_libc, output_libc.length);
+					uint8[] output = read_memory_ranges ({
+						RemoteMemoryRange (bootstrap_ctx_location, sizeof (HelperBootstrapContext)),
+						RemoteMemoryRange (libc_api_location, sizeof (HelperLibcApi)),
+					});
+					Memory.copy (&result.context, output, sizeof (HelperBootstrapContext));
+					Memory.copy (&result.libc, (uint8 *) output + sizeof (HelperBootstrapContext), sizeof (HelperLibcApi));
 
 					result.context.libc = &result.libc;
 
 					if (result.context.rtld_flavor == ANDROID && result.libc.dlopen == null) {
-						ProcMapsSoEntry? remote_ld = ProcMapsSoEntry.find_by_address (pid, (uintptr) result.context.rtld_base);
+						ProcMapsSoEntry? remote_ld = query_remote_maps ().find_so_by_address ((uintptr) result.context.rtld_base);
 						bool same_ld = remote_ld != null && local_android_ld != null && remote_ld.identity == local_android_ld.identity;
 						if (!same_ld)
 							throw new Error.NOT_SUPPORTED ("Unable to locate Android dynamic linker; please file a bug");
@@ -1207,6 +1254,14 @@ namespace Frida {
 			return (void *) (remote_module.base_address + offset);
 		}
 
+		private ProcMaps query_remote_maps () {
+			if (remote_maps == null || remote_maps_generation != stop_generation) {
+				remote_maps = ProcMaps.for_pid (pid);
+				remote_maps_generation = stop_generation;
+			}
+			return remote_maps;
+		}
+
 		private static string make_fallback_address () {
 			return "/frida-" + Uuid.string_random ();
 		}
@@ -1335,12 +1390,18 @@ namespace Frida {
 			private set;
 		}
 
+		public InjectionTimelineRecorder timeline {
+			get;
+			private set;
+		}
+
 		public InjectSpec (FileDescriptorBased library_so, string entrypoint, string data, AgentFeatures features, uint id) {
 			this.library_so = library_so;
 			this.entrypoint = entrypoint;
 			this.data = data;
 			this.features = features;
 			this.id = id;
+			this.timeline = new InjectionTimelineRecorder ();
 		}
 
 		public InjectSpec clone (uint clone_id, AgentFeatures features) {
@@ -1800,20 +1861,42 @@ namespace Frida {
 			}
 		}
 
+		public MemoryBackend memory_backend {
+			get;
+			set;
+			default = AUTO;
+		}
+
 		public enum InitBehavior {
 			INTERRUPT,
 			CONTINUE
 		}
 
+		public enum MemoryBackend {
+			AUTO,
+			PROC_MEM,
+			PTRACE
+		}
+
 		private AttachState attach_state = ALREADY_ATTACHED;
 		private uint _tid;
 		protected GPRegs saved_regs;
+		protected uint stop_generation = 0;
+		private FileDescriptor? mem_fd;
+		private bool vectored_io_denied = false;
 
 		private static bool seize_supported;
 		private static bool regset_supported = true;
 		protected static ProcessVmIoFunc? process_vm_readv;
 		protected static ProcessVmIoFunc? process_vm_writev;
 
+		private const int MAX_IOVECS_PER_CALL = 1024;
+
+		private enum TransferDirection {
+			READ,
+			WRITE
+		}
+
 		[CCode (has_target = false)]
 		protected delegate ssize_t ProcessVmIoFunc (uint pid,
 			[CCode (array_length_type = "unsigned long")]
@@ -1831,6 +1914,10 @@ namespace Frida {
 			}
 		}
 
+		public static bool supports_seize () {
+			return seize_supported;
+		}
+
 		public override void constructed () {
 			if (_tid == 0)
 				_tid = pid;
@@ -1902,6 +1989,8 @@ namespace Frida {
 		}
 
 		public void close () throws Error {
+			mem_fd = null;
+
 			if (attach_state == ATTACHED) {
 				ptrace (DETACH, tid);
 				attach_state = ALREADY_ATTACHED;
@@ -2006,14 +2095,17 @@ namespace Frida {
 		}
 
 		public async void wait_for_signal (Posix.Signal sig, Cancellable? cancellable) throws Error, IOError {
+			stop_generation++;
 			yield ChildProcess.wait_for_signal (tid, sig, cancellable);
 		}
 
 		public async Posix.Signal wait_for_signals (Posix.Signal[] sigs, Cancellable? cancellable) throws Error, IOError {
+			stop_generation++;
 			return yield ChildProcess.wait_for_signals (tid, sigs, cancellable);
 		}
 
 		public async Posix.Signal wait_for_next_signal (Cancellable? cancellable) throws Error, IOError {
+			stop_generation++;
 			return yield ChildProcess.wait_for_next_signal (tid, cancellable);
 		}
 
@@ -2121,77 +2213,169 @@ namespace Frida {
 		}
 
 		public uint8[] read_memory (uint64 address, size_t size) throws Error {
-			if (size == 0)
+			return read_memory_ranges ({ RemoteMemoryRange (address, size) });
+		}
+
+		public uint8[] read_memory_ranges (RemoteMemoryRange[] ranges) throws Error {
+			size_t total_size = 0;
+			foreach (var r in ranges)
+				total_size += r.size;
+			if (total_size == 0)
 				return {};
 
-			var result = new uint8[size];
+			var result = new uint8[total_size];
+			transfer_ranges (ranges, result, READ);
+			return result;
+		}
 
-			if (process_vm_readv != null) {
-				var local = Posix.iovector ();
-				local.iov_base = result;
-				local.iov_len = result.length;
+		public void write_memory (uint64 address, uint8[] data) throws Error {
+			write_memory_ranges ({ RemoteMemoryRange (address, data.length) }, data);
+		}
 
-				var remote = Posix.iovector ();
-				remote.iov_base = (void *) address;
-				remote.iov_len = size;
+		public void write_memory_ranges (RemoteMemoryRange[] ranges, uint8[] data) throws Error {
+			size_t total_size = 0;
+			foreach (var r in ranges)
+				total_size += r.size;
+			assert (data.length == total_size);
+			if (total_size == 0)
+				return;
 
-				ssize_t res = process_vm_readv (pid, (Posix.iovector[]) &local, (Posix.iovector[]) &remote, 0);
-				if (res != -1)
-					return result;
-				if (errno == Posix.ENOSYS)
-					process_vm_readv = null;
-				else if (errno != Posix.EPERM && errno != Posix.EFAULT)
-					throw new Error.NOT_SUPPORTED ("Unable to read from process memory: %s", strerror (errno));
-			}
+			transfer_ranges (ranges, data, WRITE);
+		}
 
-			size_t offset = 0;
-			uint bytes_per_word = (uint) sizeof (size_t);
-			while (offset != size) {
-				size_t word = (size_t) ptrace (PEEKDATA, tid, (void *) (address + offset));
-				size_t chunk_size = size_t.min (size - offset, bytes_per_word);
-				Memory.copy ((uint8 *) result + offset, &word, chunk_size);
+		private void transfer_ranges (RemoteMemoryRange[] ranges, uint8[] buffer, TransferDirection direction) throws Error {
+			int n = ranges.length;
+			int i = 0;
+			size_t range_offset = 0;
+			size_t buffer_offset = 0;
 
-				offset += chunk_size;
-			}
+			while (i != n) {
+				if (ranges[i].size == 0) {
+					i++;
+					continue;
+				}
 
-			return result;
-		}
+				ProcessVmIoFunc? vectored_io = (direction == READ) ? process_vm_readv : process_vm_writev;
+#if !(X86 || X86_64)
+				if (direction == WRITE)
+					vectored_io = null;
+#endif
+				if (vectored_io_denied || memory_backend != AUTO)
+					vectored_io = null;
+				if (vectored_io != null) {
+					int capacity = int.min (n - i, MAX_IOVECS_PER_CALL);
+					var local = new Posix.iovector[capacity];
+					var remote = new Posix.iovector[capacity];
+					int n_iovecs = 0;
+					size_t offset = buffer_offset;
+					size_t skip = range_offset;
+					for (int j = i; j != n && n_iovecs != capacity; j++) {
+						size_t size = ranges[j].size - skip;
+						if (size == 0)
+							continue;
+						local[n_iovecs].iov_base = (uint8 *) buffer + offset;
+						local[n_iovecs].iov_len = size;
+						remote[n_iovecs].iov_base = (void *) (ranges[j].address + skip);
+						remote[n_iovecs].iov_len = size;
+						n_iovecs++;
+						offset += size;
+						skip = 0;
+					}
 
-		public void write_memory (uint64 address, uint8[] data) throws Error {
-			if (data.length == 0)
-				return;
+					ssize_t res = vectored_io (pid, local[:n_iovecs], remote[:n_iovecs], 0);
+					if (res > 0) {
+						size_t remaining = (size_t) res;
+						while (remaining != 0) {
+							size_t available = ranges[i].size - range_offset;
+							size_t chunk = size_t.min (available, remaining);
+							range_offset += chunk;
+							buffer_offset += chunk;
+							remaining -= chunk;
+							if (range_offset == ranges[i].size) {
+								i++;
+								range_offset = 0;
+							}
+						}
+						continue;
+					}
 
-#if X86 || X86_64
-			if (process_vm_writev != null) {
-				var local = Posix.iovector ();
-				local.iov_base = data;
-				local.iov_len = data.length;
+					if (res == -1) {
+						if (errno == Posix.ENOSYS) {
+							if (direction == READ)
+								process_vm_readv = null;
+							else
+								process_vm_writev = null;
+						} else if (errno == Posix.EPERM) {
+							vectored_io_denied = true;
+						} else if (errno != Posix.EFAULT) {
+							throw new Error.NOT_SUPPORTED ("Unable to %s process memory: %s",
+								(direction == READ) ? "read from" : "write to", strerror (errno));
+						}
+					}
+				}
 
-				var remote = Posix.iovector ();
-				remote.iov_base = (void *) address;
-				remote.iov_len = data.length;
+				size_t size = ranges[i].size - range_offset;
+				unowned uint8[] chunk = buffer[buffer_offset:buffer_offset + size];
+				uint64 address = ranges[i].address + range_offset;
+				bool transferred = memory_backend != PTRACE && transfer_via_proc_mem (address, chunk, direction);
+				if (!transferred) {
+					if (memory_backend == PROC_MEM) {
+						throw new Error.NOT_SUPPORTED ("Unable to %s process memory through /proc",
+							(direction == READ) ? "read from" : "write to");
+					}
+					transfer_via_ptrace (address, chunk, direction);
+				}
 
-				ssize_t res = process_vm_writev (pid, (Posix.iovector[]) &local, (Posix.iovector[]) &remote, 0);
-				if (res != -1)
-					return;
-				if (errno == Posix.ENOSYS)
-					process_vm_writev = null;
-				else if (errno != Posix.EPERM && errno != Posix.EFAULT)
-					throw new Error.NOT_SUPPORTED ("Unable to write to process memory: %s", strerror (errno));
+				buffer_offset += size;
+				range_offset = 0;
+				i++;
+			}
+		}
+
+		private bool transfer_via_proc_mem (uint64 address, uint8[] chunk, TransferDirection direction) {
+			if (mem_fd == null) {
+				int fd = Posix.open ("/proc/%u/mem".printf (pid), Posix.O_RDWR | Posix.O_CLOEXEC);
+				if (fd == -1)
+					return false;
+				mem_fd = new FileDescriptor (fd);
 			}
-#endif
 
 			size_t offset = 0;
-			size_t size = data.length;
+			size_t size = chunk.length;
+			while (offset != size) {
+				void * buf = (uint8 *) chunk + offset;
+				Posix.off_t position = (Posix.off_t) (address + offset);
+				ssize_t res = (direction == READ)
+					? Posix.pread (mem_fd.handle, buf, size - offset, position)
+					: Posix.pwrite (mem_fd.handle, buf, size - offset, position);
+				if (res == -1 && errno == Posix.EINTR)
+					continue;
+				if (res <= 0)
+					return false;
+				offset += (size_t) res;
+			}
+
+			return true;
+		}
+
+		private void transfer_via_ptrace (uint64 address, uint8[] chunk, TransferDirection direction) throws Error {
+			size_t offset = 0;
+			size_t size = chunk.length;
 			uint bytes_per_word = (uint) sizeof (size_t);
 			while (offset != size) {
-				size_t word = 0;
 				size_t chunk_size = size_t.min (size - offset, bytes_per_word);
-				if (chunk_size < bytes_per_word)
-					word = (size_t) ptrace (PEEKDATA, tid, (void *) (address + offset));
-				Memory.copy (&word, (uint8 *) data + offset, chunk_size);
 
-				ptrace (POKEDATA, tid, (void *) (address + offset), (void *) word);
+				if (direction == READ) {
+					size_t word = (size_t) ptrace (PEEKDATA, tid, (void *) (address + offset));
+					Memory.copy ((uint8 *) chunk + offset, &word, chunk_size);
+				} else {
+					size_t word = 0;
+					if (chunk_size < bytes_per_word)
+						word = (size_t) ptrace (PEEKDATA, tid, (void *) (address + offset));
+					Memory.copy (&word, (uint8 *) chunk + offset, chunk_size);
+
+					ptrace (POKEDATA, tid, (void *) (address + offset), (void *) word);
+				}
 
 				offset += chunk_size;
 			}
@@ -2228,6 +2412,16 @@ namespace Frida {
 		ALREADY_ATTACHED,
 	}
 
+	protected struct RemoteMemoryRange {
+		public uint64 address;
+		public size_t size;
+
+		public RemoteMemoryRange (uint64 address, size_t size) {
+			this.address = address;
+			this.size = size;
+		}
+	}
+
 	private sealed class ProcessCodeSwapScope {
 		private State state = INACTIVE;
 
@@ -2242,7 +2436,8 @@ namespace Frida {
 			ACTIVE
 		}
 
-		public async ProcessCodeSwapScope (SeizeSession session, uint8[] code, Cancellable? cancellable) throws Error, IOError {
+		public async ProcessCodeSwapScope (SeizeSession session, uint8[] code, InjectionTimelineRecorder timeline,
+				Cancellable? cancellable) throws Error, IOError {
 			this.session = session;
 
 			Gum.Linux.enumerate_ranges ((Posix.pid_t) session.pid, READ | EXECUTE, d => {
@@ -2258,9 +2453,11 @@ namespace Frida {
 			if (code_start == 0)
 				throw new Error.NOT_SUPPORTED ("Unable to find suitable code pages");
 
-			thread_suspend_scope = new ThreadSuspendScope (session.pid);
+			int64 start_time = get_monotonic_time ();
+			thread_suspend_scope = new ThreadSuspendScope (session.pid, timeline);
 			thread_suspend_scope.exclude (session.tid);
 			yield thread_suspend_scope.enable (cancellable);
+			timeline.record ("suspend-threads", start_time);
 
 			original_code = session.read_memory (code_start, code.length);
 			session.write_memory (code_start, code);
@@ -2285,12 +2482,14 @@ namespace Frida {
 		}
 	}
 
-	private sealed class ThreadSuspendScope {
+	protected sealed class ThreadSuspendScope {
 		private State state = INACTIVE;
 
 		private uint pid;
+		private InjectionTimelineRecorder? timeline;
 		private Gee.Set<uint> excluded_tids = new Gee.HashSet<uint> ();
 		private Gee.List<SeizeSession> suspended = new Gee.ArrayList<SeizeSession> ();
+		private Gee.List<uint> seized_tids = new Gee.ArrayList<uint> ();
 
 		private enum State {
 			INACTIVE,
@@ -2299,8 +2498,9 @@ namespace Frida {
 
 		private delegate void CompletionNotify ();
 
-		public ThreadSuspendScope (uint pid) throws Error {
+		public ThreadSuspendScope (uint pid, InjectionTimelineRecorder? timeline = null) throws Error {
 			this.pid = pid;
+			this.timeline = timeline;
 		}
 
 		public void exclude (uint tid) {
@@ -2312,13 +2512,148 @@ namespace Frida {
 			assert (state == INACTIVE);
 			state = ACTIVE;
 
+			if (SeizeSession.supports_seize ()) {
+				try {
+					yield enable_batched (cancellable);
+				} catch (GLib.Error e) {
+					foreach (uint tid in seized_tids)
+						detach_thread (tid);
+					seized_tids.clear ();
+					state = INACTIVE;
+					throw_api_error (e);
+				}
+			} else {
+				yield enable_one_by_one (cancellable);
+			}
+		}
+
+		/*
+		 * Seizes and interrupts every newly discovered thread up front, then collects all of their stops in a
+		 * single wait loop. We only rescan /proc once everything seen so far has stopped, as only then can we
+		 * be sure that no thread is left to spawn new ones behind our back.
+		 */
+		private async void enable_batched (Cancellable? cancellable) throws Error, IOError {
+			var discovered_tids = new Gee.HashSet<uint> ();
+
+			while (true) {
+				var fresh_tids = new Gee.ArrayList<uint> ();
+				foreach (uint tid in enumerate_threads ()) {
+					if (!excluded_tids.contains (tid) && discovered_tids.add (tid))
+						fresh_tids.add (tid);
+				}
+
+				if (fresh_tids.is_empty)
+					break;
+
+				int64 start_time = get_monotonic_time ();
+				var stopping_tids = new Gee.ArrayList<uint> ();
+				foreach (uint tid in fresh_tids) {
+					if (_ptrace (SEIZE, tid) == -1)
+						continue;
+					seized_tids.add (tid);
+
+					if (_ptrace (INTERRUPT, tid) == 0)
+						stopping_tids.add (tid);
+				}
+				if (timeline != null)
+					timeline.record ("seize-threads", start_time);
+
+				if (cancellable != null)
+					cancellable.set_error_if_cancelled ();
+
+				start_time = get_monotonic_time ();
+				var unresponsive_tids = yield collect_stops (stopping_tids, cancellable);
+				if (timeline != null)
+					timeline.record ("collect-thread-stops", start_time);
+
+				// Like a failed ThreadSuspendSession, a thread that won't stop is left running rather than failing the scope.
+				foreach (uint tid in unresponsive_tids) {
+					seized_tids.remove (tid);
+					detach_once_stopped.begin (tid);
+				}
+			}
+		}
+
+		private async Gee.List<uint> collect_stops (Gee.List<uint> tids, Cancellable? cancellable) throws Error, IOError {
+			var pending = new Gee.LinkedList<uint> ();
+			pending.add_all (tids);
+
+			var wait_cancellable = new Cancellable ();
+
+			bool timed_out = false;
+			var timeout_source = new TimeoutSource.seconds (5);
+			timeout_source.set_callback (() => {
+				timed_out = true;
+				wait_cancellable.cancel ();
+				return Source.REMOVE;
+			});
+			timeout_source.attach (MainContext.get_thread_default ());
+
+			ulong cancel_handler = 0;
+			if (cancellable != null) {
+				cancel_handler = cancellable.connect (() => {
+					wait_cancellable.cancel ();
+				});
+			}
+
+			try {
+				while (true) {
+					var iter = pending.iterator ();
+					while (iter.next ()) {
+						uint tid = iter.get ();
+
+						int status = 0;
+						int res = Posix.waitpid ((Posix.pid_t) tid, out status, Posix.WNOHANG);
+						if (res == 0)
+							continue;
+
+						if (res == -1 || !PosixStatus.is_stopped (status)) {
+							iter.remove ();
+							continue;
+						}
+
+						Posix.Signal sig = PosixStatus.parse_stop_signal (status);
+						if (sig == Posix.Signal.TRAP) {
+							iter.remove ();
+							continue;
+						}
+
+						if (_ptrace (CONT, tid, null, (void *) sig) == -1)
+							iter.remove ();
+					}
+
+					if (pending.is_empty)
+						break;
+
+					var watch = ChildProcess.StateChangeWatch.obtain (pending.first ());
+					try {
+						yield watch.changed.wait_async (wait_cancellable);
+					} catch (IOError e) {
+						if (timed_out)
+							break;
+						cancellable.set_error_if_cancelled ();
+						throw e;
+					} finally {
+						watch.release ();
+					}
+				}
+			} finally {
+				if (cancel_handler != 0)
+					cancellable.disconnect (cancel_handler);
+				timeout_source.destroy ();
+			}
+
+			return pending;
+		}
+
+		private async void enable_one_by_one (Cancellable? cancellable) throws Error, IOError {
 			uint pending = 1;
 
 			CompletionNotify on_complete = () => {
 				pending--;
 				if (pending == 0) {
 					var source = new IdleSource ();
-					source.set_callback (enable.callback);
+					source.set_callback (enable_one_by_one.callback);
 					source.attach (MainContext.get_thread_default ());
 				}
 			};
@@ -2327,19 +2662,16 @@ namespace Frida {
 			uint new_discoveries = 0;
 			Error? pending_error = null;
 			do {
-				Dir dir;
+				Gee.List<uint> tids;
 				try {
-					dir = Dir.open ("/proc/%u/task".printf (pid));
-				} catch (FileError e) {
-					pending_error = new Error.PROCESS_NOT_FOUND ("Process exited unexpectedly");
+					tids = enumerate_threads ();
+				} catch (Error e) {
+					pending_error = e;
 					break;
 				}
 
 				new_discoveries = 0;
-				string? name;
-				while ((name = dir.read_name ()) != null) {
-					var tid = uint.parse (name);
-
+				foreach (uint tid in tids) {
 					if (excluded_tids.contains (tid))
 						continue;
 
@@ -2363,6 +2695,21 @@ namespace Frida {
 				throw pending_error;
 		}
 
+		private Gee.List<uint> enumerate_threads () throws Error {
+			Dir dir;
+			try {
+				dir = Dir.open ("/proc/%u/task".printf (pid));
+			} catch (FileError e) {
+				throw new Error.PROCESS_NOT_FOUND ("Process exited unexpectedly");
+			}
+
+			var tids = new Gee.ArrayList<uint> ();
+			string? name;
+			while ((name = dir.read_name ()) != null)
+				tids.add (uint.parse (name));
+			return tids;
+		}
+
 		private async void suspend_thread (uint tid, Cancellable? cancellable, CompletionNotify on_complete) {
 			try {
 				var session = yield ThreadSuspendSession.open (pid, tid, cancellable);
@@ -2377,10 +2724,37 @@ namespace Frida {
 			assert (state == ACTIVE);
 			state = INACTIVE;
 
+			foreach (uint tid in seized_tids)
+				detach_thread (tid);
+			seized_tids.clear ();
+
 			foreach (SeizeSession session in suspended)
 				session.close ();
 			suspended.clear ();
 		}
+
+		private static void detach_thread (uint tid) {
+			if (_ptrace (DETACH, tid) == -1 && errno == Posix.ESRCH)
+				detach_once_stopped.begin (tid);
+		}
+
+		/*
+		 * A seized thread can only be detached while it's in a ptrace-stop, and the interrupt we sent it will
+		 * eventually put it in one. If we don't take it out of there, it stays stopped for good.
+		 */
+		private static async void detach_once_stopped (uint tid) {
+			while (true) {
+				try {
+					yield ChildProcess.wait_for_signal (tid, Posix.Signal.TRAP, null);
+					break;
+				} catch (GLib.Error e) {
+					if (!(e is Error.TIMED_OUT))
+						return;
+				}
+			}
+
+			_ptrace (DETACH, tid);
+		}
 	}
 
 	private sealed class RemoteCallBuilder {
@@ -3017,6 +3391,8 @@ namespace Frida {
 	}
 
 	namespace ChildProcess {
+		private Gee.HashMap<uint, StateChangeWatch>? state_change_watches;
+
 		private async void wait_for_early_signal (uint pid, Posix.Signal sig, Cancellable? cancellable) throws Error, IOError {
 			while (true) {
 				Posix.Signal next_signal = yield wait_for_next_signal (pid, cancellable);
@@ -3044,39 +3420,48 @@ namespace Frida {
 		private async Posix.Signal wait_for_next_signal (uint pid, Cancellable? cancellable) throws Error, IOError {
 			var main_context = MainContext.get_thread_default ();
 
+			var wait_cancellable = new Cancellable ();
+
 			bool timed_out = false;
 			var timeout_source = new TimeoutSource.seconds (5);
 			timeout_source.set_callback (() => {
 				timed_out = true;
+				wait_cancellable.cancel ();
 				return Source.REMOVE;
 			});
 			timeout_source.attach (main_context);
 
+			ulong cancel_handler = 0;
+			if (cancellable != null) {
+				cancel_handler = cancellable.connect (() => {
+					wait_cancellable.cancel ();
+				});
+			}
+
 			int status = 0;
-			uint[] delays = { 0, 1, 2, 5, 10, 20, 50, 250 };
 			try {
-				for (uint i = 0; !timed_out && !cancellable.set_error_if_cancelled (); i++) {
+				while (true) {
 					int res = Posix.waitpid ((Posix.pid_t) pid, out status, Posix.WNOHANG);
 					if (res == -1)
 						throw new Error.NOT_SUPPORTED ("Unable to wait for next signal: %s", strerror (errno));
 					if (res != 0)
 						break;
 
-					uint delay_ms = (i < delays.length) ? delays[i] : delays[delays.length - 1];
-					var delay_source = new TimeoutSource (delay_ms);
-					delay_source.set_callback (wait_for_next_signal.callback);
-					delay_source.attach (main_context);
-
-					var cancel_source = new CancellableSource (cancellable);
-					cancel_source.set_callback (wait_for_next_signal.callback);
-					cancel_source.attach (main_context);
-
-					yield;
-
-					cancel_source.destroy ();
-					delay_source.destroy ();
+					var watch = StateChangeWatch.obtain (pid);
+					try {
+						yield watch.changed.wait_async (wait_cancellable);
+					} catch (IOError e) {
+						if (timed_out)
+							break;
+						cancellable.set_error_if_cancelled ();
+						throw e;
+					} finally {
+						watch.release ();
+					}
 				}
 			} finally {
+				if (cancel_handler != 0)
+					cancellable.disconnect (cancel_handler);
 				timeout_source.destroy ();
 			}
 
@@ -3097,8 +3482,103 @@ namespace Frida {
 				throw new Error.NOT_SUPPORTED ("Unexpected status: 0x%08x", status);
 			return PosixStatus.parse_stop_signal (status);
 		}
+
+		private sealed class StateChangeWatch : Object {
+			public uint pid {
+				get;
+				construct;
+			}
+
+			public Future<bool> changed {
+				get {
+					return promise.future;
+				}
+			}
+
+			private Promise<bool> promise = new Promise<bool> ();
+			private uint waiters = 0;
+			private Thread<bool>? thread;
+			private FileDescriptor? wakeup_fd;
+			private int cancelled = 0;
+			private bool finished = false;
+			private MainContext main_context;
+
+			private StateChangeWatch (uint pid) {
+				Object (pid: pid);
+			}
+
+			public static StateChangeWatch obtain (uint pid) {
+				if (state_change_watches == null)
+					state_change_watches = new Gee.HashMap<uint, StateChangeWatch> ();
+
+				StateChangeWatch? watch = state_change_watches[pid];
+				if (watch == null) {
+					watch = new StateChangeWatch (pid);
+					state_change_watches[pid] = watch;
+					watch.start ();
+				}
+
+				watch.waiters++;
+				return watch;
+			}
+
+			public void release () {
+				waiters--;
+				if (waiters == 0 && !finished)
+					cancel ();
+			}
+
+			private void start () {
+				main_context = MainContext.ref_thread_default ();
+
+				int fd = eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+				if (fd != -1)
+					wakeup_fd = new FileDescriptor (fd);
+
+				thread = new Thread<bool> ("frida-child-watch", () => {
+					_await_child_state_change (pid, (wakeup_fd != null) ? wakeup_fd.handle : -1, ref cancelled);
+
+					var source = new IdleSource ();
+					source.set_callback (() => {
+						on_thread_finished ();
+						return Source.REMOVE;
+					});
+					source.attach (main_context);
+
+					return true;
+				});
+			}
+
+			private void cancel () {
+				if (state_change_watches[pid] == this)
+					state_change_watches.unset (pid);
+
+				AtomicInt.set (ref cancelled, 1);
+
+				if (wakeup_fd != null) {
+					uint64 one = 1;
+					Posix.write (wakeup_fd.handle, &one, sizeof (uint64));
+				}
+			}
+
+			private void on_thread_finished () {
+				finished = true;
+
+				thread.join ();
+				thread = null;
+				wakeup_fd = null;
+
+				if (state_change_watches[pid] == this)
+					state_change_watches.unset (pid);
+				promise.resolve (true);
+			}
+		}
+
+		[CCode (cname = "_frida_await_child_state_change")]
+		private extern bool _await_child_state_change (uint pid, int wakeup_fd, ref int cancelled);
 	}
 
+
 	namespace PosixStatus {
 		[CCode (cname = "WIFEXITED", cheader_filename = "sys/wait.h")]
 		private extern bool is_exit (int status);
@@ -3125,55 +3605,211 @@ namespace Frida {
 
 	public extern bool _syscall_satisfies (int syscall_id, LinuxSyscall mask);
 
-	private sealed class ProcMapsSoEntry {
+	protected sealed class ProcMapsSoEntry {
 		public uint64 base_address;
 		public string path;
 		public string identity;
 
-		private ProcMapsSoEntry (uint64 base_address, string path, string identity) {
+		public ProcMapsSoEntry (uint64 base_address, string path, string identity) {
 			this.base_address = base_address;
 			this.path = path;
 			this.identity = identity;
 		}
+	}
 
-		public static ProcMapsSoEntry? find_by_address (uint pid, uint64 address) {
-			var iter = MapsIter.for_pid (pid);
-			while (iter.next ()) {
-				uint64 start = iter.start_address;
-				uint64 end = iter.end_address;
-				if (address >= start && address < end)
-					return new ProcMapsSoEntry (start, iter.path, iter.identity);
+	protected sealed class ProcMaps {
+		private Range[] ranges = {};
+		private string[] strings = {};
+		private Gee.HashMap<string, uint> string_ids = new Gee.HashMap<string, uint> ();
+
+		private const uint NO_STRING = uint.MAX;
+
+		private struct Range {
+			public uint64 start;
+			public uint64 end;
+			public uint64 file_offset;
+			public RangeFlags flags;
+			public uint path;
+			public uint identity;
+		}
+
+		[Flags]
+		private enum RangeFlags {
+			READABLE,
+			WRITABLE,
+			EXECUTABLE,
+			SHARED
+		}
+
+		public static ProcMaps for_pid (uint pid) {
+			string contents;
+			try {
+				FileUtils.get_contents ("/proc/%u/maps".printf (pid), out contents);
+			} catch (FileError e) {
+				contents = "";
+			}
+			return new ProcMaps (contents);
+		}
+
+		public static ProcMaps parse (string contents) {
+			return new ProcMaps (contents);
+		}
+
+		private ProcMaps (string contents) {
+			unowned uint8[] data = contents.data;
+			uint n = data.length;
+			uint previous_path = NO_STRING;
+			uint previous_identity = NO_STRING;
+
+			uint i = 0;
+			while (i < n) {
+				uint eol = i;
+				while (eol != n && data[eol] != '\n')
+					eol++;
+
+				var r = Range ();
+				if (parse_line (data, i, eol, ref r, ref previous_path, ref previous_identity))
+					ranges += r;
+
+				i = eol + 1;
+			}
+		}
+
+		private bool parse_line (uint8[] data, uint i, uint eol, ref Range r, ref uint previous_path,
+				ref uint previous_identity) {
+			r.start = parse_hex (data, ref i, eol);
+			if (!skip_char (data, ref i, eol, '-'))
+				return false;
+			r.end = parse_hex (data, ref i, eol);
+			if (!skip_char (data, ref i, eol, ' '))
+				return false;
+
+			if (eol - i < 5)
+				return false;
+			if (data[i + 0] == 'r')
+				r.flags |= READABLE;
+			if (data[i + 1] == 'w')
+				r.flags |= WRITABLE;
+			if (data[i + 2] == 'x')
+				r.flags |= EXECUTABLE;
+			if (data[i + 3] == 's')
+				r.flags |= SHARED;
+			i += 4;
+			if (!skip_char (data, ref i, eol, ' '))
+				return false;
+
+			r.file_offset = parse_hex (data, ref i, eol);
+			if (!skip_char (data, ref i, eol, ' '))
+				return false;
+
+			uint identity_start = i;
+			while (i != eol && data[i] != ' ')
+				i++;
+			if (!skip_char (data, ref i, eol, ' '))
+				return false;
+			while (i != eol && data[i] != ' ')
+				i++;
+			r.identity = intern (data, identity_start, i, ref previous_identity);
+
+			while (i != eol && data[i] == ' ')
+				i++;
+			r.path = intern (data, i, eol, ref previous_path);
+
+			return true;
+		}
+
+		private static uint64 parse_hex (uint8[] data, ref uint i, uint eol) {
+			uint64 val = 0;
+			while (i != eol) {
+				int digit = ((char) data[i]).xdigit_value ();
+				if (digit == -1)
+					break;
+				val = (val << 4) | digit;
+				i++;
+			}
+			return val;
+		}
+
+		private static bool skip_char (uint8[] data, ref uint i, uint eol, char expected) {
+			if (i == eol || data[i] != expected)
+				return false;
+			i++;
+			return true;
+		}
+
+		private uint intern (uint8[] data, uint start, uint end, ref uint previous) {
+			size_t length = end - start;
+
+			if (previous != NO_STRING) {
+				unowned string candidate = strings[previous];
+				if (candidate.length == length && Memory.cmp ((char *) candidate, (uint8 *) data + start, length) == 0)
+					return previous;
+			}
+
+			string str = ((string) ((uint8 *) data + start)).substring (0, (long) length);
+			uint id;
+			if (string_ids.has_key (str)) {
+				id = string_ids[str];
+			} else {
+				id = strings.length;
+				strings += str;
+				string_ids[str] = id;
+			}
+
+			previous = id;
+			return id;
+		}
+
+		public ProcMapsSoEntry? find_so_by_address (uint64 address) {
+			int lo = 0;
+			int hi = ranges.length - 1;
+			while (lo <= hi) {
+				int mid = lo + ((hi - lo) / 2);
+				Range r = ranges[mid];
+				if (address < r.start) {
+					hi = mid - 1;
+				} else if (address >= r.end) {
+					lo = mid + 1;
+				} else {
+					if (strings[r.path] == "")
+						return null;
+					return new ProcMapsSoEntry (r.start, strings[r.path], strings[r.identity]);
+				}
 			}
 
 			return null;
 		}
 
-		public static ProcMapsSoEntry? find_by_path (uint pid, string path) {
+		public ProcMapsSoEntry? find_so_by_path (string path) {
+			if (!string_ids.has_key (path))
+				return null;
+			uint path_id = string_ids[path];
+
 			var candidates = new Gee.ArrayList<Candidate> ();
 			Candidate? latest_candidate = null;
-			var iter = MapsIter.for_pid (pid);
+			uint page_size_compat_id = string_ids.has_key ("[page size compat]")
+				? string_ids["[page size compat]"]
+				: NO_STRING;
+			uint anonymous_id = string_ids.has_key ("") ? string_ids[""] : NO_STRING;
 #if ANDROID
-			unowned string libc_path = Gum.Process.get_libc_module ().path;
+			bool skip_shared = path == Gum.Process.get_libc_module ().path;
 #endif
-			while (iter.next ()) {
-				string current_path = iter.path;
-				if (current_path == "[page size compat]")
+			foreach (var r in ranges) {
+				if (r.path == page_size_compat_id || r.path == anonymous_id)
 					continue;
-				if (current_path != path) {
+				if (r.path != path_id) {
 					latest_candidate = null;
 					continue;
 				}
 
-				string flags = iter.flags;
-
 #if ANDROID
-				if (current_path == libc_path && flags[3] == 's')
+				if (skip_shared && (r.flags & RangeFlags.SHARED) != 0)
 					continue;
 #endif
 
-				if (iter.file_offset == 0) {
+				if (r.file_offset == 0) {
 					latest_candidate = new Candidate () {
-						entry = new ProcMapsSoEntry (iter.start_address, current_path, iter.identity),
+						entry = new ProcMapsSoEntry (r.start, path, strings[r.identity]),
 						total_ranges = 0,
 						executable_ranges = 0,
 					};
@@ -3182,7 +3818,7 @@ namespace Frida {
 
 				if (latest_candidate != null) {
 					latest_candidate.total_ranges++;
-					if (flags[2] == 'x')
+					if ((r.flags & RangeFlags.EXECUTABLE) != 0)
 						latest_candidate.executable_ranges++;
 				}
 			}
@@ -3207,81 +3843,6 @@ namespace Frida {
 				return result;
 			}
 		}
-
-		private class MapsIter {
-			private string? contents;
-			private MatchInfo? info;
-			private uint offset = 0;
-
-			public uint64 start_address {
-				get {
-					return uint64.parse (info.fetch (1), 16);
-				}
-			}
-
-			public uint64 end_address {
-				get {
-					return uint64.parse (info.fetch (2), 16);
-				}
-			}
-
-			public string flags {
-				owned get {
-					return info.fetch (3);
-				}
-			}
-
-			public uint64 file_offset {
-				get {
-					return uint64.parse (info.fetch (4), 16);
-				}
-			}
-
-			public string identity {
-				owned get {
-					return info.fetch (5);
-				}
-			}
-
-			public string path {
-				owned get {
-					return info.fetch (6);
-				}
-			}
-
-			public static MapsIter for_pid (uint pid) {
-				return new MapsIter (pid);
-			}
-
-			private MapsIter (uint pid) {
-				try {
-					FileUtils.get_contents ("/proc/%u/maps".printf (pid), out contents);
-				} catch (FileError e) {
-					return;
-				}
-
-				if (!/^([0-9a-f]+)-([0-9a-f]+) (\S{4}) ([0-9a-f]+) ([0-9a-f]{2,}:[0-9a-f]{2,} \d+) +([^\n]+)$/m.match (
-						contents, 0, out info)) {
-					assert_not_reached ();
-				}
-			}
-
-			public bool next () {
-				if (info == null)
-					return false;
-
-				if (offset > 0) {
-					try {
-						info.next ();
-					} catch (RegexError e) {
-						return false;
-					}
-				}
-				offset++;
-
-				return info.matches ();
-			}
-		}
 	}
 
 	private size_t round_size_to_page_size (size_t size) {
@@ -11,6 +11,7 @@ namespace Frida {
 		private HelperFactory? factory32;
 		private HelperFactory? factory64;
 		private Gee.Map<uint, LinuxHelper> injectee_ids = new Gee.HashMap<uint, LinuxHelper> ();
+		private Gee.Map<uint, InjectionPhaseInfo?> obtain_phases = new Gee.HashMap<uint, InjectionPhaseInfo?> ();
 
 		public LinuxHelperProcess (TemporaryDirectory tempdir) {
 			Object (tempdir: tempdir);
@@ -22,6 +23,7 @@ namespace Frida {
 
 		public async void close (Cancellable? cancellable) throws IOError {
 			injectee_ids.clear ();
+			obtain_phases.clear ();
 
 			if (factory32 != null) {
 				yield factory32.close (cancellable);
@@ -36,6 +38,28 @@ namespace Frida {
 			_resource_store = null;
 		}
 
+		/*
+		 * Spawns the helpers for every architecture we can inject into, so the first attach doesn't pay for that, and lets
+		 * them resolve whatever they can ahead of time.
+		 */
+		public async void prewarm (Cancellable? cancellable) throws Error, IOError {
+			var store = get_resource_store ();
+
+			var helpers = new Gee.ArrayList<LinuxHelper> ();
+			if (sizeof (void *) == 8 || store.helper64 != null)
+				helpers.add (yield obtain_for_64bit (cancellable));
+			if (sizeof (void *) == 4 || store.helper32 != null)
+				helpers.add (yield obtain_for_32bit (cancellable));
+
+			foreach (var helper in helpers) {
+				try {
+					yield helper.prewarm (cancellable);
+				} catch (GLib.Error e) {
+					throw_dbus_error (e);
+				}
+			}
+		}
+
 		private ResourceStore get_resource_store () throws Error {
 			if (_resource_store == null)
 				_resource_store = new ResourceStore (tempdir);
@@ -109,10 +133,13 @@ namespace Frida {
 
 		public async void inject_library (uint pid, UnixInputStream library_so, string entrypoint, string data,
 				AgentFeatures features, uint id, Cancellable? cancellable) throws Error, IOError {
+			int64 start_time = get_monotonic_time ();
 			var helper = yield obtain_for_cpu_type (cpu_type_from_pid (pid), cancellable);
+			var obtain_phase = InjectionPhaseInfo ("obtain-helper", start_time, get_monotonic_time ());
 			try {
 				yield helper.inject_library (pid, library_so, entrypoint, data, features, id, cancellable);
 				injectee_ids[id] = helper;
+				obtain_phases[id] = obtain_phase;
 			} catch (GLib.Error e) {
 				throw_dbus_error (e);
 			}
@@ -156,6 +183,20 @@ namespace Frida {
 			}
 		}
 
+		public async InjectionPhaseInfo[] query_injection_timeline (uint id, Cancellable? cancellable) throws Error, IOError {
+			var helper = obtain_for_injectee_id (id);
+			InjectionPhaseInfo? obtain_phase;
+			obtain_phases.unset (id, out obtain_phase);
+			try {
+				InjectionPhaseInfo[] phases = yield helper.query_injection_timeline (id, cancellable);
+				if (obtain_phase != null)
+					phases += obtain_phase;
+				return phases;
+			} catch (GLib.Error e) {
+				throw_dbus_error (e);
+			}
+		}
+
 		private LinuxHelper obtain_for_injectee_id (uint id) throws Error, IOError {
 			var helper = injectee_ids[id];
 			if (helper == null)
@@ -241,6 +282,7 @@ namespace Frida {
 
 		private void on_factory_uninjected (uint id) {
 			injectee_ids.unset (id);
+			obtain_phases.unset (id);
 
 			uninjected (id);
 		}
@@ -482,6 +524,14 @@ namespace Frida {
 			proxy.uninjected.disconnect (on_uninjected);
 		}
 
+		public async void prewarm (Cancellable? cancellable) throws Error, IOError {
+			try {
+				yield proxy.prewarm (cancellable);
+			} catch (GLib.Error e) {
+				throw_dbus_error (e);
+			}
+		}
+
 		public async uint spawn (string path, HostSpawnOptions options, Cancellable? cancellable) throws Error, IOError {
 			try {
 				return yield proxy.spawn (path, options, cancellable);
@@ -597,6 +647,14 @@ namespace Frida {
 			}
 		}
 
+		public async InjectionPhaseInfo[] query_injection_timeline (uint id, Cancellable? cancellable) throws Error, IOError {
+			try {
+				return yield proxy.query_injection_timeline (id, cancellable);
+			} catch (GLib.Error e) {
+				throw_dbus_error (e);
+			}
+		}
+
 		private void on_output (uint pid, int fd, uint8[] data) {
 			output (pid, fd, data);
 		}
@@ -120,6 +120,10 @@ namespace Frida {
 				shutdown.begin ();
 		}
 
+		public async void prewarm (Cancellable? cancellable) throws Error, IOError {
+			yield backend.prewarm (cancellable);
+		}
+
 		public async uint spawn (string path, HostSpawnOptions options, Cancellable? cancellable) throws Error, IOError {
 			return yield backend.spawn (path, options, cancellable);
 		}
@@ -180,6 +184,10 @@ namespace Frida {
 			yield backend.recreate_injectee_thread (pid, id, cancellable);
 		}
 
+		public async InjectionPhaseInfo[] query_injection_timeline (uint id, Cancellable? cancellable) throws Error, IOError {
+			return yield backend.query_injection_timeline (id, cancellable);
+		}
+
 		private void on_backend_output (uint pid, int fd, uint8[] data) {
 			output (pid, fd, data);
 		}
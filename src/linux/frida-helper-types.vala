@@ -4,6 +4,7 @@ namespace Frida {
 		public signal void uninjected (uint id);
 
 		public abstract async void close (Cancellable? cancellable) throws IOError;
+		public abstract async void prewarm (Cancellable? cancellable) throws Error, IOError;
 
 		public abstract async uint spawn (string path, HostSpawnOptions options, Cancellable? cancellable) throws Error, IOError;
 		public abstract async void prepare_exec_transition (uint pid, Cancellable? cancellable) throws Error, IOError;
@@ -22,6 +23,8 @@ namespace Frida {
 		public abstract async void demonitor_and_clone_injectee_state (uint id, uint clone_id, AgentFeatures features,
 			Cancellable? cancellable) throws Error, IOError;
 		public abstract async void recreate_injectee_thread (uint pid, uint id, Cancellable? cancellable) throws Error, IOError;
+		public abstract async InjectionPhaseInfo[] query_injection_timeline (uint id, Cancellable? cancellable)
+			throws Error, IOError;
 	}
 
 	[Flags]
@@ -48,6 +51,7 @@ namespace Frida {
 		public signal void uninjected (uint id);
 
 		public abstract async void stop (Cancellable? cancellable) throws GLib.Error;
+		public abstract async void prewarm (Cancellable? cancellable) throws GLib.Error;
 
 		public abstract async uint spawn (string path, HostSpawnOptions options, Cancellable? cancellable) throws GLib.Error;
 		public abstract async void prepare_exec_transition (uint pid, Cancellable? cancellable) throws GLib.Error;
@@ -66,6 +70,47 @@ namespace Frida {
 		public abstract async void demonitor_and_clone_injectee_state (uint id, uint clone_id, AgentFeatures features,
 			Cancellable? cancellable) throws GLib.Error;
 		public abstract async void recreate_injectee_thread (uint pid, uint id, Cancellable? cancellable) throws GLib.Error;
+		public abstract async InjectionPhaseInfo[] query_injection_timeline (uint id, Cancellable? cancellable)
+			throws GLib.Error;
+	}
+
+	public struct InjectionPhaseInfo {
+		public string name;
+		public int64 start_time;
+		public int64 end_time;
+
+		public InjectionPhaseInfo (string name, int64 start_time, int64 end_time) {
+			this.name = name;
+			this.start_time = start_time;
+			this.end_time = end_time;
+		}
+	}
+
+	/*
+	 * Records how long each phase of an injection took, using monotonic timestamps so that phases recorded by the helper
+	 * process line up with those recorded by the injector.
+	 */
+	public sealed class InjectionTimelineRecorder {
+		private Gee.ArrayList<InjectionPhaseInfo?> phases = new Gee.ArrayList<InjectionPhaseInfo?> ();
+
+		public void record (string name, int64 start_time) {
+			phases.add (InjectionPhaseInfo (name, start_time, get_monotonic_time ()));
+		}
+
+		public void add_all (InjectionPhaseInfo[] other) {
+			foreach (var phase in other)
+				phases.add (phase);
+		}
+
+		public InjectionPhaseInfo[] to_array () {
+			phases.sort ((a, b) => (a.start_time < b.start_time) ? -1 : ((a.start_time > b.start_time) ? 1 : 0));
+
+			var result = new InjectionPhaseInfo[phases.size];
+			int i = 0;
+			foreach (var phase in phases)
+				result[i++] = phase;
+			return result;
+		}
 	}
 
 	public struct PathTemplate {
@@ -17,10 +17,14 @@ namespace Frida {
 
 		private Gee.HashMap<uint, uint> pid_by_id = new Gee.HashMap<uint, uint> ();
 		private Gee.HashMap<uint, TemporaryFile> blob_file_by_id = new Gee.HashMap<uint, TemporaryFile> ();
+		private Gee.HashMap<uint, TimelineEntry> timelines = new Gee.HashMap<uint, TimelineEntry> ();
+		private Gee.Queue<uint> timeline_ids = new Gee.ArrayQueue<uint> ();
 		private uint next_injectee_id = 1;
 		private uint next_blob_id = 1;
 		private bool did_prep_tempdir = false;
 
+		private const uint MAX_TIMELINES = 64;
+
 		public Linjector (LinuxHelper helper, bool close_helper, TemporaryDirectory tempdir) {
 			Object (helper: helper, close_helper: close_helper, tempdir: tempdir);
 		}
@@ -62,9 +66,7 @@ namespace Frida {
 			AgentFeatures features = 0;
 
 			if (MemoryFileDescriptor.is_supported ()) {
-				FileDescriptor fd = MemoryFileDescriptor.from_bytes (name, blob);
-				adjust_fd_permissions (fd);
-				UnixInputStream library_so = new UnixInputStream (fd.steal (), true);
+				UnixInputStream library_so = SealedMemfdCache.get_default ().obtain (name, blob);
 				return yield inject_library_fd (pid, library_so, entrypoint, data, features, cancellable);
 			}
 
@@ -84,6 +86,8 @@ namespace Frida {
 		public async uint inject_library_resource (uint pid, AgentDescriptor agent, string entrypoint, string data,
 				AgentFeatures features, Cancellable? cancellable) throws Error, IOError {
 			if (MemoryFileDescriptor.is_supported ()) {
+				var timeline = new InjectionTimelineRecorder ();
+				int64 start_time = get_monotonic_time ();
 				unowned string arch_name = arch_name_from_pid (pid);
 				string name = agent.name_template.expand (arch_name);
 				AgentResource? resource = agent.resources.first_match (r => r.name == name);
@@ -91,7 +95,9 @@ namespace Frida {
 					throw new Error.NOT_SUPPORTED ("Unable to handle %s-bit processes due to build configuration",
 						arch_name);
 				}
-				return yield inject_library_fd (pid, resource.get_memfd (), entrypoint, data, features, cancellable);
+				UnixInputStream library_so = resource.get_memfd ();
+				timeline.record ("prepare-agent", start_time);
+				return yield perform_injection (pid, library_so, entrypoint, data, features, timeline, cancellable);
 			}
 
 			ensure_tempdir_prepared ();
@@ -101,16 +107,63 @@ namespace Frida {
 
 		public async uint inject_library_fd (uint pid, UnixInputStream library_so, string entrypoint, string data,
 				AgentFeatures features, Cancellable? cancellable) throws Error, IOError {
+			return yield perform_injection (pid, library_so, entrypoint, data, features, new InjectionTimelineRecorder (),
+				cancellable);
+		}
+
+		private async uint perform_injection (uint pid, UnixInputStream library_so, string entrypoint, string data,
+				AgentFeatures features, InjectionTimelineRecorder timeline, Cancellable? cancellable) throws Error, IOError {
 			uint id = next_injectee_id++;
+			int64 start_time = get_monotonic_time ();
 			yield helper.inject_library (pid, library_so, entrypoint, data, features, id, cancellable);
+			timeline.record ("inject", start_time);
 
 			pid_by_id[id] = pid;
 
+			var entry = new TimelineEntry (timeline);
+			timelines[id] = entry;
+			timeline_ids.offer (id);
+			while (timeline_ids.size > MAX_TIMELINES)
+				timelines.unset (timeline_ids.poll ());
+
+			// Collected right away as the helper forgets about the injectee once it unloads.
+			fetch_helper_phases.begin (id, entry);
+
 			return id;
 		}
 
+		private async void fetch_helper_phases (uint id, TimelineEntry entry) {
+			try {
+				entry.timeline.add_all (yield helper.query_injection_timeline (id, null));
+			} catch (GLib.Error e) {
+			}
+			entry.complete.resolve (entry.timeline);
+		}
+
+		/*
+		 * Returns the phases of the injection with the given ID, ordered by start time. Includes both the phases observed
+		 * here and those recorded by the helper, e.g. ptrace seize, remote bootstrap, and loader handshake.
+		 */
+		public async InjectionPhaseInfo[] query_injection_timeline (uint id, Cancellable? cancellable) throws Error, IOError {
+			TimelineEntry? entry = timelines[id];
+			if (entry == null)
+				throw new Error.INVALID_ARGUMENT ("Invalid ID");
+			InjectionTimelineRecorder timeline = yield entry.complete.future.wait_async (cancellable);
+			return timeline.to_array ();
+		}
+
+		// Lets the host session add phases that happen after the injection itself, e.g. the agent handshake.
+		public void record_injection_phase (uint id, string name, int64 start_time) {
+			TimelineEntry? entry = timelines[id];
+			if (entry != null)
+				entry.timeline.record (name, start_time);
+		}
+
 		public async IOStream request_control_channel (uint id, Cancellable? cancellable) throws Error, IOError {
-			return yield helper.request_control_channel (id, cancellable);
+			int64 start_time = get_monotonic_time ();
+			IOStream stream = yield helper.request_control_channel (id, cancellable);
+			record_injection_phase (id, "control-channel", start_time);
+			return stream;
 		}
 
 		private void ensure_tempdir_prepared () {
@@ -151,6 +204,15 @@ namespace Frida {
 
 			uninjected (id);
 		}
+
+		private class TimelineEntry {
+			public InjectionTimelineRecorder timeline;
+			public Promise<InjectionTimelineRecorder> complete = new Promise<InjectionTimelineRecorder> ();
+
+			public TimelineEntry (InjectionTimelineRecorder timeline) {
+				this.timeline = timeline;
+			}
+		}
 	}
 
 	public enum AgentMode {
@@ -193,7 +255,7 @@ namespace Frida {
 					(mode == INSTANCED) ? _clone_so (so64) : so64, tempdir));
 			}
 			foreach (var r in resources) {
-				if (r.blob.length != 0)
+				if (r.size != 0)
 					all_resources.add (r);
 			}
 
@@ -225,7 +287,24 @@ namespace Frida {
 			construct;
 		}
 
+		// Inflated on first access when the resource was created from a compressed blob.
 		public Bytes blob {
+			get {
+				if (_blob == null)
+					_blob = inflate ();
+				return _blob;
+			}
+			construct {
+				_blob = value;
+			}
+		}
+
+		public Bytes? compressed_blob {
+			get;
+			construct;
+		}
+
+		public size_t size {
 			get;
 			construct;
 		}
@@ -235,18 +314,31 @@ namespace Frida {
 			construct;
 		}
 
+		private Bytes? _blob;
 		private TemporaryFile? _file;
 		private UnixInputStream? _memfd;
+		private string? _digest;
 
 		public AgentResource (string name, Bytes blob, TemporaryDirectory? tempdir = null) {
-			Object (name: name, blob: blob, tempdir: tempdir);
+			Object (name: name, blob: blob, size: blob.get_size (), tempdir: tempdir);
+		}
+
+		public AgentResource.compressed (string name, Bytes compressed_blob, size_t size,
+				TemporaryDirectory? tempdir = null) {
+			Object (name: name, compressed_blob: compressed_blob, size: size, tempdir: tempdir);
+		}
+
+		public static AgentResource from_embedded (string name, uint8[] data, size_t uncompressed_size,
+				TemporaryDirectory? tempdir = null) {
+			var bytes = new Bytes.static (data);
+			if (data.length != 0 && data.length != uncompressed_size)
+				return new AgentResource.compressed (name, bytes, uncompressed_size, tempdir);
+			return new AgentResource (name, bytes, tempdir);
 		}
 
 		public TemporaryFile get_file () throws Error {
-			if (_file == null) {
-				var stream = new MemoryInputStream.from_bytes (blob);
-				_file = new TemporaryFile.from_stream (name, stream, tempdir);
-			}
+			if (_file == null)
+				_file = new TemporaryFile.from_stream (name, open_stream (), tempdir);
 			return _file;
 		}
 
@@ -254,12 +346,269 @@ namespace Frida {
 			if (_memfd == null) {
 				if (!MemoryFileDescriptor.is_supported ())
 					throw new Error.NOT_SUPPORTED ("Kernel too old for memfd support");
-				FileDescriptor fd = MemoryFileDescriptor.from_bytes (name, blob);
-				adjust_fd_permissions (fd);
-				_memfd = new UnixInputStream (fd.steal (), true);
+				var cache = SealedMemfdCache.get_default ();
+				if (compressed_blob != null && _blob == null) {
+					if (_digest == null)
+						_digest = "br:" + Checksum.compute_for_bytes (SHA256, compressed_blob);
+					_memfd = cache.obtain_streamed (name, compressed_blob, _digest, size, open_stream);
+				} else {
+					if (_digest == null)
+						_digest = Checksum.compute_for_bytes (SHA256, blob);
+					_memfd = cache.obtain (name, blob, _digest);
+				}
 			}
 			return _memfd;
 		}
+
+		private InputStream open_stream () {
+			if (compressed_blob != null && _blob == null) {
+				return new ConverterInputStream (new MemoryInputStream.from_bytes (compressed_blob),
+					new BrotliDecompressor ());
+			}
+			return new MemoryInputStream.from_bytes (blob);
+		}
+
+		private Bytes inflate () {
+			var data = new uint8[size];
+			try {
+				size_t bytes_read;
+				open_stream ().read_all (data, out bytes_read);
+				assert (bytes_read == size);
+			} catch (GLib.Error e) {
+				error ("Embedded agent %s is corrupt: %s", name, e.message);
+			}
+			return new Bytes.take ((owned) data);
+		}
+	}
+
+	private sealed class BrotliDecompressor : Object, Converter {
+		private Brotli.Decoder decoder = new Brotli.Decoder ();
+
+		public ConverterResult convert (uint8[] inbuf, uint8[] outbuf, ConverterFlags flags, out size_t bytes_read,
+				out size_t bytes_written) throws GLib.Error {
+			size_t available_in = inbuf.length;
+			uint8 * next_in = inbuf;
+			size_t available_out = outbuf.length;
+			uint8 * next_out = outbuf;
+
+			var result = decoder.decompress_stream (&available_in, &next_in, &available_out, &next_out);
+
+			bytes_read = inbuf.length - available_in;
+			bytes_written = outbuf.length - available_out;
+			bool made_progress = bytes_read != 0 || bytes_written != 0;
+
+			switch (result) {
+				case SUCCESS:
+					return FINISHED;
+				case NEEDS_MORE_INPUT:
+					if (!made_progress) {
+						if ((flags & ConverterFlags.INPUT_AT_END) != 0)
+							throw new IOError.INVALID_DATA ("Truncated Brotli stream");
+						throw new IOError.PARTIAL_INPUT ("Need more input");
+					}
+					return CONVERTED;
+				case NEEDS_MORE_OUTPUT:
+					if (!made_progress)
+						throw new IOError.NO_SPACE ("Need more output space");
+					return CONVERTED;
+				default:
+					throw new IOError.INVALID_DATA ("Invalid Brotli stream (%s)", decoder.get_error_code ().to_string ());
+			}
+		}
+
+		public void reset () {
+			decoder = new Brotli.Decoder ();
+		}
+	}
+
+	/*
+	 * Process-wide cache of sealed memfds keyed by content hash, so that injecting the same library over and over, from
+	 * any Linjector or host session, writes it into memory only once. Injectees receive their own reference to the
+	 * descriptor, so evicting an entry never affects code that is already loaded.
+	 */
+	public sealed class SealedMemfdCache : Object {
+		public uint max_entries {
+			get;
+			set;
+			default = 16;
+		}
+
+		public uint64 max_size {
+			get;
+			set;
+			default = 256 * 1024 * 1024;
+		}
+
+		public uint64 hits {
+			get {
+				return _hits;
+			}
+		}
+
+		public uint64 misses {
+			get {
+				return _misses;
+			}
+		}
+
+		private Gee.Map<string, Entry> entries = new Gee.HashMap<string, Entry> ();
+		private Gee.List<Entry> lru = new Gee.LinkedList<Entry> ();
+		private uint64 total_size = 0;
+		private uint64 _hits = 0;
+		private uint64 _misses = 0;
+		private Mutex mutex = Mutex ();
+
+		private static SealedMemfdCache? default_cache;
+		private static Mutex default_cache_mutex = Mutex ();
+
+		public static SealedMemfdCache get_default () {
+			default_cache_mutex.lock ();
+			if (default_cache == null)
+				default_cache = new SealedMemfdCache ();
+			var cache = default_cache;
+			default_cache_mutex.unlock ();
+			return cache;
+		}
+
+		public UnixInputStream obtain (string name, Bytes blob, string? digest = null) {
+			mutex.lock ();
+
+			// Re-injecting the very same Bytes is the common case, so avoid hashing it again.
+			Entry? entry = lru.first_match (e => e.source == blob);
+			if (entry == null) {
+				string key = (digest != null) ? digest : Checksum.compute_for_bytes (SHA256, blob);
+				entry = entries[key];
+				if (entry == null) {
+					_misses++;
+
+					FileDescriptor fd = MemoryFileDescriptor.create_sealable (name);
+					unowned uint8[] data = blob.get_data ();
+					ssize_t n = Posix.write (fd.handle, data, data.length);
+					assert (n == data.length);
+
+					// Never share an unsealed memfd, as any injectee could then modify it under the others.
+					if (!MemoryFileDescriptor.seal (fd)) {
+						mutex.unlock ();
+						return make_stream (fd);
+					}
+
+					entry = add_entry (key, blob, blob.get_size (), fd);
+				} else {
+					_hits++;
+				}
+			} else {
+				_hits++;
+			}
+
+			UnixInputStream stream = use_entry (entry);
+
+			mutex.unlock ();
+
+			return stream;
+		}
+
+		public delegate InputStream StreamFactory ();
+
+		/*
+		 * Like obtain(), but for content that is produced by a stream, e.g. a compressed resource: on a miss the stream is
+		 * copied straight into the memfd, without ever holding all of the content in memory.
+		 */
+		public UnixInputStream obtain_streamed (string name, Bytes source, string key, size_t size, StreamFactory open_stream)
+				throws Error {
+			mutex.lock ();
+
+			try {
+				Entry? entry = lru.first_match (e => e.source == source);
+				if (entry == null)
+					entry = entries[key];
+				if (entry == null) {
+					_misses++;
+
+					FileDescriptor fd = MemoryFileDescriptor.create_sealable (name);
+					copy_stream_to_fd (open_stream (), fd, size);
+
+					if (!MemoryFileDescriptor.seal (fd))
+						return make_stream (fd);
+
+					entry = add_entry (key, source, size, fd);
+				} else {
+					_hits++;
+				}
+
+				return use_entry (entry);
+			} finally {
+				mutex.unlock ();
+			}
+		}
+
+		public void clear () {
+			mutex.lock ();
+			entries.clear ();
+			lru.clear ();
+			total_size = 0;
+			mutex.unlock ();
+		}
+
+		private Entry add_entry (string key, Bytes source, uint64 size, FileDescriptor fd) {
+			var entry = new Entry (key, source, size, make_stream (fd));
+			entries[key] = entry;
+			lru.insert (0, entry);
+			total_size += size;
+
+			return entry;
+		}
+
+		private static UnixInputStream make_stream (FileDescriptor fd) {
+			adjust_fd_permissions (fd);
+			return new UnixInputStream (fd.steal (), true);
+		}
+
+		private UnixInputStream use_entry (Entry entry) {
+			lru.remove (entry);
+			lru.insert (0, entry);
+
+			while (lru.size > 1 && (lru.size > max_entries || total_size > max_size)) {
+				Entry victim = lru.remove_at (lru.size - 1);
+				entries.unset (victim.key);
+				total_size -= victim.size;
+			}
+
+			return entry.stream;
+		}
+
+		private static void copy_stream_to_fd (InputStream input, FileDescriptor fd, size_t size) throws Error {
+			var buffer = new uint8[256 * 1024];
+			size_t total = 0;
+			try {
+				while (true) {
+					ssize_t n = input.read (buffer);
+					if (n == 0)
+						break;
+					ssize_t written = Posix.write (fd.handle, buffer, n);
+					if (written != n)
+						throw new Error.NOT_SUPPORTED ("Unable to write to memfd: %s", strerror (errno));
+					total += n;
+				}
+			} catch (IOError e) {
+				throw new Error.PROTOCOL ("Unable to decompress agent: %s", e.message);
+			}
+			if (total != size)
+				throw new Error.PROTOCOL ("Decompressed agent has unexpected size");
+		}
+
+		private class Entry {
+			public string key;
+			public Bytes source;
+			public uint64 size;
+			public UnixInputStream stream;
+
+			public Entry (string key, Bytes source, uint64 size, UnixInputStream stream) {
+				this.key = key;
+				this.source = source;
+				this.size = size;
+				this.stream = stream;
+			}
+		}
 	}
 
 	private static void adjust_directory_permissions (string path) {
@@ -28,6 +28,15 @@ namespace Frida {
 			construct;
 		}
 
+		/*
+		 * When set, preload() also spawns the helpers and materializes the agent memfds up front, leaving little more
+		 * than the ptrace work for attach() to do.
+		 */
+		public bool warm_agents {
+			get;
+			construct;
+		}
+
 		private AgentContainer system_session_container;
 
 		private AgentDescriptor? agent;
@@ -43,11 +52,13 @@ namespace Frida {
 #endif
 		private ProcessEnumerator process_enumerator = new ProcessEnumerator ();
 
-		public LinuxHostSession (owned LinuxHelper helper, owned TemporaryDirectory tempdir, bool report_crashes = true) {
+		public LinuxHostSession (owned LinuxHelper helper, owned TemporaryDirectory tempdir, bool report_crashes = true,
+				bool warm_agents = false) {
 			Object (
 				helper: helper,
 				tempdir: tempdir,
-				report_crashes: report_crashes
+				report_crashes: report_crashes,
+				warm_agents: warm_agents
 			);
 		}
 
@@ -63,11 +74,15 @@ namespace Frida {
 			var emulated_arm = Frida.Data.Agent.get_frida_agent_arm_so_blob ();
 			var emulated_arm64 = Frida.Data.Agent.get_frida_agent_arm64_so_blob ();
 			agent = new AgentDescriptor (PathTemplate ("frida-agent-<arch>.so"),
-				new Bytes.static (blob32.data),
-				new Bytes.static (blob64.data),
+				null,
+				null,
 				new AgentResource[] {
-					new AgentResource ("frida-agent-arm.so", new Bytes.static (emulated_arm.data), tempdir),
-					new AgentResource ("frida-agent-arm64.so", new Bytes.static (emulated_arm64.data), tempdir),
+					AgentResource.from_embedded ("frida-agent-32.so", blob32.data, blob32.uncompressed_size, tempdir),
+					AgentResource.from_embedded ("frida-agent-64.so", blob64.data, blob64.uncompressed_size, tempdir),
+					AgentResource.from_embedded ("frida-agent-arm.so", emulated_arm.data, emulated_arm.uncompressed_size,
+						tempdir),
+					AgentResource.from_embedded ("frida-agent-arm64.so", emulated_arm64.data,
+						emulated_arm64.uncompressed_size, tempdir),
 				},
 				AgentMode.INSTANCED,
 				tempdir);
@@ -89,6 +104,14 @@ namespace Frida {
 		}
 
 		public override async void preload (Cancellable? cancellable) throws Error, IOError {
+			if (warm_agents) {
+				try {
+					yield prewarm (cancellable);
+				} catch (Error e) {
+					printerr ("Unable to prewarm agents: %s\n", e.message);
+				}
+			}
+
 #if ANDROID
 			yield system_server_agent.preload (cancellable);
 
@@ -96,6 +119,22 @@ namespace Frida {
 #endif
 		}
 
+		private async void prewarm (Cancellable? cancellable) throws Error, IOError {
+			yield helper.prewarm (cancellable);
+
+#if HAVE_EMBEDDED_ASSETS
+			// Other architectures are rare enough that they are better off staying compressed until first used.
+			string name = agent.name_template.expand ((sizeof (void *) == 8) ? "64" : "32");
+			AgentResource? resource = agent.resources.first_match (r => r.name == name);
+			if (resource != null) {
+				if (MemoryFileDescriptor.is_supported ())
+					resource.get_memfd ();
+				else
+					resource.get_file ();
+			}
+#endif
+		}
+
 		public override async void close (Cancellable? cancellable) throws IOError {
 #if ANDROID
 			yield robo_launcher.close (cancellable);
@@ -381,6 +420,17 @@ namespace Frida {
 			return stream_request.future;
 		}
 
+		protected override void record_attach_phase (uint pid, string name, int64 start_time) {
+			if (injectee_by_pid.has_key (pid))
+				((Linjector) injector).record_injection_phase (injectee_by_pid[pid], name, start_time);
+		}
+
+		public async InjectionPhaseInfo[] query_injection_timeline (uint pid, Cancellable? cancellable) throws Error, IOError {
+			if (!injectee_by_pid.has_key (pid))
+				throw new Error.INVALID_ARGUMENT ("Not attached to pid %u", pid);
+			return yield ((Linjector) injector).query_injection_timeline (injectee_by_pid[pid], cancellable);
+		}
+
 		protected override string? get_emulated_agent_path (uint pid) throws Error {
 			unowned string name;
 			switch (cpu_type_from_pid (pid)) {
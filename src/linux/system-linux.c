@@ -4,22 +4,76 @@
 #include <string.h>
 #include <unistd.h>
 #include <gio/gunixmounts.h>
+#include <glib/gstdio.h>
+
+#define FRIDA_MAX_SCAN_WORKERS 8
+#define FRIDA_MIN_PIDS_PER_SCAN_WORKER 256
+#define FRIDA_MAX_PROCESS_SNAPSHOTS 64
+#define FRIDA_UID_NAMES_TTL (60 * G_USEC_PER_SEC)
 
 typedef struct _FridaEnumerateProcessesOperation FridaEnumerateProcessesOperation;
+typedef struct _FridaProcessScanner FridaProcessScanner;
+typedef struct _FridaProcessStamp FridaProcessStamp;
+typedef struct _FridaProcStat FridaProcStat;
 
 struct _FridaEnumerateProcessesOperation
 {
   FridaScope scope;
+  gboolean record_snapshot;
+  GHashTable * previous_snapshot;
+};
+
+struct _FridaProcessScanner
+{
+  FridaEnumerateProcessesOperation * op;
+  const guint * pids;
+  guint n_pids;
   GArray * result;
+  GPtrArray * stamps;
+};
+
+struct _FridaProcessStamp
+{
+  guint pid;
+  guint64 start_time;
+  gchar * name;
 };
 
-static void frida_collect_process_info (guint pid, FridaEnumerateProcessesOperation * op);
+struct _FridaProcStat
+{
+  gint ppid;
+  guint64 start_time;
+};
+
+static void frida_process_scanner_init (FridaProcessScanner * self, FridaEnumerateProcessesOperation * op, const guint * pids,
+    guint n_pids);
+static void frida_process_scanner_destroy (FridaProcessScanner * self);
+static gpointer frida_process_scanner_run (FridaProcessScanner * self);
+static void frida_process_scanner_collect (guint pid, FridaProcessScanner * self);
+static void frida_collect_selected_pid (guint pid, GArray * pids);
+static GHashTable * frida_take_process_snapshot (const gchar * name);
+static void frida_store_process_snapshot (const gchar * name, GHashTable * snapshot);
+static GHashTable * frida_process_snapshot_new (void);
+static FridaProcessStamp * frida_process_stamp_new (guint pid, guint64 start_time, const gchar * name);
+static void frida_process_stamp_free (FridaProcessStamp * stamp);
 static gboolean frida_is_directory_noexec (const gchar * directory);
 static gchar * frida_get_application_directory (void);
-static gboolean frida_add_process_metadata (GHashTable * parameters, const gchar * proc_entry_name);
+static gboolean frida_read_proc_stat (const gchar * proc_entry_name, FridaProcStat * stat);
+static gboolean frida_add_process_metadata (GHashTable * parameters, const gchar * proc_entry_name, const FridaProcStat * stat);
 static GDateTime * frida_query_boot_time (void);
+static void frida_refresh_uid_names (void);
 static GVariant * frida_uid_to_name (uid_t uid);
 
+static GMutex frida_process_snapshots_lock;
+static GHashTable * frida_process_snapshots = NULL;
+static GQueue frida_process_snapshot_names = G_QUEUE_INIT;
+
+static GMutex frida_uid_names_lock;
+static GHashTable * frida_uid_names = NULL;
+static GHashTable * frida_unresolved_uid_names = NULL;
+static gint64 frida_uid_names_expiry = 0;
+static gint64 frida_uid_names_passwd_mtime = 0;
+
 void
 frida_system_get_frontmost_application (FridaFrontmostQueryOptions * options, FridaHostApplicationInfo * result, GError ** error)
 {
@@ -41,19 +95,38 @@ FridaHostProcessInfo *
 frida_system_enumerate_processes (FridaProcessQueryOptions * options, int * result_length)
 {
   FridaEnumerateProcessesOperation op;
+  const gchar * snapshot_name = NULL;
+  GArray * pids, * result;
+  guint n_workers, i;
+  FridaProcessScanner * scanners;
+  GThread ** threads;
+  GHashTable * snapshot = NULL;
 
   op.scope = frida_process_query_options_get_scope (options);
-  op.result = g_array_new (FALSE, FALSE, sizeof (FridaHostProcessInfo));
+  op.record_snapshot = FALSE;
+  op.previous_snapshot = NULL;
+
+  if (op.scope != FRIDA_SCOPE_MINIMAL)
+    frida_refresh_uid_names ();
+
+  pids = g_array_new (FALSE, FALSE, sizeof (guint));
 
   if (frida_process_query_options_has_selected_pids (options))
   {
-    frida_process_query_options_enumerate_selected_pids (options, (GFunc) frida_collect_process_info, &op);
+    frida_process_query_options_enumerate_selected_pids (options, (GFunc) frida_collect_selected_pid, pids);
   }
   else
   {
     GDir * proc_dir;
     const gchar * proc_name;
 
+    snapshot_name = frida_process_query_options_get_snapshot (options);
+    if (snapshot_name != NULL)
+    {
+      op.record_snapshot = TRUE;
+      op.previous_snapshot = frida_take_process_snapshot (snapshot_name);
+    }
+
     proc_dir = g_dir_open ("/proc", 0, NULL);
 
     while ((proc_name = g_dir_read_name (proc_dir)) != NULL)
@@ -63,23 +136,144 @@ frida_system_enumerate_processes (FridaProcessQueryOptions * options, int * resu
 
       pid = strtoul (proc_name, &end, 10);
       if (*end == '\0')
-        frida_collect_process_info (pid, &op);
+        g_array_append_val (pids, pid);
     }
 
     g_dir_close (proc_dir);
   }
 
-  *result_length = op.result->len;
+  /*
+   * Each PID costs a handful of procfs open()/read() round-trips, so on busy
+   * hosts we fan out across a few threads once there are enough PIDs for it
+   * to pay off.
+   */
+  n_workers = MIN (MIN (g_get_num_processors (), FRIDA_MAX_SCAN_WORKERS), pids->len / FRIDA_MIN_PIDS_PER_SCAN_WORKER);
+  n_workers = MAX (n_workers, 1);
+
+  scanners = g_new (FridaProcessScanner, n_workers);
+  threads = g_newa (GThread *, n_workers);
+
+  for (i = 0; i != n_workers; i++)
+  {
+    guint first = (guint) (((guint64) pids->len * i) / n_workers);
+    guint last = (guint) (((guint64) pids->len * (i + 1)) / n_workers);
+
+    frida_process_scanner_init (&scanners[i], &op, &g_array_index (pids, guint, first), last - first);
+  }
+
+  for (i = 1; i != n_workers; i++)
+    threads[i] = g_thread_new ("frida-process-scanner", (GThreadFunc) frida_process_scanner_run, &scanners[i]);
+  frida_process_scanner_run (&scanners[0]);
+  for (i = 1; i != n_workers; i++)
+    g_thread_join (threads[i]);
+
+  result = g_array_new (FALSE, FALSE, sizeof (FridaHostProcessInfo));
+
+  if (op.record_snapshot)
+    snapshot = frida_process_snapshot_new ();
+
+  for (i = 0; i != n_workers; i++)
+  {
+    FridaProcessScanner * scanner = &scanners[i];
+
+    g_array_append_vals (result, scanner->result->data, scanner->result->len);
+
+    if (snapshot != NULL)
+    {
+      guint j;
+
+      for (j = 0; j != scanner->stamps->len; j++)
+      {
+        FridaProcessStamp * stamp = g_ptr_array_index (scanner->stamps, j);
+
+        g_hash_table_insert (snapshot, GUINT_TO_POINTER (stamp->pid), stamp);
+      }
+      g_ptr_array_set_free_func (scanner->stamps, NULL);
+    }
+
+    frida_process_scanner_destroy (scanner);
+  }
+
+  if (op.previous_snapshot != NULL)
+  {
+    GHashTableIter iter;
+    FridaProcessStamp * previous;
+
+    g_hash_table_iter_init (&iter, op.previous_snapshot);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &previous))
+    {
+      FridaProcessStamp * current;
+      FridaHostProcessInfo info = { 0, };
+
+      current = g_hash_table_lookup (snapshot, GUINT_TO_POINTER (previous->pid));
+      if (current != NULL && current->start_time == previous->start_time)
+        continue;
+
+      info.pid = previous->pid;
+      info.name = g_strdup (previous->name);
+      info.parameters = frida_make_parameters_dict ();
+      g_hash_table_insert (info.parameters, g_strdup ("vanished"), g_variant_ref_sink (g_variant_new_boolean (TRUE)));
+
+      g_array_append_val (result, info);
+    }
+
+    g_hash_table_unref (op.previous_snapshot);
+  }
+
+  if (op.record_snapshot)
+    frida_store_process_snapshot (snapshot_name, snapshot);
+
+  g_free (scanners);
+  g_array_free (pids, TRUE);
 
-  return (FridaHostProcessInfo *) g_array_free (op.result, FALSE);
+  *result_length = result->len;
+
+  return (FridaHostProcessInfo *) g_array_free (result, FALSE);
 }
 
 static void
-frida_collect_process_info (guint pid, FridaEnumerateProcessesOperation * op)
+frida_collect_selected_pid (guint pid, GArray * pids)
 {
+  g_array_append_val (pids, pid);
+}
+
+static void
+frida_process_scanner_init (FridaProcessScanner * self, FridaEnumerateProcessesOperation * op, const guint * pids, guint n_pids)
+{
+  self->op = op;
+  self->pids = pids;
+  self->n_pids = n_pids;
+  self->result = g_array_new (FALSE, FALSE, sizeof (FridaHostProcessInfo));
+  self->stamps = g_ptr_array_new_with_free_func ((GDestroyNotify) frida_process_stamp_free);
+}
+
+static void
+frida_process_scanner_destroy (FridaProcessScanner * self)
+{
+  g_ptr_array_unref (self->stamps);
+  g_array_free (self->result, TRUE);
+}
+
+static gpointer
+frida_process_scanner_run (FridaProcessScanner * self)
+{
+  guint i;
+
+  for (i = 0; i != self->n_pids; i++)
+    frida_process_scanner_collect (self->pids[i], self);
+
+  return NULL;
+}
+
+static void
+frida_process_scanner_collect (guint pid, FridaProcessScanner * self)
+{
+  FridaEnumerateProcessesOperation * op = self->op;
   FridaHostProcessInfo info = { 0, };
   gboolean still_alive = TRUE;
   gchar * proc_name = NULL;
+  FridaProcStat stat = { 0, };
+  gboolean need_stat;
   gchar * exe_path = NULL;
   gboolean is_userland;
   gchar * program_path = NULL;
@@ -89,6 +283,22 @@ frida_collect_process_info (guint pid, FridaEnumerateProcessesOperation * op)
 
   proc_name = g_strdup_printf ("%u", pid);
 
+  need_stat = op->record_snapshot || op->scope != FRIDA_SCOPE_MINIMAL;
+  if (need_stat && !frida_read_proc_stat (proc_name, &stat))
+    goto beach;
+
+  if (op->previous_snapshot != NULL)
+  {
+    FridaProcessStamp * previous;
+
+    previous = g_hash_table_lookup (op->previous_snapshot, GUINT_TO_POINTER (pid));
+    if (previous != NULL && previous->start_time == stat.start_time)
+    {
+      g_ptr_array_add (self->stamps, frida_process_stamp_new (pid, stat.start_time, previous->name));
+      goto beach;
+    }
+  }
+
   exe_path = g_build_filename ("/proc", proc_name, "exe", NULL);
 
   is_userland = g_file_test (exe_path, G_FILE_TEST_EXISTS);
@@ -128,13 +338,20 @@ frida_collect_process_info (guint pid, FridaEnumerateProcessesOperation * op)
     g_hash_table_insert (info.parameters, g_strdup ("path"),
         g_variant_ref_sink (g_variant_new_take_string (g_steal_pointer (&program_path))));
 
-    still_alive = frida_add_process_metadata (info.parameters, proc_name);
+    still_alive = frida_add_process_metadata (info.parameters, proc_name, &stat);
   }
 
   if (still_alive)
-    g_array_append_val (op->result, info);
+  {
+    if (op->record_snapshot)
+      g_ptr_array_add (self->stamps, frida_process_stamp_new (pid, stat.start_time, info.name));
+
+    g_array_append_val (self->result, info);
+  }
   else
+  {
     frida_host_process_info_destroy (&info);
+  }
 
 beach:
   g_free (name);
@@ -145,6 +362,80 @@ beach:
   g_free (proc_name);
 }
 
+static GHashTable *
+frida_take_process_snapshot (const gchar * name)
+{
+  GHashTable * snapshot = NULL;
+  gchar * key;
+  GList * link;
+
+  g_mutex_lock (&frida_process_snapshots_lock);
+
+  if (frida_process_snapshots != NULL &&
+      g_hash_table_steal_extended (frida_process_snapshots, name, (gpointer *) &key, (gpointer *) &snapshot))
+  {
+    g_free (key);
+
+    link = g_queue_find_custom (&frida_process_snapshot_names, name, (GCompareFunc) strcmp);
+    g_free (link->data);
+    g_queue_delete_link (&frida_process_snapshot_names, link);
+  }
+
+  g_mutex_unlock (&frida_process_snapshots_lock);
+
+  return snapshot;
+}
+
+static void
+frida_store_process_snapshot (const gchar * name, GHashTable * snapshot)
+{
+  g_mutex_lock (&frida_process_snapshots_lock);
+
+  if (frida_process_snapshots == NULL)
+  {
+    frida_process_snapshots = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+        (GDestroyNotify) g_hash_table_unref);
+  }
+
+  if (g_hash_table_replace (frida_process_snapshots, g_strdup (name), snapshot))
+    g_queue_push_tail (&frida_process_snapshot_names, g_strdup (name));
+
+  while (frida_process_snapshot_names.length > FRIDA_MAX_PROCESS_SNAPSHOTS)
+  {
+    gchar * oldest = g_queue_pop_head (&frida_process_snapshot_names);
+    g_hash_table_remove (frida_process_snapshots, oldest);
+    g_free (oldest);
+  }
+
+  g_mutex_unlock (&frida_process_snapshots_lock);
+}
+
+static GHashTable *
+frida_process_snapshot_new (void)
+{
+  return g_hash_table_new_full (NULL, NULL, NULL, (GDestroyNotify) frida_process_stamp_free);
+}
+
+static FridaProcessStamp *
+frida_process_stamp_new (guint pid, guint64 start_time, const gchar * name)
+{
+  FridaProcessStamp * stamp;
+
+  stamp = g_slice_new (FridaProcessStamp);
+  stamp->pid = pid;
+  stamp->start_time = start_time;
+  stamp->name = g_strdup (name);
+
+  return stamp;
+}
+
+static void
+frida_process_stamp_free (FridaProcessStamp * stamp)
+{
+  g_free (stamp->name);
+  g_slice_free (FridaProcessStamp, stamp);
+}
+
 void
 frida_system_kill (guint pid)
 {
@@ -211,48 +502,17 @@ frida_get_application_directory (void)
 }
 
 static gboolean
-frida_add_process_metadata (GHashTable * parameters, const gchar * proc_entry_name)
+frida_read_proc_stat (const gchar * proc_entry_name, FridaProcStat * stat)
 {
   gboolean success = FALSE;
-  gchar * status_path = NULL;
-  gchar * status_data = NULL;
-  gchar ** status_lines = NULL;
-  gchar ** cursor;
-  gchar * stat_path = NULL;
+  gchar * stat_path;
   gchar * stat_data = NULL;
-  int ppid;
-  guint64 start_time_delta_in_jiffies;
-  static gsize caches_initialized = 0;
-  static GDateTime * boot_time = NULL;
-  static long usec_per_jiffy = 0;
-  GDateTime * started;
-
-  status_path = g_build_filename ("/proc", proc_entry_name, "status", NULL);
-  if (!g_file_get_contents (status_path, &status_data, NULL, NULL))
-    goto beach;
-
-  status_lines = g_strsplit (status_data, "\n", 0);
-  for (cursor = status_lines; *cursor != NULL; cursor++)
-  {
-    const gchar * line = *cursor;
-
-    if (g_str_has_prefix (line, "Uid:"))
-    {
-      uid_t uid;
-
-      sscanf (line + 4, "%*u %u %*u %*u", &uid);
-
-      g_hash_table_insert (parameters, g_strdup ("user"), frida_uid_to_name (uid));
-
-      break;
-    }
-  }
 
   stat_path = g_build_filename ("/proc", proc_entry_name, "stat", NULL);
   if (!g_file_get_contents (stat_path, &stat_data, NULL, NULL))
     goto beach;
 
-  sscanf (stat_data,
+  success = sscanf (stat_data,
       "%*d "                       /* ( 1) pid         */
       "(%*[^)]) "                  /* ( 2) comm        */
       "%*c "                       /* ( 3) state       */
@@ -275,10 +535,45 @@ frida_add_process_metadata (GHashTable * parameters, const gchar * proc_entry_na
       "%*d "                       /* (20) num_threads */
       "%*d "                       /* (21) itrealvalue */
       "%" G_GINT64_MODIFIER "u ",  /* (22) starttime   */
-      &ppid,
-      &start_time_delta_in_jiffies);
+      &stat->ppid,
+      &stat->start_time) == 2;
+
+beach:
+  g_free (stat_data);
+  g_free (stat_path);
 
-  g_hash_table_insert (parameters, g_strdup ("ppid"), g_variant_ref_sink (g_variant_new_int64 (ppid)));
+  return success;
+}
+
+static gboolean
+frida_add_process_metadata (GHashTable * parameters, const gchar * proc_entry_name, const FridaProcStat * stat)
+{
+  gchar * status_path = NULL;
+  gchar * status_data = NULL;
+  const gchar * uid_line;
+  static gsize caches_initialized = 0;
+  static GDateTime * boot_time = NULL;
+  static long usec_per_jiffy = 0;
+  GDateTime * started;
+
+  status_path = g_build_filename ("/proc", proc_entry_name, "status", NULL);
+  g_file_get_contents (status_path, &status_data, NULL, NULL);
+  g_free (status_path);
+  if (status_data == NULL)
+    return FALSE;
+
+  uid_line = strstr (status_data, "\nUid:");
+  if (uid_line != NULL)
+  {
+    uid_t uid;
+
+    if (sscanf (uid_line + 5, "%*u %u", &uid) == 1)
+      g_hash_table_insert (parameters, g_strdup ("user"), frida_uid_to_name (uid));
+  }
+
+  g_free (status_data);
+
+  g_hash_table_insert (parameters, g_strdup ("ppid"), g_variant_ref_sink (g_variant_new_int64 (stat->ppid)));
 
   if (g_once_init_enter (&caches_initialized))
   {
@@ -288,21 +583,12 @@ frida_add_process_metadata (GHashTable * parameters, const gchar * proc_entry_na
     g_once_init_leave (&caches_initialized, TRUE);
   }
 
-  started = g_date_time_add (boot_time, start_time_delta_in_jiffies * usec_per_jiffy);
+  started = g_date_time_add (boot_time, stat->start_time * usec_per_jiffy);
   g_hash_table_insert (parameters, g_strdup ("started"),
       g_variant_ref_sink (g_variant_new_take_string (g_date_time_format_iso8601 (started))));
   g_date_time_unref (started);
 
-  success = TRUE;
-
-beach:
-  g_free (stat_data);
-  g_free (stat_path);
-  g_strfreev (status_lines);
-  g_free (status_data);
-  g_free (status_path);
-
-  return success;
+  return TRUE;
 }
 
 static GDateTime *
@@ -340,6 +626,40 @@ frida_query_boot_time (void)
   return boot_time;
 }
 
+/*
+ * Names are resolved through NSS, so a cached name may go stale without
+ * /etc/passwd changing. Drop everything when it does change or the cache
+ * grows old, and never keep numeric fallbacks beyond a single enumeration.
+ */
+static void
+frida_refresh_uid_names (void)
+{
+  GStatBuf st;
+  gint64 passwd_mtime, now;
+
+  passwd_mtime = (g_stat ("/etc/passwd", &st) == 0) ? (gint64) st.st_mtime : 0;
+  now = g_get_monotonic_time ();
+
+  g_mutex_lock (&frida_uid_names_lock);
+
+  if (frida_uid_names == NULL)
+  {
+    frida_uid_names = g_hash_table_new_full (NULL, NULL, NULL, (GDestroyNotify) g_variant_unref);
+    frida_unresolved_uid_names = g_hash_table_new_full (NULL, NULL, NULL, (GDestroyNotify) g_variant_unref);
+  }
+
+  if (now >= frida_uid_names_expiry || passwd_mtime != frida_uid_names_passwd_mtime)
+  {
+    g_hash_table_remove_all (frida_uid_names);
+    frida_uid_names_expiry = now + FRIDA_UID_NAMES_TTL;
+    frida_uid_names_passwd_mtime = passwd_mtime;
+  }
+
+  g_hash_table_remove_all (frida_unresolved_uid_names);
+
+  g_mutex_unlock (&frida_uid_names_lock);
+}
+
 static GVariant *
 frida_uid_to_name (uid_t uid)
 {
@@ -348,6 +668,14 @@ frida_uid_to_name (uid_t uid)
   char * buffer;
   struct passwd pwd, * entry;
 
+  g_mutex_lock (&frida_uid_names_lock);
+
+  name = g_hash_table_lookup (frida_uid_names, GUINT_TO_POINTER (uid));
+  if (name == NULL)
+    name = g_hash_table_lookup (frida_unresolved_uid_names, GUINT_TO_POINTER (uid));
+  if (name != NULL)
+    goto beach;
+
   if (buffer_size == 0)
     buffer_size = sysconf (_SC_GETPW_R_SIZE_MAX);
 
@@ -357,12 +685,22 @@ frida_uid_to_name (uid_t uid)
   getpwuid_r (uid, &pwd, buffer, buffer_size, &entry);
 
   if (entry != NULL)
-    name = g_variant_new_string (entry->pw_name);
+  {
+    name = g_variant_ref_sink (g_variant_new_string (entry->pw_name));
+    g_hash_table_insert (frida_uid_names, GUINT_TO_POINTER (uid), name);
+  }
   else
-    name = g_variant_new_take_string (g_strdup_printf ("%u", uid));
-  name = g_variant_ref_sink (name);
+  {
+    name = g_variant_ref_sink (g_variant_new_take_string (g_strdup_printf ("%u", uid)));
+    g_hash_table_insert (frida_unresolved_uid_names, GUINT_TO_POINTER (uid), name);
+  }
 
   g_free (buffer);
 
+beach:
+  g_variant_ref (name);
+
+  g_mutex_unlock (&frida_uid_names_lock);
+
   return name;
 }
@@ -8,14 +8,32 @@ namespace Frida {
 			default = "registry.npmjs.org";
 		}
 
+		public string cache_dir {
+			get;
+			set;
+		}
+
+		// Serve registry responses and tarballs from cache_dir only, never touching the network.
+		public bool offline {
+			get;
+			set;
+			default = false;
+		}
+
+		// Least recently used entries are pruned from cache_dir after each install to stay within this many bytes.
+		public uint64 cache_max_size {
+			get;
+			set;
+			default = 512 * 1024 * 1024;
+		}
+
 		private Soup.Session session;
+		private ThreadPool<ExtractJob>? extract_pool;
 
 		public PackageManager () {
-			string cache_dir = Path.build_filename (Environment.get_user_cache_dir (), "frida", "package-manager");
-			var cache = new Soup.Cache (cache_dir, Soup.CacheType.SINGLE_USER);
+			cache_dir = Path.build_filename (Environment.get_user_cache_dir (), "frida", "package-manager");
 			session = (Soup.Session) Object.new (typeof (Soup.Session),
 				"max-conns-per-host", 15);
-			session.add_feature (cache);
 		}
 
 		public async PackageSearchResult search (string query, PackageSearchOptions? options = null,
@@ -24,7 +42,7 @@ namespace Frida {
 
 			var text = string.join (" ", query, "keywords:frida-gum");
 			Json.Reader reader = yield fetch ("/-/v1/search?text=%s&from=%u&size=%u"
-				.printf (Uri.escape_string (text), opts.offset, opts.limit), cancellable);
+				.printf (Uri.escape_string (text), opts.offset, opts.limit), cancellable, NONE);
 
 			var packages = new Gee.ArrayList<Package> ();
 			reader.read_member ("objects");
@@ -93,7 +111,12 @@ namespace Frida {
 				throws Error, IOError {
 			install_progress (INITIALIZING, 0.0);
 
+			int64 install_start = get_monotonic_time ();
+
 			var opts = (options != null) ? options : new PackageInstallOptions ();
+			var pipeline = new ReifyPipeline (opts.max_concurrent_downloads);
+			int64 resolve_usec = 0;
+			int64 reify_usec = 0;
 
 			File project_root = compute_project_root (opts);
 			File pkg_json_file = project_root.get_child ("package.json");
@@ -115,28 +138,45 @@ namespace Frida {
 
 			if (lock_clean) {
 				var root = lock_to_graph (manifest, locked);
-				yield reify_graph (root, project_root, opts.omits, installed_packages, 0.05, 0.98, cancellable);
+
+				int64 reify_start = get_monotonic_time ();
+				yield reify_graph (root, project_root, opts.omits, installed_packages, pipeline, 0.05, 0.98, cancellable);
+				reify_usec = get_monotonic_time () - reify_start;
 			} else {
 				PackageNode? base_graph = null;
 				if (locked != null)
 					base_graph = lock_to_graph (manifest, locked);
 
+				int64 resolve_start = get_monotonic_time ();
 				var tree = yield build_tree (manifest, base_graph, cache, cancellable);
+				resolve_usec = get_monotonic_time () - resolve_start;
 
 				foreach (var orphan in tree.orphans)
 					yield FS.rmtree_async (install_dir_for_dependency (orphan, project_root), cancellable);
 
-				yield reify_graph (tree.root, project_root, opts.omits, installed_packages, 0.85, 0.98, cancellable);
+				int64 reify_start = get_monotonic_time ();
+				yield reify_graph (tree.root, project_root, opts.omits, installed_packages, pipeline, 0.85, 0.98,
+					cancellable);
+				reify_usec = get_monotonic_time () - reify_start;
 
 				yield write_manifest (manifest, pkg_json_file, cancellable);
 				yield write_lockfile (manifest, tree.root, lock_file, cancellable);
 			}
 
+			yield open_store ().prune (cache_max_size, cancellable);
+
 			install_progress (COMPLETE, 1.0);
 
 			installed_packages.sort ((a, b) => strcmp (a.name, b.name));
 
-			return new PackageInstallResult (new PackageList (installed_packages));
+			var timings = new PackageInstallTimings (
+				(uint64) resolve_usec,
+				(uint64) reify_usec,
+				(uint64) pipeline.download_usec,
+				(uint64) pipeline.extract_usec,
+				(uint64) (get_monotonic_time () - install_start));
+
+			return new PackageInstallResult (new PackageList (installed_packages), timings);
 		}
 
 		private async BuildTreeResult build_tree (Manifest manifest, PackageNode? base_node, PackageDataCache cache,
@@ -1071,8 +1111,8 @@ namespace Frida {
 		}
 
 		private async void reify_graph (PackageNode root, File project_root, Gee.Set<PackageRole> omits,
-				Gee.List<Package> installed_packages, double start_fraction, double end_fraction, Cancellable? cancellable)
-				throws Error, IOError {
+				Gee.List<Package> installed_packages, ReifyPipeline pipeline, double start_fraction, double end_fraction,
+				Cancellable? cancellable) throws Error, IOError {
 			var inner = new Cancellable ();
 
 			var source = new CancellableSource (cancellable);
@@ -1089,7 +1129,7 @@ namespace Frida {
 			double fraction_span = end_fraction - start_fraction;
 			Error? first_error = null;
 
-			perform_reify_graph (root, project_root, packages_to_install, null, futures, installed_packages, inner);
+			perform_reify_graph (root, project_root, packages_to_install, null, futures, installed_packages, pipeline, inner);
 
 			if (futures.is_empty)
 				return;
@@ -1118,6 +1158,54 @@ namespace Frida {
 				throw first_error;
 		}
 
+		private class ReifyPipeline {
+			public ConcurrencyLimiter download_slots;
+			public int64 download_usec = 0;
+			public int64 extract_usec = 0;
+
+			public ReifyPipeline (uint max_concurrent_downloads) {
+				download_slots = new ConcurrencyLimiter (max_concurrent_downloads);
+			}
+		}
+
+		private class ConcurrencyLimiter {
+			private uint available;
+			private Gee.Queue<Promise<bool>> waiters = new Gee.ArrayQueue<Promise<bool>> ();
+
+			public ConcurrencyLimiter (uint limit) {
+				available = uint.max (limit, 1);
+			}
+
+			public async void acquire (Cancellable? cancellable) throws IOError {
+				if (available != 0) {
+					available--;
+					return;
+				}
+
+				var slot = new Promise<bool> ();
+				waiters.offer (slot);
+				try {
+					yield slot.future.wait_async (cancellable);
+				} catch (Error e) {
+					assert_not_reached ();
+				} catch (IOError e) {
+					if (slot.future.ready)
+						release ();
+					else
+						waiters.remove (slot);
+					throw e;
+				}
+			}
+
+			public void release () {
+				Promise<bool>? next = waiters.poll ();
+				if (next != null)
+					next.resolve (true);
+				else
+					available++;
+			}
+		}
+
 		private static Gee.Set<string> compute_packages_to_install (Gee.Map<string, PackageNode> path_map,
 				Gee.Set<PackageRole> omits) throws Error {
 			var to_install = new Gee.HashSet<string> ();
@@ -1144,7 +1232,7 @@ namespace Frida {
 
 		private void perform_reify_graph (PackageNode node, File project_root, Gee.Set<string> packages_to_install,
 				Promise<bool>? prereq, Gee.List<Future<bool>> futures, Gee.List<Package> installed_packages,
-				Cancellable inner) {
+				ReifyPipeline pipeline, Cancellable inner) {
 			Promise<bool>? my_job = prereq;
 
 			string path = node.compute_path ();
@@ -1154,29 +1242,41 @@ namespace Frida {
 
 				var dir = install_dir_for_dependency (path, project_root);
 
-				perform_download_and_unpack.begin (node, dir, my_job, prereq, installed_packages, inner);
+				perform_download_and_unpack.begin (node, dir, my_job, prereq, installed_packages, pipeline, inner);
 			}
 
-			foreach (var child in node.children.values)
-				perform_reify_graph (child, project_root, packages_to_install, my_job, futures, installed_packages, inner);
+			foreach (var child in node.children.values) {
+				perform_reify_graph (child, project_root, packages_to_install, my_job, futures, installed_packages, pipeline,
+					inner);
+			}
 		}
 
 		private async void perform_download_and_unpack (PackageNode node, File dir, Promise<bool> job, Promise<bool>? prereq,
-				Gee.List<Package> installed_packages, Cancellable inner) {
+				Gee.List<Package> installed_packages, ReifyPipeline pipeline, Cancellable inner) {
+			TarballSource? tarball = null;
 			try {
-				if (prereq != null)
-					yield prereq.future.wait_async (inner);
-
 				string progress_details = "%s@%s".printf (node.name, node.version.str);
 
+				// Only extraction has to wait for the parent directory to be in place; the download can overlap.
 				Json.Reader? pkg = yield try_open_already_installed_manifest (node, dir, inner);
+				if (pkg == null)
+					tarball = yield fetch_tarball (node, pipeline, inner);
+
+				if (prereq != null) {
+					yield prereq.future.wait_async (inner);
+					pkg = yield try_open_already_installed_manifest (node, dir, inner);
+				}
+
 				bool was_installed = false;
 
 				if (pkg != null) {
 					install_progress (PACKAGE_ALREADY_INSTALLED, 1.0, progress_details);
 				} else {
-					yield download_and_unpack (node.name, node.version.str, node.resolved, dir, node.integrity,
-						node.shasum, inner);
+					if (tarball == null)
+						tarball = yield fetch_tarball (node, pipeline, inner);
+					TarballSource source = tarball;
+					tarball = null;
+					yield unpack_tarball (source, dir, pipeline, inner);
 					pkg = yield load_json (dir.get_child ("package.json"), inner);
 					install_progress (PACKAGE_INSTALLED, 1.0, progress_details);
 					was_installed = true;
@@ -1203,6 +1303,9 @@ namespace Frida {
 			} catch (GLib.Error e) {
 				job.reject (e);
 			}
+
+			if (tarball != null)
+				tarball.release ();
 		}
 
 		private static async Json.Reader? try_open_already_installed_manifest (PackageNode node, File dir, Cancellable? cancellable)
@@ -1668,7 +1771,7 @@ namespace Frida {
 				if (Semver.is_precise_range (version.range)) {
 					meta_reader = yield fetch (
 						"/%s/%s".printf (Uri.escape_string (name), Uri.escape_string (version.range)),
-						cancellable);
+						cancellable, IMMUTABLE);
 
 					meta_reader.read_member ("version");
 					var ver_val = meta_reader.get_string_value ();
@@ -2155,103 +2258,334 @@ namespace Frida {
 			b.end_array ();
 		}
 
-		private async void download_and_unpack (string name, string version, string tarball_url, File dest_root, string? integrity,
-				string? shasum, Cancellable? cancellable) throws Error, IOError {
-			string progress_details = "%s@%s".printf (name, version);
+		private async TarballSource fetch_tarball (PackageNode node, ReifyPipeline pipeline, Cancellable? cancellable)
+				throws Error, IOError {
+			string tarball_url = node.resolved;
+			string? integrity = node.integrity;
+			string? shasum = node.shasum;
+			string progress_details = "%s@%s".printf (node.name, node.version.str);
 			install_progress (DOWNLOADING_PACKAGE, 0.0, progress_details);
 
-			int io_priority = Priority.DEFAULT;
-
-			var tar_msg = new Soup.Message ("GET", tarball_url);
-			InputStream http_stream;
-			try {
-				http_stream = yield session.send_async (tar_msg, io_priority, cancellable);
-			} catch (GLib.Error e) {
-				throw new Error.TRANSPORT ("Failed to GET %s: %s", tarball_url, e.message);
-			}
-			if (tar_msg.status_code != 200)
-				throw new Error.PROTOCOL ("Failed to GET %s: HTTP %u", tarball_url, tar_msg.status_code);
-
-			ChecksumType algo = SHA1;
-			string? integrity_algo = null;
-			uint8[]? integrity_digest = null;
+			var source = new TarballSource (open_store (), tarball_url, shasum);
 			if (integrity != null) {
 				string[] tokens = integrity.split ("-", 2);
 				if (tokens.length != 2)
 					throw new Error.PROTOCOL ("Invalid integrity encoding");
-				integrity_algo = tokens[0];
-				switch (integrity_algo) {
-					case "md5":	algo = MD5;	break;
-					case "sha1":	algo = SHA1;	break;
-					case "sha256":	algo = SHA256;	break;
-					case "sha384":	algo = SHA384;	break;
-					case "sha512":	algo = SHA512;	break;
+				source.integrity_algo = tokens[0];
+				switch (source.integrity_algo) {
+					case "md5":	source.algo = MD5;	break;
+					case "sha1":	source.algo = SHA1;	break;
+					case "sha256":	source.algo = SHA256;	break;
+					case "sha384":	source.algo = SHA384;	break;
+					case "sha512":	source.algo = SHA512;	break;
 					default:
-						throw new Error.PROTOCOL ("Unsupported integrity algorithm %s", integrity_algo);
+						throw new Error.PROTOCOL ("Unsupported integrity algorithm %s", source.integrity_algo);
 				}
-				integrity_digest = Base64.decode (tokens[1]);
+				source.integrity_digest = Base64.decode (tokens[1]);
 			}
-			var checksum_converter = new ChecksumConverter (algo);
-			var checksum_input = new ConverterInputStream (http_stream, checksum_converter);
 
-			var gunzip_input = new ConverterInputStream (checksum_input, new ZlibDecompressor (GZIP));
+			var store = source.store;
+
+			if (integrity != null)
+				source.cache_entry = store.content_file (source.integrity_algo, hex_encode (source.integrity_digest));
+			else if (shasum != null)
+				source.cache_entry = store.content_file ("sha1", shasum.down ());
+
+			if (source.cache_entry != null && source.cache_entry.query_exists (cancellable)) {
+				source.file = source.cache_entry;
+				store.touch (source.file);
+				install_progress (DOWNLOADING_PACKAGE, 1.0, progress_details);
+				return source;
+			}
+
+			if (offline)
+				throw new Error.TRANSPORT ("Unable to GET %s: not cached and offline mode is enabled", tarball_url);
+			File downloaded = store.make_temp_file ();
+
+			yield pipeline.download_slots.acquire (cancellable);
+			int64 download_start = get_monotonic_time ();
+			try {
+				yield download_tarball (tarball_url, downloaded, progress_details, cancellable);
+			} finally {
+				pipeline.download_usec += get_monotonic_time () - download_start;
+				pipeline.download_slots.release ();
+			}
+
+			source.file = downloaded;
+			source.downloaded = downloaded;
+			return source;
+		}
+
+		private async void unpack_tarball (TarballSource source, File dest_root, ReifyPipeline pipeline,
+				Cancellable? cancellable) throws Error, IOError {
+			int io_priority = Priority.DEFAULT;
+
 			File temp_dest_root = dest_root.get_parent ().get_child (".fpm_" + dest_root.get_basename ());
-			yield FS.rmtree_async (temp_dest_root, cancellable);
-			var tar_reader = new TarStreamReader (temp_dest_root);
 
-			uint8 buffer[32 * 1024];
-			size_t read_total = 0;
-			size_t report_bucket = 0;
-			int64 content_len = tar_msg.get_response_headers ().get_content_length ();
+			var job = new ExtractJob () {
+				tarball = source.file,
+				tarball_url = source.url,
+				destination = temp_dest_root,
+				algo = source.algo,
+				integrity_algo = source.integrity_algo,
+				integrity_digest = source.integrity_digest,
+				shasum = source.shasum,
+				cancellable = cancellable,
+				main_context = MainContext.ref_thread_default (),
+				on_complete = unpack_tarball.callback,
+			};
+			get_extract_pool ().add (job);
+			yield;
+			pipeline.extract_usec += job.elapsed_usec;
 
-			while (true) {
-				ssize_t n = yield gunzip_input.read_async (buffer, io_priority, cancellable);
-				if (n == 0)
-					break;
-				if (n < 0)
-					throw new IOError.FAILED ("Stream read failed");
+			if (job.error != null) {
+				if (source.downloaded == null && job.integrity_failed)
+					source.store.discard (source.file);
+				source.release ();
+				throw_api_error (job.error);
+			}
 
-				try {
-					yield tar_reader.feed (buffer[:n], cancellable);
-				} catch (Error e) {
-					throw new Error.PROTOCOL ("Unable to extract tarball at %s: %s", tarball_url, e.message);
+			if (source.downloaded != null && source.cache_entry != null) {
+				source.store.commit (source.downloaded, source.cache_entry);
+				source.downloaded = null;
+			}
+			source.release ();
+
+			yield FS.rmtree_async (dest_root, cancellable);
+			try {
+				yield temp_dest_root.move_async (dest_root, FileCopyFlags.NONE, io_priority, cancellable, null);
+			} catch (GLib.Error e) {
+				throw new Error.PERMISSION_DENIED ("%s", e.message);
+			}
+		}
+
+		private class TarballSource {
+			public PackageStore store;
+			public string url;
+			public File file;
+			public File? cache_entry;
+			public File? downloaded;
+
+			public ChecksumType algo = SHA1;
+			public string? integrity_algo;
+			public uint8[]? integrity_digest;
+			public string? shasum;
+
+			public TarballSource (PackageStore store, string url, string? shasum) {
+				this.store = store;
+				this.url = url;
+				this.shasum = shasum;
+			}
+
+			public void release () {
+				if (downloaded != null) {
+					store.discard (downloaded);
+					downloaded = null;
 				}
-				read_total += (size_t) n;
-				report_bucket += (size_t) n;
+			}
+		}
+
+		private ThreadPool<ExtractJob> get_extract_pool () throws Error {
+			if (extract_pool == null) {
+				try {
+					extract_pool = new ThreadPool<ExtractJob>.with_owned_data (job => {
+							int64 start = get_monotonic_time ();
+							try {
+								extract_tarball (job);
+							} catch (GLib.Error e) {
+								job.error = e;
+							}
+							job.elapsed_usec = get_monotonic_time () - start;
 
-				if (content_len > 0 && report_bucket >= (1 << 20)) {
-					install_progress (DOWNLOADING_PACKAGE, (double) read_total / (double) content_len,
-						progress_details);
-					report_bucket = 0;
+							var source = new IdleSource ();
+							source.set_callback (() => {
+								job.on_complete ();
+								return Source.REMOVE;
+							});
+							source.attach (job.main_context);
+						}, (int) uint.max (get_num_processors (), 2), false);
+				} catch (ThreadError e) {
+					throw new Error.NOT_SUPPORTED ("Unable to create extraction threads: %s", e.message);
 				}
 			}
+			return extract_pool;
+		}
 
-			install_progress (DOWNLOADING_PACKAGE, (content_len > 0) ? 1.0 : -1.0, progress_details);
+		private class ExtractJob {
+			public File tarball;
+			public string tarball_url;
+			public File destination;
+			public ChecksumType algo;
+			public string? integrity_algo;
+			public uint8[]? integrity_digest;
+			public string? shasum;
+			public Cancellable? cancellable;
 
-			tar_reader.finish ();
+			public MainContext main_context;
+			public SourceFunc on_complete;
 
-			Error? checksum_error = null;
-			if (integrity != null) {
+			public GLib.Error? error;
+			public bool integrity_failed;
+			public int64 elapsed_usec;
+		}
+
+		// Runs on an extraction thread: hashing, gunzip and untar all happen here, off the main loop.
+		private static void extract_tarball (ExtractJob job) throws Error, IOError {
+			var cancellable = job.cancellable;
+
+			InputStream tarball_input;
+			try {
+				tarball_input = job.tarball.read (cancellable);
+			} catch (GLib.Error e) {
+				if (e is IOError.CANCELLED)
+					throw (IOError) e;
+				throw new Error.PERMISSION_DENIED ("%s", e.message);
+			}
+
+			var checksum_converter = new ChecksumConverter (job.algo);
+			var checksum_input = new ConverterInputStream (tarball_input, checksum_converter);
+
+			var gunzip_input = new ConverterInputStream (checksum_input, new ZlibDecompressor (GZIP));
+			FS.rmtree (job.destination, cancellable);
+			var tar_reader = new TarStreamReader (job.destination);
+
+			try {
+				uint8 buffer[32 * 1024];
+				while (true) {
+					ssize_t n;
+					try {
+						n = gunzip_input.read (buffer, cancellable);
+					} catch (GLib.Error e) {
+						if (e is IOError.CANCELLED)
+							throw (IOError) e;
+						throw new Error.PROTOCOL ("Unable to decompress tarball at %s: %s", job.tarball_url, e.message);
+					}
+					if (n == 0)
+						break;
+
+					try {
+						tar_reader.feed (buffer[:n], cancellable);
+					} catch (Error e) {
+						throw new Error.PROTOCOL ("Unable to extract tarball at %s: %s", job.tarball_url, e.message);
+					}
+				}
+
+				tar_reader.finish ();
+
+				if (!digest_matches (job, checksum_converter)) {
+					job.integrity_failed = true;
+					if (job.integrity_digest != null)
+						throw new Error.PROTOCOL ("Detected %s mismatch for %s", job.integrity_algo, job.tarball_url);
+					throw new Error.PROTOCOL ("Detected shasum mismatch for %s", job.tarball_url);
+				}
+			} catch (GLib.Error e) {
+				try {
+					FS.rmtree (job.destination);
+				} catch (Error cleanup_error) {
+				}
+
+				// A tarball that fails to decompress or untar is only corrupt if its digest says so; the failure
+				// could just as well be on the destination side.
+				bool verifiable = job.integrity_digest != null || job.shasum != null;
+				if (!job.integrity_failed && verifiable && !(e is IOError.CANCELLED)) {
+					try {
+						uint8 scratch[32 * 1024];
+						ssize_t n;
+						do {
+							n = checksum_input.read (scratch, cancellable);
+						} while (n != 0);
+						job.integrity_failed = !digest_matches (job, checksum_converter);
+					} catch (GLib.Error drain_error) {
+					}
+				}
+
+				throw_api_error (e);
+			}
+		}
+
+		private static bool digest_matches (ExtractJob job, ChecksumConverter checksum_converter) {
+			if (job.integrity_digest != null) {
 				uint8[] actual = checksum_converter.collect_raw_digest ();
-				if (actual.length != integrity_digest.length)
-					checksum_error = new Error.PROTOCOL ("Bad %s digest length for %s", integrity_algo, tarball_url);
-				else if (Memory.cmp (actual, integrity_digest, integrity_digest.length) != 0)
-					checksum_error = new Error.PROTOCOL ("Detected %s mismatch for %s", integrity_algo, tarball_url);
-			} else if (shasum != null) {
-				if (checksum_converter.collect_hex_digest () != shasum.down ())
-					checksum_error = new Error.PROTOCOL ("Detected shasum mismatch for %s", tarball_url);
+				return actual.length == job.integrity_digest.length &&
+					Memory.cmp (actual, job.integrity_digest, job.integrity_digest.length) == 0;
 			}
-			if (checksum_error != null) {
-				yield FS.rmtree_async (temp_dest_root);
-				throw checksum_error;
+
+			if (job.shasum != null)
+				return checksum_converter.collect_hex_digest () == job.shasum.down ();
+
+			return true;
+		}
+
+		private async void download_tarball (string tarball_url, File destination, string progress_details,
+				Cancellable? cancellable) throws Error, IOError {
+			int io_priority = Priority.DEFAULT;
+
+			var tar_msg = new Soup.Message ("GET", tarball_url);
+			InputStream http_stream;
+			try {
+				http_stream = yield session.send_async (tar_msg, io_priority, cancellable);
+			} catch (GLib.Error e) {
+				throw new Error.TRANSPORT ("Failed to GET %s: %s", tarball_url, e.message);
 			}
+			if (tar_msg.status_code != 200)
+				throw new Error.PROTOCOL ("Failed to GET %s: HTTP %u", tarball_url, tar_msg.status_code);
 
-			yield FS.rmtree_async (dest_root, cancellable);
+			OutputStream output;
 			try {
-				yield temp_dest_root.move_async (dest_root, FileCopyFlags.NONE, io_priority, cancellable, null);
+				output = yield destination.replace_async (null, false, FileCreateFlags.PRIVATE, io_priority, cancellable);
 			} catch (GLib.Error e) {
 				throw new Error.PERMISSION_DENIED ("%s", e.message);
 			}
+
+			uint8 buffer[32 * 1024];
+			size_t read_total = 0;
+			size_t report_bucket = 0;
+			int64 content_len = tar_msg.get_response_headers ().get_content_length ();
+
+			try {
+				while (true) {
+					ssize_t n;
+					try {
+						n = yield http_stream.read_async (buffer, io_priority, cancellable);
+					} catch (GLib.Error e) {
+						if (e is IOError.CANCELLED)
+							throw (IOError) e;
+						throw new Error.TRANSPORT ("Failed to GET %s: %s", tarball_url, e.message);
+					}
+					if (n == 0)
+						break;
+
+					try {
+						size_t bytes_written;
+						yield output.write_all_async (buffer[:n], io_priority, cancellable, out bytes_written);
+					} catch (GLib.Error e) {
+						if (e is IOError.CANCELLED)
+							throw (IOError) e;
+						throw new Error.PERMISSION_DENIED ("%s", e.message);
+					}
+					read_total += (size_t) n;
+					report_bucket += (size_t) n;
+
+					if (content_len > 0 && report_bucket >= (1 << 20)) {
+						install_progress (DOWNLOADING_PACKAGE, (double) read_total / (double) content_len,
+							progress_details);
+						report_bucket = 0;
+					}
+				}
+
+				try {
+					yield output.close_async (io_priority, cancellable);
+				} catch (GLib.Error e) {
+					if (e is IOError.CANCELLED)
+						throw (IOError) e;
+					throw new Error.PERMISSION_DENIED ("%s", e.message);
+				}
+			} catch (GLib.Error e) {
+				open_store ().discard (destination);
+				throw_api_error (e);
+			}
+
+			install_progress (DOWNLOADING_PACKAGE, (content_len > 0) ? 1.0 : -1.0, progress_details);
 		}
 
 		private static File compute_project_root (PackageInstallOptions options) {
@@ -2277,26 +2611,71 @@ namespace Frida {
 			}
 		}
 
-		private async Json.Reader fetch (string resource, Cancellable? cancellable) throws Error, IOError {
-			var root = yield fetch_node (resource, cancellable);
+		private async Json.Reader fetch (string resource, Cancellable? cancellable, ResponseCaching caching = REVALIDATE)
+				throws Error, IOError {
+			var root = yield fetch_node (resource, cancellable, caching);
 			return new Json.Reader (root);
 		}
 
-		private async Json.Node fetch_node (string resource, Cancellable? cancellable) throws Error, IOError {
-			string url = "https://%s%s".printf (registry, resource);
+		private async Json.Node fetch_node (string resource, Cancellable? cancellable, ResponseCaching caching = REVALIDATE)
+				throws Error, IOError {
+			string url = (registry.contains ("://") ? registry : "https://" + registry) + resource;
+
+			var store = open_store ();
+			PackageStore.CachedResponse? cached = null;
+			if (caching != NONE) {
+				cached = yield store.lookup_response (url, cancellable);
+				if (cached != null && (caching == IMMUTABLE || offline)) {
+					try {
+						return parse_registry_response (url, cached.body);
+					} catch (Error e) {
+						store.evict_response (url, cached);
+						cached = null;
+					}
+				}
+			}
+			if (offline)
+				throw new Error.TRANSPORT ("Unable to GET %s: not cached and offline mode is enabled", url);
+
 			install_progress (FETCHING_RESOURCE, -1.0, url);
 
 			Bytes bytes;
 			var msg = new Soup.Message ("GET", url);
 			msg.request_headers.append ("Accept", "application/vnd.npm.install-v1+json; q=1.0, application/json; q=0.8, */*");
+			if (cached != null) {
+				if (cached.etag != null)
+					msg.request_headers.append ("If-None-Match", cached.etag);
+				if (cached.last_modified != null)
+					msg.request_headers.append ("If-Modified-Since", cached.last_modified);
+			}
 			try {
 				bytes = yield session.send_and_read_async (msg, Priority.DEFAULT, cancellable);
 			} catch (GLib.Error e) {
 				throw new Error.TRANSPORT ("Unable to GET %s: %s", url, e.message);
 			}
+			if (msg.status_code == Soup.Status.NOT_MODIFIED && cached != null)
+				return parse_registry_response (url, cached.body);
 			if (msg.status_code != 200)
 				throw new Error.PROTOCOL ("Unable to GET %s: HTTP %u", url, msg.status_code);
 
+			var root = parse_registry_response (url, bytes);
+
+			if (caching != NONE) {
+				var headers = msg.get_response_headers ();
+				yield store.store_response (url, bytes, headers.get_one ("ETag"), headers.get_one ("Last-Modified"),
+					cancellable);
+			}
+
+			return root;
+		}
+
+		private enum ResponseCaching {
+			NONE,
+			REVALIDATE,
+			IMMUTABLE
+		}
+
+		private static Json.Node parse_registry_response (string url, Bytes bytes) throws Error {
 			var parser = new Json.Parser ();
 			try {
 				parser.load_from_data ((string) bytes.get_data (), (ssize_t) bytes.get_size ());
@@ -2307,6 +2686,10 @@ namespace Frida {
 			return parser.get_root ();
 		}
 
+		private PackageStore open_store () {
+			return new PackageStore (File.new_for_path (cache_dir));
+		}
+
 		private T create<T> () {
 			return Object.new (typeof (T), parent: this);
 		}
@@ -2438,6 +2821,12 @@ namespace Frida {
 			default = RUNTIME;
 		}
 
+		public uint max_concurrent_downloads {
+			get;
+			set;
+			default = 16;
+		}
+
 		public void clear_specs () {
 			specs.clear ();
 		}
@@ -2461,9 +2850,264 @@ namespace Frida {
 			construct;
 		}
 
-		internal PackageInstallResult (PackageList packages) {
-			Object (packages: packages);
+		public PackageInstallTimings timings {
+			get;
+			construct;
+		}
+
+		internal PackageInstallResult (PackageList packages, PackageInstallTimings timings) {
+			Object (packages: packages, timings: timings);
+		}
+	}
+
+	public sealed class PackageInstallTimings : Object {
+		// Wall-clock time spent resolving the dependency tree. Zero when a clean lockfile was used.
+		public uint64 resolve_usec {
+			get;
+			construct;
+		}
+
+		// Wall-clock time spent downloading and extracting packages.
+		public uint64 reify_usec {
+			get;
+			construct;
+		}
+
+		// Time spent downloading tarballs, summed across concurrent downloads.
+		public uint64 download_usec {
+			get;
+			construct;
+		}
+
+		// Time spent hashing, decompressing and extracting tarballs, summed across extraction threads.
+		public uint64 extract_usec {
+			get;
+			construct;
+		}
+
+		public uint64 total_usec {
+			get;
+			construct;
+		}
+
+		internal PackageInstallTimings (uint64 resolve_usec, uint64 reify_usec, uint64 download_usec, uint64 extract_usec,
+				uint64 total_usec) {
+			Object (
+				resolve_usec: resolve_usec,
+				reify_usec: reify_usec,
+				download_usec: download_usec,
+				extract_usec: extract_usec,
+				total_usec: total_usec
+			);
+		}
+	}
+
+	/*
+	 * Layout:
+	 *   content/<algo>/<hex digest>  Content-addressed blobs: tarballs keyed by their integrity, responses by SHA-256.
+	 *   index/<sha256 of url>.json  Registry response metadata: url, content digest, ETag and Last-Modified.
+	 *   tmp/                         Downloads in progress, moved into content/ once verified.
+	 *
+	 * Blobs are pruned least recently used first. An index entry whose blob is gone or fails its digest is a miss.
+	 */
+	private class PackageStore {
+		private File root;
+
+		public PackageStore (File root) {
+			this.root = root;
+		}
+
+		public File content_file (string algo, string hex_digest) {
+			return root.get_child ("content").get_child (algo).get_child (hex_digest);
 		}
+
+		public File make_temp_file () throws Error {
+			File dir = root.get_child ("tmp");
+			FS.mkdirp (dir);
+			return dir.get_child ("%08x%08x".printf (Random.next_int (), Random.next_int ()));
+		}
+
+		public void commit (File temp_file, File destination) {
+			try {
+				FS.mkdirp (destination.get_parent ());
+				temp_file.move (destination, OVERWRITE);
+			} catch (GLib.Error e) {
+				discard (temp_file);
+			}
+		}
+
+		public void discard (File file) {
+			try {
+				file.delete ();
+			} catch (GLib.Error e) {
+			}
+		}
+
+		public async CachedResponse? lookup_response (string url, Cancellable? cancellable) throws IOError {
+			try {
+				Bytes raw_meta = yield FS.read_all_bytes (index_file (url), cancellable);
+				Json.Reader r = parse_json (raw_meta);
+
+				r.read_member ("url");
+				string? stored_url = r.get_string_value ();
+				r.end_member ();
+				if (stored_url != url)
+					return null;
+
+				r.read_member ("content");
+				string? digest = r.get_string_value ();
+				r.end_member ();
+				if (digest == null)
+					return null;
+
+				r.read_member ("etag");
+				string? etag = r.get_string_value ();
+				r.end_member ();
+
+				r.read_member ("lastModified");
+				string? last_modified = r.get_string_value ();
+				r.end_member ();
+
+				File blob = content_file ("sha256", digest);
+				Bytes body = yield FS.read_all_bytes (blob, cancellable);
+
+				var response = new CachedResponse (body, digest, etag, last_modified);
+				if (Checksum.compute_for_bytes (SHA256, body) != digest) {
+					evict_response (url, response);
+					return null;
+				}
+
+				touch (blob);
+
+				return response;
+			} catch (Error e) {
+				return null;
+			}
+		}
+
+		public void evict_response (string url, CachedResponse response) {
+			discard (index_file (url));
+			discard (content_file ("sha256", response.digest));
+		}
+
+		public void touch (File file) {
+			try {
+				file.set_attribute_uint64 (FileAttribute.TIME_MODIFIED, (uint64) (get_real_time () / 1000000),
+					NOFOLLOW_SYMLINKS);
+			} catch (GLib.Error e) {
+			}
+		}
+
+		public async void prune (uint64 max_size, Cancellable? cancellable) throws IOError {
+			var entries = new Gee.ArrayList<ContentEntry> ();
+			uint64 total_size = 0;
+
+			try {
+				File content_dir = root.get_child ("content");
+				string attributes = FileAttribute.STANDARD_NAME + "," + FileAttribute.STANDARD_TYPE + "," +
+					FileAttribute.STANDARD_SIZE + "," + FileAttribute.TIME_MODIFIED;
+
+				var algo_dirs = yield content_dir.enumerate_children_async (FileAttribute.STANDARD_NAME, NOFOLLOW_SYMLINKS,
+					Priority.DEFAULT, cancellable);
+				FileInfo? algo_info;
+				while ((algo_info = algo_dirs.next_file (cancellable)) != null) {
+					File algo_dir = content_dir.get_child (algo_info.get_name ());
+
+					var blobs = yield algo_dir.enumerate_children_async (attributes, NOFOLLOW_SYMLINKS, Priority.DEFAULT,
+						cancellable);
+					FileInfo? info;
+					while ((info = blobs.next_file (cancellable)) != null) {
+						if (info.get_file_type () != REGULAR)
+							continue;
+						var entry = new ContentEntry () {
+							file = algo_dir.get_child (info.get_name ()),
+							size = info.get_size (),
+							mtime = info.get_attribute_uint64 (FileAttribute.TIME_MODIFIED),
+						};
+						entries.add (entry);
+						total_size += entry.size;
+					}
+				}
+			} catch (GLib.Error e) {
+				if (e is IOError.CANCELLED)
+					throw (IOError) e;
+				return;
+			}
+
+			if (total_size <= max_size)
+				return;
+
+			entries.sort ((a, b) => (a.mtime < b.mtime) ? -1 : ((a.mtime > b.mtime) ? 1 : 0));
+			foreach (var entry in entries) {
+				if (total_size <= max_size)
+					break;
+				discard (entry.file);
+				total_size -= entry.size;
+			}
+		}
+
+		private class ContentEntry {
+			public File file;
+			public uint64 size;
+			public uint64 mtime;
+		}
+
+		public async void store_response (string url, Bytes body, string? etag, string? last_modified,
+				Cancellable? cancellable) throws IOError {
+			string digest = Checksum.compute_for_bytes (SHA256, body);
+
+			var b = new Json.Builder ();
+			b
+				.begin_object ()
+				.set_member_name ("url")
+				.add_string_value (url)
+				.set_member_name ("content")
+				.add_string_value (digest);
+			if (etag != null)
+				b.set_member_name ("etag").add_string_value (etag);
+			if (last_modified != null)
+				b.set_member_name ("lastModified").add_string_value (last_modified);
+			b.end_object ();
+
+			try {
+				File blob = content_file ("sha256", digest);
+				if (!blob.query_exists (cancellable)) {
+					FS.mkdirp (blob.get_parent (), cancellable);
+					yield FS.write_all_bytes (blob, body, cancellable);
+				}
+
+				File index = index_file (url);
+				FS.mkdirp (index.get_parent (), cancellable);
+				yield FS.write_all_text (index, Json.to_string (b.get_root (), false), cancellable);
+			} catch (Error e) {
+				// Caching is best-effort; the response itself was fine.
+			}
+		}
+
+		private File index_file (string url) {
+			return root.get_child ("index").get_child (Checksum.compute_for_string (SHA256, url) + ".json");
+		}
+
+		public class CachedResponse {
+			public Bytes body;
+			public string digest;
+			public string? etag;
+			public string? last_modified;
+
+			public CachedResponse (Bytes body, string digest, string? etag, string? last_modified) {
+				this.body = body;
+				this.digest = digest;
+				this.etag = etag;
+				this.last_modified = last_modified;
+			}
+		}
+	}
+
+	private string hex_encode (uint8[] data) {
+		var result = new StringBuilder.sized (data.length * 2);
+		foreach (uint8 b in data)
+			result.append_printf ("%02x", b);
+		return result.str;
 	}
 
 	private class ChecksumConverter : Object, Converter {
@@ -3088,9 +3732,7 @@ namespace Frida {
 			this.root = root;
 		}
 
-		public async void feed (uint8[] data, Cancellable? cancellable) throws Error, IOError {
-			int io_priority = Priority.DEFAULT;
-
+		public void feed (uint8[] data, Cancellable? cancellable) throws Error, IOError {
 			size_t off = 0;
 			size_t len = data.length;
 			while (off < len) {
@@ -3098,8 +3740,7 @@ namespace Frida {
 					size_t chunk_size = size_t.min ((size_t) remaining, len - off);
 					if (out_stream != null) {
 						try {
-							yield out_stream.write_all_async (data[off:off + chunk_size], io_priority,
-								cancellable, null);
+							out_stream.write_all (data[off:off + chunk_size], null, cancellable);
 						} catch (GLib.Error e) {
 							throw new Error.TRANSPORT ("%s", e.message);
 						}
@@ -3110,7 +3751,7 @@ namespace Frida {
 					if (remaining == 0) {
 						if (out_stream != null) {
 							try {
-								yield out_stream.close_async (io_priority, cancellable);
+								out_stream.close (cancellable);
 							} catch (GLib.Error e) {
 								throw new Error.TRANSPORT ("%s", e.message);
 							}
@@ -3120,8 +3761,8 @@ namespace Frida {
 								var info = new FileInfo ();
 								info.set_attribute_uint32 (FileAttribute.UNIX_MODE,
 									current_file_mode & 0777);
-								yield current_file.set_attributes_async (info, FileQueryInfoFlags.NONE,
-									Priority.DEFAULT, cancellable, out info);
+								current_file.set_attributes_from_info (info, FileQueryInfoFlags.NONE,
+									cancellable);
 							} catch (GLib.Error e) {
 							}
 #endif
@@ -3177,8 +3818,7 @@ namespace Frida {
 					current_file_mode = file_mode;
 					FS.mkdirp (current_file.get_parent (), cancellable);
 					try {
-						out_stream = yield current_file.replace_async (null, false, FileCreateFlags.NONE,
-							io_priority, cancellable);
+						out_stream = current_file.replace (null, false, FileCreateFlags.NONE, cancellable);
 					} catch (GLib.Error e) {
 						throw new Error.TRANSPORT ("%s", e.message);
 					}
@@ -575,6 +575,8 @@ namespace Frida {
 
 		private HostProcessInfo[] enumerate_processes (HashTable<string, Variant> options, ControlChannel requester) throws Error {
 			var opts = ProcessQueryOptions._deserialize (options);
+			if (opts.snapshot != null)
+				throw new Error.NOT_SUPPORTED ("Process snapshots are not supported by the portal");
 			var scope = opts.scope;
 
 			Gee.List<Application> apps = new Gee.ArrayList<Application> ();
@@ -68,6 +68,7 @@ namespace Frida {
 			string? origin = null;
 			string? token = null;
 			int keepalive_interval = -1;
+			var endpoint_params = new EndpointParameters ();
 			if (options != null) {
 				var opts = options.map;
 
@@ -90,6 +91,14 @@ namespace Frida {
 				Value? keepalive_interval_val = opts["keepalive_interval"];
 				if (keepalive_interval_val != null)
 					keepalive_interval = keepalive_interval_val.get_int ();
+
+				Value? max_frame_size_val = opts["max_frame_size"];
+				if (max_frame_size_val != null)
+					endpoint_params.max_frame_size = max_frame_size_val.get_uint ();
+
+				Value? compression_val = opts["compression"];
+				if (compression_val != null)
+					endpoint_params.compression = (WebCompression) compression_val.get_enum ();
 			}
 			SocketConnectable connectable = parse_control_address (raw_address);
 
@@ -136,7 +145,7 @@ namespace Frida {
 			var transport = (certificate != null) ? WebServiceTransport.TLS : WebServiceTransport.PLAIN;
 			string host = (raw_address != null) ? raw_address : "lolcathost";
 
-			stream = yield negotiate_connection (stream, transport, host, origin, cancellable);
+			stream = yield negotiate_connection (stream, transport, host, origin, endpoint_params, cancellable);
 
 			DBusConnection connection;
 			try {
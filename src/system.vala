@@ -71,8 +71,13 @@ namespace Frida {
 	public sealed class ProcessEnumerator : Object {
 		private ThreadPool<EnumerateRequest> pool;
 		private MainContext main_context;
+		private uint snapshot_scope;
+
+		private static uint next_snapshot_scope = 1;
 
 		construct {
+			snapshot_scope = AtomicUint.add (ref next_snapshot_scope, 1);
+
 			try {
 				pool = new ThreadPool<EnumerateRequest>.with_owned_data (handle_request, 1, false);
 			} catch (ThreadError e) {
@@ -82,7 +87,17 @@ namespace Frida {
 			main_context = MainContext.ref_thread_default ();
 		}
 
-		public async HostProcessInfo[] enumerate_processes (ProcessQueryOptions options) {
+		public async HostProcessInfo[] enumerate_processes (ProcessQueryOptions options) throws Error {
+			if (options.snapshot != null) {
+#if LINUX
+				var scoped_options = ProcessQueryOptions._deserialize (options._serialize ());
+				scoped_options.snapshot = "%u/%s".printf (snapshot_scope, options.snapshot);
+				options = scoped_options;
+#else
+				throw new Error.NOT_SUPPORTED ("Process snapshots are not supported on this OS");
+#endif
+			}
+
 			var request = new EnumerateRequest (options, enumerate_processes.callback);
 			try {
 				pool.add (request);
@@ -81,6 +81,8 @@ namespace Frida.Test {
 #endif
 		Frida.HostSessionTest.add_tests ();
 
+		Frida.PackageManagerTest.add_tests ();
+
 #if HAVE_COMPILER_BACKEND && !QNX
 		Frida.CompilerTest.add_tests ();
 #endif
@@ -10,6 +10,28 @@ namespace Frida.AgentTest {
 			h.run ();
 		});
 
+		GLib.Test.add_func ("/Agent/MessageTransmitter/flush-by-size", Transmitter.flush_by_size);
+		GLib.Test.add_func ("/Agent/MessageTransmitter/flush-by-timeout", Transmitter.flush_by_timeout);
+		GLib.Test.add_func ("/Agent/MessageTransmitter/compressed-batch-round-trip", Transmitter.compressed_batch_round_trip);
+		GLib.Test.add_func ("/Agent/MessageTransmitter/compressed-batch-size-is-bounded",
+			Transmitter.compressed_batch_size_is_bounded);
+		GLib.Test.add_func ("/Agent/MessageTransmitter/credit-window", Transmitter.credit_window);
+		GLib.Test.add_func ("/Agent/MessageTransmitter/overflow/drop-oldest", Transmitter.overflow_drop_oldest);
+		GLib.Test.add_func ("/Agent/MessageTransmitter/overflow/drop-newest", Transmitter.overflow_drop_newest);
+		GLib.Test.add_func ("/Agent/MessageTransmitter/overflow/sample", Transmitter.overflow_sample);
+		GLib.Test.add_func ("/Agent/MessageTransmitter/routed-script-keeps-its-path", Transmitter.routed_script_keeps_its_path);
+
+#if LINUX
+		GLib.Test.add_func ("/Agent/MessageTransport/ring-completes-after-consumption",
+			MessageTransport.ring_completes_after_consumption);
+		GLib.Test.add_func ("/Agent/MessageTransport/ring-orders-oversized-fallback",
+			MessageTransport.ring_orders_oversized_fallback);
+		GLib.Test.add_func ("/Agent/MessageTransport/ring-falls-back-on-corrupt-record",
+			MessageTransport.ring_falls_back_on_corrupt_record);
+		GLib.Test.add_func ("/Agent/MessageTransport/ring-falls-back-when-closed", MessageTransport.ring_falls_back_when_closed);
+		GLib.Test.add_func ("/Agent/MessageTransport/ring-vs-dbus", MessageTransport.ring_vs_dbus);
+#endif
+
 #if DARWIN
 		GLib.Test.add_func ("/Agent/Script/Darwin/launch-scenario", () => {
 			var h = new Harness ((h) => Script.launch_scenario.begin (h as Harness));
@@ -23,6 +45,831 @@ namespace Frida.AgentTest {
 #endif
 	}
 
+	namespace Transmitter {
+		private static void flush_by_size () {
+			var loop = new MainLoop ();
+			perform_flush_by_size.begin (loop);
+			loop.run ();
+		}
+
+		private static async void perform_flush_by_size (MainLoop loop) {
+			var options = new SessionOptions ();
+			options.message_batch_size = 4;
+			options.message_flush_latency = 60000;
+
+			var sink = new RecordingSink ();
+			var session = new StubAgentSession ();
+			var transmitter = make_transmitter (session, sink, options);
+
+			for (uint i = 0; i != 8; i++)
+				transmitter.post_message_from_script (AgentScriptId (1), "{\"n\":%u}".printf (i), null);
+			assert_true (sink.batches.size == 2);
+			assert_true (sink.batches[0].size == 4);
+			assert_true (sink.batches[1].size == 4);
+			assert_true (sink.batches[1][3] == "{\"n\":7}");
+
+			transmitter.post_message_from_script (AgentScriptId (1), "{\"n\":8}", null);
+			assert_true (sink.batches.size == 2);
+
+			yield transmitter.close (null);
+
+			loop.quit ();
+		}
+
+		private static void flush_by_timeout () {
+			var loop = new MainLoop ();
+			perform_flush_by_timeout.begin (loop);
+			loop.run ();
+		}
+
+		private static async void perform_flush_by_timeout (MainLoop loop) {
+			var options = new SessionOptions ();
+			options.message_flush_latency = 50;
+
+			var sink = new RecordingSink ();
+			var session = new StubAgentSession ();
+			var transmitter = make_transmitter (session, sink, options);
+
+			var timer = new Timer ();
+			for (uint i = 0; i != 3; i++)
+				transmitter.post_message_from_script (AgentScriptId (1), "{\"n\":%u}".printf (i), null);
+			assert_true (sink.batches.is_empty);
+
+			try {
+				yield sink.wait_for_batches (1);
+			} catch (GLib.Error e) {
+				assert_not_reached ();
+			}
+			assert_true (timer.elapsed () >= 0.04);
+			assert_true (sink.batches.size == 1);
+			assert_true (sink.batches[0].size == 3);
+
+			yield transmitter.close (null);
+
+			loop.quit ();
+		}
+
+		private static void compressed_batch_round_trip () {
+			var payload = new uint8[8192];
+			for (uint i = 0; i != payload.length; i++)
+				payload[i] = (uint8) (i % 7);
+			var text = string.nfill (1024, 'x');
+
+			var messages = new AgentMessage[] {
+				AgentMessage (SCRIPT, AgentScriptId (1), "{\"type\":\"send\"}", true, payload),
+				AgentMessage (DEBUGGER, AgentScriptId (2), text, false, new uint8[0]),
+				AgentMessage (SCRIPT, AgentScriptId (3), "{}", true, new uint8[0]),
+			};
+			size_t size = payload.length + text.length;
+
+			assert_null (AgentMessageBatch.try_compress (messages, size, NONE));
+			assert_null (AgentMessageBatch.try_compress (messages[2:3], 2, ZLIB));
+
+			AgentMessage[]? compressed = AgentMessageBatch.try_compress (messages, size, ZLIB);
+			assert_nonnull (compressed);
+			assert_true (compressed.length == 1);
+			assert_true (compressed[0].kind == COMPRESSED_BATCH);
+			assert_true (compressed[0].data.length < size);
+
+			uint n = 0;
+			try {
+				AgentMessageBatch.decompress (compressed[0], (kind, script_id, t, data) => {
+					AgentMessage * expected = &messages[n++];
+					assert_true (kind == expected->kind);
+					assert_true (script_id.handle == expected->script_id.handle);
+					assert_true (t == expected->text);
+					assert_true ((data != null) == expected->has_data);
+					if (data != null)
+						assert_true (data.compare (new Bytes (expected->data)) == 0);
+				});
+			} catch (Error e) {
+				printerr ("\nFAIL: %s\n\n", e.message);
+				assert_not_reached ();
+			}
+			assert_true (n == messages.length);
+
+			var random = new uint8[8192];
+			for (uint i = 0; i != random.length; i++)
+				random[i] = (uint8) Random.next_int ();
+			assert_null (AgentMessageBatch.try_compress ({ AgentMessage (SCRIPT, AgentScriptId (1), "{}", true, random) },
+				random.length, ZLIB));
+		}
+
+		private static void credit_window () {
+			var loop = new MainLoop ();
+			perform_credit_window.begin (loop);
+			loop.run ();
+		}
+
+		private static async void perform_credit_window (MainLoop loop) {
+			var options = new SessionOptions ();
+			options.message_window_messages = 2;
+
+			var sink = new GatedSink ();
+			var session = new StubAgentSession ();
+			var transmitter = make_transmitter (session, sink, options);
+
+			for (uint i = 0; i != 10; i++)
+				transmitter.post_message_from_script (AgentScriptId (1), make_numbered_message (i), null);
+			assert_true (sink.received.size == 2);
+			assert_true (sink.max_outstanding == 2);
+
+			sink.open ();
+			try {
+				yield sink.wait_for_messages (10);
+			} catch (GLib.Error e) {
+				assert_not_reached ();
+			}
+			assert_true (sink.max_outstanding <= 2);
+			for (uint i = 0; i != 10; i++)
+				assert_true (sink.received[(int) i] == make_numbered_message (i));
+
+			yield transmitter.close (null);
+
+			loop.quit ();
+		}
+
+		private static void overflow_drop_oldest () {
+			check_overflow_policy (DROP_OLDEST, { 7, 8, 9, 10 });
+		}
+
+		private static void overflow_drop_newest () {
+			check_overflow_policy (DROP_NEWEST, { 1, 2, 3, 4 });
+		}
+
+		private static void overflow_sample () {
+			check_overflow_policy (SAMPLE, { 2, 3, 4, 5 });
+		}
+
+		private static void check_overflow_policy (MessageOverflowPolicy policy, uint[] expected_queued) {
+			var loop = new MainLoop ();
+			perform_overflow_check.begin (policy, expected_queued, loop);
+			loop.run ();
+		}
+
+		private static async void perform_overflow_check (MessageOverflowPolicy policy, uint[] expected_queued,
+				MainLoop loop) {
+			size_t message_size = sizeof (AgentMessage) + make_numbered_message (0).length + 1;
+
+			var options = new SessionOptions ();
+			options.message_window_messages = 1;
+			options.message_queue_limit = (uint) (4 * message_size);
+			options.message_overflow_policy = policy;
+
+			var sink = new GatedSink ();
+			var session = new StubAgentSession ();
+			var transmitter = make_transmitter (session, sink, options);
+
+			uint pressure_changes = 0;
+			transmitter.queue_pressure_changed.connect (() => {
+				pressure_changes++;
+			});
+
+			for (uint i = 0; i != 11; i++)
+				transmitter.post_message_from_script (AgentScriptId (1), make_numbered_message (i), null);
+			assert_true (sink.received.size == 1);
+			assert_true (transmitter.queued_bytes == 4 * message_size);
+			assert_true (transmitter.dropped_messages == 6);
+			assert_true (transmitter.under_pressure);
+			assert_true (pressure_changes == 1);
+
+			transmitter.post_message_from_script (AgentScriptId (1), string.nfill (5 * message_size, 'x'), null);
+			assert_true (transmitter.queued_bytes == 4 * message_size);
+			assert_true (transmitter.dropped_messages == 7);
+
+			sink.open ();
+			try {
+				yield sink.wait_for_messages (1 + expected_queued.length);
+			} catch (GLib.Error e) {
+				assert_not_reached ();
+			}
+			assert_true (sink.received[0] == make_numbered_message (0));
+			for (int i = 0; i != expected_queued.length; i++)
+				assert_true (sink.received[1 + i] == make_numbered_message (expected_queued[i]));
+			assert_false (transmitter.under_pressure);
+			assert_true (pressure_changes == 2);
+
+			yield transmitter.close (null);
+
+			loop.quit ();
+		}
+
+		private static string make_numbered_message (uint n) {
+			return "{\"n\":%02u}".printf (n);
+		}
+
+		private static void routed_script_keeps_its_path () {
+			var loop = new MainLoop ();
+			perform_routed_script_keeps_its_path.begin (loop);
+			loop.run ();
+		}
+
+		private static async void perform_routed_script_keeps_its_path (MainLoop loop) {
+			var sink = new GatedSink ();
+			var session = new StubAgentSession ();
+			var transmitter = make_transmitter (session, sink, new SessionOptions ());
+
+			var script_options = new ScriptOptions ();
+			script_options.message_delivery = LOSSY;
+			transmitter.configure_script (AgentScriptId (1), script_options);
+
+			for (uint i = 0; i != 4; i++)
+				transmitter.post_message_from_script (AgentScriptId (1), make_numbered_message (i), null);
+			transmitter.forget_script (AgentScriptId (1));
+			transmitter.configure_script (AgentScriptId (1), script_options);
+			for (uint i = 4; i != 8; i++)
+				transmitter.post_message_from_script (AgentScriptId (1), make_numbered_message (i), null);
+
+			sink.open ();
+			try {
+				yield sink.wait_for_messages (8);
+			} catch (GLib.Error e) {
+				assert_not_reached ();
+			}
+			for (uint i = 0; i != 8; i++)
+				assert_true (sink.received[(int) i] == make_numbered_message (i));
+			assert_true (transmitter.dropped_messages == 0);
+
+			yield transmitter.close (null);
+
+			loop.quit ();
+		}
+
+		private static void compressed_batch_size_is_bounded () {
+			var sink = new MemoryOutputStream.resizable ();
+			var stream = new ConverterOutputStream (sink, new ZlibCompressor (RAW, -1));
+			var zeros = new uint8[1024 * 1024];
+			try {
+				for (size_t n = 0; n <= AgentMessageBatch.MAX_DECOMPRESSED_SIZE; n += zeros.length) {
+					size_t bytes_written;
+					stream.write_all (zeros, out bytes_written);
+				}
+				stream.close ();
+			} catch (GLib.Error e) {
+				assert_not_reached ();
+			}
+			Bytes bomb = sink.steal_as_bytes ();
+
+			var message = AgentMessage (COMPRESSED_BATCH, AgentScriptId (0), MessageCompression.ZLIB.to_nick (), true,
+				bomb.get_data ());
+			try {
+				AgentMessageBatch.decompress (message, (kind, script_id, text, data) => {
+					assert_not_reached ();
+				});
+				assert_not_reached ();
+			} catch (Error e) {
+				assert_true (e is Error.PROTOCOL);
+				assert_true (e.message == "Message batch too large");
+			}
+		}
+
+		private static AgentMessageTransmitter make_transmitter (AgentSession session, AgentMessageSink sink,
+				SessionOptions options) {
+			var context = MainContext.ref_thread_default ();
+			var transmitter = new AgentMessageTransmitter (session, 0, context, context);
+			transmitter.configure (options);
+			transmitter.message_sink = sink;
+			return transmitter;
+		}
+
+		private class RecordingSink : Object, AgentMessageSink {
+			public Gee.ArrayList<Gee.ArrayList<string>> batches = new Gee.ArrayList<Gee.ArrayList<string>> ();
+
+			private uint awaited_count = 0;
+			private Promise<bool>? awaited_request;
+
+			public async void wait_for_batches (uint n) throws GLib.Error {
+				if (batches.size >= n)
+					return;
+				awaited_count = n;
+				awaited_request = new Promise<bool> ();
+				yield awaited_request.future.wait_async (null);
+			}
+
+			public async void post_messages (AgentMessage[] messages, uint batch_id, Cancellable? cancellable)
+					throws GLib.Error {
+				var texts = new Gee.ArrayList<string> ();
+				foreach (var m in messages)
+					texts.add (m.text);
+				batches.add (texts);
+
+				if (awaited_request != null && batches.size >= awaited_count) {
+					awaited_request.resolve (true);
+					awaited_request = null;
+				}
+			}
+		}
+
+		private class GatedSink : Object, AgentMessageSink {
+			public Gee.ArrayList<string> received = new Gee.ArrayList<string> ();
+			public uint outstanding = 0;
+			public uint max_outstanding = 0;
+
+			private Promise<bool> gate = new Promise<bool> ();
+			private uint awaited_count = 0;
+			private Promise<bool>? awaited_request;
+
+			public void open () {
+				gate.resolve (true);
+			}
+
+			public async void wait_for_messages (uint n) throws GLib.Error {
+				if (received.size >= n)
+					return;
+				awaited_count = n;
+				awaited_request = new Promise<bool> ();
+				yield awaited_request.future.wait_async (null);
+			}
+
+			public async void post_messages (AgentMessage[] messages, uint batch_id, Cancellable? cancellable)
+					throws GLib.Error {
+				foreach (var m in messages)
+					received.add (m.text);
+
+				outstanding++;
+				max_outstanding = uint.max (max_outstanding, outstanding);
+
+				if (awaited_request != null && received.size >= awaited_count) {
+					awaited_request.resolve (true);
+					awaited_request = null;
+				}
+
+				yield gate.future.wait_async (null);
+
+				outstanding--;
+			}
+		}
+
+		private class StubAgentSession : Object, AgentSession {
+			public async void close (Cancellable? cancellable) throws GLib.Error {
+			}
+
+			public async void interrupt (Cancellable? cancellable) throws GLib.Error {
+			}
+
+			public async void resume (uint rx_batch_id, Cancellable? cancellable, out uint tx_batch_id) throws GLib.Error {
+				tx_batch_id = 0;
+			}
+
+			public async void enable_child_gating (Cancellable? cancellable) throws GLib.Error {
+				throw new Error.NOT_SUPPORTED ("Not supported by the stub");
+			}
+
+			public async void disable_child_gating (Cancellable? cancellable) throws GLib.Error {
+				throw new Error.NOT_SUPPORTED ("Not supported by the stub");
+			}
+
+			public async AgentScriptId create_script (string source, HashTable<string, Variant> options,
+					Cancellable? cancellable) throws GLib.Error {
+				throw new Error.NOT_SUPPORTED ("Not supported by the stub");
+			}
+
+			public async AgentScriptId create_script_from_bytes (uint8[] bytes, HashTable<string, Variant> options,
+					Cancellable? cancellable) throws GLib.Error {
+				throw new Error.NOT_SUPPORTED ("Not supported by the stub");
+			}
+
+			public async uint8[] compile_script (string source, HashTable<string, Variant> options,
+					Cancellable? cancellable) throws GLib.Error {
+				throw new Error.NOT_SUPPORTED ("Not supported by the stub");
+			}
+
+			public async uint8[] snapshot_script (string embed_script, HashTable<string, Variant> options,
+					Cancellable? cancellable) throws GLib.Error {
+				throw new Error.NOT_SUPPORTED ("Not supported by the stub");
+			}
+
+			public async void destroy_script (AgentScriptId script_id, Cancellable? cancellable) throws GLib.Error {
+				throw new Error.NOT_SUPPORTED ("Not supported by the stub");
+			}
+
+			public async void load_script (AgentScriptId script_id, Cancellable? cancellable) throws GLib.Error {
+				throw new Error.NOT_SUPPORTED ("Not supported by the stub");
+			}
+
+			public async void eternalize_script (AgentScriptId script_id, Cancellable? cancellable) throws GLib.Error {
+				throw new Error.NOT_SUPPORTED ("Not supported by the stub");
+			}
+
+			public async void enable_debugger (AgentScriptId script_id, Cancellable? cancellable) throws GLib.Error {
+				throw new Error.NOT_SUPPORTED ("Not supported by the stub");
+			}
+
+			public async void disable_debugger (AgentScriptId script_id, Cancellable? cancellable) throws GLib.Error {
+				throw new Error.NOT_SUPPORTED ("Not supported by the stub");
+			}
+
+			public async void post_messages (AgentMessage[] messages, uint batch_id,
+					Cancellable? cancellable) throws GLib.Error {
+			}
+
+			public async PortalMembershipId join_portal (string address, HashTable<string, Variant> options,
+					Cancellable? cancellable) throws GLib.Error {
+				throw new Error.NOT_SUPPORTED ("Not supported by the stub");
+			}
+
+			public async void leave_portal (PortalMembershipId membership_id, Cancellable? cancellable) throws GLib.Error {
+				throw new Error.NOT_SUPPORTED ("Not supported by the stub");
+			}
+
+			public async void offer_peer_connection (string offer_sdp, HashTable<string, Variant> peer_options,
+					Cancellable? cancellable, out string answer_sdp) throws GLib.Error {
+				throw new Error.NOT_SUPPORTED ("Not supported by the stub");
+			}
+
+			public async void add_candidates (string[] candidate_sdps, Cancellable? cancellable) throws GLib.Error {
+				throw new Error.NOT_SUPPORTED ("Not supported by the stub");
+			}
+
+			public async void notify_candidate_gathering_done (Cancellable? cancellable) throws GLib.Error {
+				throw new Error.NOT_SUPPORTED ("Not supported by the stub");
+			}
+
+			public async void begin_migration (Cancellable? cancellable) throws GLib.Error {
+				throw new Error.NOT_SUPPORTED ("Not supported by the stub");
+			}
+
+			public async void commit_migration (Cancellable? cancellable) throws GLib.Error {
+				throw new Error.NOT_SUPPORTED ("Not supported by the stub");
+			}
+		}
+	}
+
+#if LINUX
+	namespace MessageTransport {
+		private const uint BATCH_COUNT = 20000;
+		private const uint PAYLOAD_SIZE = 4096;
+
+		private const uint SMALL_RING_CAPACITY = 64 * 1024;
+
+		private static void ring_completes_after_consumption () {
+			if (!MemoryFileDescriptor.is_supported ()) {
+				stdout.printf ("<skipping, kernel too old> ");
+				return;
+			}
+
+			var loop = new MainLoop ();
+			perform_ring_completes_after_consumption.begin (loop);
+			loop.run ();
+		}
+
+		private static async void perform_ring_completes_after_consumption (MainLoop loop) {
+			try {
+				var pair = new RingPair ();
+				var host_sink = new TextSink ();
+				host_sink.hold = true;
+				var reader = new MessageRingReader (pair.consumer, host_sink);
+				var sink = new MessageRingSink (pair.producer, host_sink);
+
+				bool completed = false;
+				sink.post_messages.begin (make_batch ("a"), 0, null, (obj, res) => {
+					try {
+						sink.post_messages.end (res);
+						completed = true;
+					} catch (GLib.Error e) {
+						assert_not_reached ();
+					}
+				});
+
+				yield host_sink.wait_for_texts (1);
+				yield sleep (20);
+				assert_false (completed);
+
+				host_sink.release ();
+				while (!completed)
+					yield sleep (5);
+
+				sink.close ();
+				reader.close ();
+			} catch (GLib.Error e) {
+				printerr ("\nFAIL: %s\n\n", e.message);
+				assert_not_reached ();
+			}
+
+			loop.quit ();
+		}
+
+		private static void ring_orders_oversized_fallback () {
+			if (!MemoryFileDescriptor.is_supported ()) {
+				stdout.printf ("<skipping, kernel too old> ");
+				return;
+			}
+
+			var loop = new MainLoop ();
+			perform_ring_orders_oversized_fallback.begin (loop);
+			loop.run ();
+		}
+
+		private static async void perform_ring_orders_oversized_fallback (MainLoop loop) {
+			try {
+				var pair = new RingPair ();
+				var host_sink = new TextSink ();
+				var reader = new MessageRingReader (pair.consumer, host_sink);
+				var sink = new MessageRingSink (pair.producer, host_sink);
+
+				var oversized = new uint8[pair.producer.max_record_size];
+				sink.post_messages.begin (make_batch ("a"), 0, null);
+				sink.post_messages.begin (make_batch ("b"), 0, null);
+				sink.post_messages.begin (make_batch ("big", oversized), 0, null);
+				yield sink.post_messages (make_batch ("c"), 0, null);
+
+				assert_true (string.joinv (",", host_sink.texts.to_array ()) == "a,b,big,c");
+				assert_true (host_sink.data_sizes[2] == (uint) oversized.length);
+				assert_false (pair.consumer.closed);
+
+				sink.close ();
+				reader.close ();
+			} catch (GLib.Error e) {
+				printerr ("\nFAIL: %s\n\n", e.message);
+				assert_not_reached ();
+			}
+
+			loop.quit ();
+		}
+
+		private static void ring_falls_back_on_corrupt_record () {
+			if (!MemoryFileDescriptor.is_supported ()) {
+				stdout.printf ("<skipping, kernel too old> ");
+				return;
+			}
+
+			var loop = new MainLoop ();
+			perform_ring_falls_back_on_corrupt_record.begin (loop);
+			loop.run ();
+		}
+
+		private static async void perform_ring_falls_back_on_corrupt_record (MainLoop loop) {
+			try {
+				var pair = new RingPair ();
+				var host_sink = new TextSink ();
+				var reader = new MessageRingReader (pair.consumer, host_sink);
+				var sink = new MessageRingSink (pair.producer, host_sink);
+
+				uint8 * record = pair.producer.try_reserve (16);
+				Memory.set (record, 0xff, 16);
+				pair.producer.commit ();
+
+				while (!pair.producer.closed)
+					yield sleep (5);
+
+				yield sink.post_messages (make_batch ("after"), 0, null);
+				assert_true (string.joinv (",", host_sink.texts.to_array ()) == "after");
+
+				sink.close ();
+				reader.close ();
+			} catch (GLib.Error e) {
+				printerr ("\nFAIL: %s\n\n", e.message);
+				assert_not_reached ();
+			}
+
+			loop.quit ();
+		}
+
+		private static void ring_falls_back_when_closed () {
+			if (!MemoryFileDescriptor.is_supported ()) {
+				stdout.printf ("<skipping, kernel too old> ");
+				return;
+			}
+
+			var loop = new MainLoop ();
+			perform_ring_falls_back_when_closed.begin (loop);
+			loop.run ();
+		}
+
+		private static async void perform_ring_falls_back_when_closed (MainLoop loop) {
+			try {
+				var pair = new RingPair ();
+				var host_sink = new TextSink ();
+				var sink = new MessageRingSink (pair.producer, host_sink);
+
+				// Nobody consumes, so the ring fills up and the rest of the batches wait for space.
+				uint total = 32;
+				uint rejected = 0;
+				uint pending = total;
+				var payload = new uint8[4096];
+				for (uint i = 0; i != total; i++) {
+					sink.post_messages.begin (make_batch ("%u".printf (i), payload), 0, null, (obj, res) => {
+						try {
+							sink.post_messages.end (res);
+						} catch (GLib.Error e) {
+							assert_true (e is Error.TRANSPORT);
+							rejected++;
+						}
+						pending--;
+					});
+				}
+				yield sleep (20);
+				assert_true (pending == total);
+
+				// What the host does when unlinking.
+				pair.consumer.close ();
+
+				while (pending != 0)
+					yield sleep (5);
+				assert_true (rejected != 0);
+				assert_true (host_sink.texts.size == total - rejected);
+				assert_true (host_sink.texts[0] == "%u".printf (rejected));
+
+				sink.close ();
+			} catch (GLib.Error e) {
+				printerr ("\nFAIL: %s\n\n", e.message);
+				assert_not_reached ();
+			}
+
+			loop.quit ();
+		}
+
+		private static AgentMessage[] make_batch (string text, uint8[]? data = null) {
+			return { AgentMessage (SCRIPT, AgentScriptId (1), text, data != null, (data != null) ? data : new uint8[0]) };
+		}
+
+		private static async void sleep (uint msec) {
+			Timeout.add (msec, sleep.callback);
+			yield;
+		}
+
+		private class RingPair {
+			public MessageRing consumer;
+			public MessageRing producer;
+
+			public RingPair () throws Error {
+				consumer = MessageRing.create (SMALL_RING_CAPACITY);
+				producer = MessageRing.open (consumer.memfd.handle, consumer.data_event.handle, consumer.space_event.handle);
+			}
+		}
+
+		private class TextSink : Object, AgentMessageSink {
+			public Gee.List<string> texts = new Gee.ArrayList<string> ();
+			public Gee.List<uint> data_sizes = new Gee.ArrayList<uint> ();
+			public bool hold = false;
+
+			private Promise<bool> released = new Promise<bool> ();
+			private uint waiting_for = 0;
+			private Promise<bool>? texts_arrived;
+
+			public void release () {
+				released.resolve (true);
+			}
+
+			public async void wait_for_texts (uint n) throws GLib.Error {
+				if (texts.size >= n)
+					return;
+				waiting_for = n;
+				texts_arrived = new Promise<bool> ();
+				yield texts_arrived.future.wait_async (null);
+			}
+
+			public async void post_messages (AgentMessage[] messages, uint batch_id, Cancellable? cancellable)
+					throws GLib.Error {
+				foreach (var m in messages) {
+					texts.add (m.text);
+					data_sizes.add (m.data.length);
+				}
+				if (texts_arrived != null && texts.size >= waiting_for) {
+					texts_arrived.resolve (true);
+					texts_arrived = null;
+				}
+
+				if (hold)
+					yield released.future.wait_async (cancellable);
+			}
+		}
+
+		private static void ring_vs_dbus () {
+			if (!GLib.Test.slow ()) {
+				stdout.printf ("<skipping, run in slow mode> ");
+				return;
+			}
+
+			if (!MemoryFileDescriptor.is_supported ()) {
+				stdout.printf ("<skipping, kernel too old> ");
+				return;
+			}
+
+			var loop = new MainLoop ();
+			measure.begin (loop);
+			loop.run ();
+		}
+
+		private static async void measure (MainLoop loop) {
+			try {
+				double ring = yield measure_ring ();
+				double dbus = yield measure_dbus ();
+
+				if (GLib.Test.verbose ()) {
+					double megabytes = (BATCH_COUNT * PAYLOAD_SIZE) / (1024.0 * 1024.0);
+					stdout.printf (" [ring: %.0f MB/s, %.1f us/batch; dbus: %.0f MB/s, %.1f us/batch] ",
+						megabytes / ring, (ring * 1000000.0) / BATCH_COUNT,
+						megabytes / dbus, (dbus * 1000000.0) / BATCH_COUNT);
+				}
+			} catch (GLib.Error e) {
+				printerr ("\nFAIL: %s\n\n", e.message);
+				assert_not_reached ();
+			}
+
+			loop.quit ();
+		}
+
+		private static async double measure_ring () throws GLib.Error {
+			var consumer_ring = Frida.MessageRing.create ();
+			var producer_ring = Frida.MessageRing.open (consumer_ring.memfd.handle, consumer_ring.data_event.handle,
+				consumer_ring.space_event.handle);
+
+			var counter = new CountingSink (BATCH_COUNT);
+			var reader = new MessageRingReader (consumer_ring, counter);
+			var sink = new MessageRingSink (producer_ring, counter);
+
+			double elapsed = yield run_batches (sink, counter);
+
+			sink.close ();
+			reader.close ();
+
+			return elapsed;
+		}
+
+		private static async double measure_dbus () throws GLib.Error {
+			var fds = new int[2];
+			if (Posix.socketpair (Posix.AF_UNIX, Posix.SOCK_STREAM, 0, fds) != 0)
+				throw new IOError.FAILED ("socketpair() failed");
+
+			var server_stream = SocketConnection.factory_create_connection (new Socket.from_fd (fds[0]));
+			var client_stream = SocketConnection.factory_create_connection (new Socket.from_fd (fds[1]));
+
+			var server_request = new Promise<DBusConnection> ();
+			open_server_connection.begin (server_stream, server_request);
+			var client = yield new DBusConnection (client_stream, null, AUTHENTICATION_CLIENT, null, null);
+			var server = yield server_request.future.wait_async (null);
+
+			var counter = new CountingSink (BATCH_COUNT);
+			uint registration_id = server.register_object (ObjectPath.AGENT_MESSAGE_SINK, (AgentMessageSink) counter);
+
+			AgentMessageSink sink = yield client.get_proxy (null, ObjectPath.AGENT_MESSAGE_SINK, DO_NOT_LOAD_PROPERTIES, null);
+
+			double elapsed = yield run_batches (sink, counter);
+
+			server.unregister_object (registration_id);
+			yield client.close ();
+			yield server.close ();
+
+			return elapsed;
+		}
+
+		private static async void open_server_connection (IOStream stream, Promise<DBusConnection> request) {
+			try {
+				var connection = yield new DBusConnection (stream, DBus.generate_guid (),
+					AUTHENTICATION_SERVER | AUTHENTICATION_ALLOW_ANONYMOUS, null, null);
+				request.resolve (connection);
+			} catch (GLib.Error e) {
+				request.reject (e);
+			}
+		}
+
+		private static async double run_batches (AgentMessageSink sink, CountingSink counter) throws GLib.Error {
+			var payload = new uint8[PAYLOAD_SIZE];
+			var script_id = AgentScriptId (1);
+
+			var timer = new Timer ();
+			for (uint i = 0; i != BATCH_COUNT; i++) {
+				sink.post_messages.begin ({ AgentMessage (SCRIPT, script_id, "{\"type\":\"send\",\"payload\":{}}", true,
+					payload) }, 0, null);
+			}
+			yield counter.wait_for_completion ();
+			double elapsed = timer.elapsed ();
+
+			assert_true (counter.received == BATCH_COUNT);
+			assert_true (counter.received_bytes == BATCH_COUNT * PAYLOAD_SIZE);
+
+			return elapsed;
+		}
+
+		private class CountingSink : Object, AgentMessageSink {
+			public uint expected;
+			public uint received;
+			public size_t received_bytes;
+
+			private Promise<bool> completion = new Promise<bool> ();
+
+			public CountingSink (uint expected) {
+				this.expected = expected;
+			}
+
+			public async void wait_for_completion () throws GLib.Error {
+				yield completion.future.wait_async (null);
+			}
+
+			public async void post_messages (AgentMessage[] messages, uint batch_id, Cancellable? cancellable)
+					throws GLib.Error {
+				foreach (var m in messages) {
+					received++;
+					received_bytes += m.data.length;
+				}
+				if (received == expected)
+					completion.resolve (true);
+			}
+		}
+	}
+
+#endif
 	namespace Script {
 		private static async void load_and_receive_messages (Harness h) {
 			var session = yield h.load_agent ();
@@ -1,6 +1,5 @@
-const libsystem = Process.getModuleByName('libSystem.B.dylib');
-const sleep = libsystem.getExportByName((Process.arch === 'ia32') ? 'sleep$UNIX2003' : 'sleep');
-const exit = new NativeFunction(libsystem.getExportByName('exit'), 'void', ['int']);
+const sleep = Module.getGlobalExportByName((Process.platform === 'darwin' && Process.arch === 'ia32') ? 'sleep$UNIX2003' : 'sleep');
+const exit = new NativeFunction(Module.getGlobalExportByName('exit'), 'void', ['int']);
 
 rpc.exports = {
   init() {
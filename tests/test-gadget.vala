@@ -1,14 +1,115 @@
 namespace Frida.GadgetTest {
 	public static void add_tests () {
 		GLib.Test.add_func ("/Gadget/Standalone/load-script", Standalone.load_script);
+		GLib.Test.add_func ("/Gadget/Standalone/load-script-with-bytecode-cache", Standalone.load_script_with_bytecode_cache);
 	}
 
 	namespace Standalone {
 		private static void load_script () {
+			string gadget_filename, config_filename, script_filename;
+			if (!locate_files (out gadget_filename, out config_filename, out script_filename))
+				return;
+
+			try {
+				FileUtils.set_contents (config_filename, """{
+						"interaction": {
+							"type": "script",
+							"path": "%s"
+						}
+					}""".printf (script_filename));
+
+				run_sleeper (gadget_filename);
+			} catch (GLib.Error e) {
+				printerr ("\nFAIL: %s\n\n", e.message);
+				assert_not_reached ();
+			}
+		}
+
+		private static void load_script_with_bytecode_cache () {
+			string gadget_filename, config_filename, script_filename;
+			if (!locate_files (out gadget_filename, out config_filename, out script_filename))
+				return;
+
+			string? cache_dir = null;
+			try {
+				cache_dir = DirUtils.make_tmp ("frida-gadget-cache-XXXXXX");
+
+				FileUtils.set_contents (config_filename, """{
+						"interaction": {
+							"type": "script",
+							"path": "%s"
+						},
+						"runtime": "qjs",
+						"bytecode_cache": "%s"
+					}""".printf (script_filename, cache_dir));
+
+				var timer = new Timer ();
+				run_sleeper (gadget_filename);
+				double cold = timer.elapsed ();
+
+				var entries = list_cache_entries (cache_dir);
+				assert_true (entries.length == 1);
+
+				/*
+				 * A hit refreshes the entry's mtime in place, whereas a miss rewrites it through a new inode.
+				 */
+				var entry = File.new_for_path (Path.build_filename (cache_dir, entries[0]));
+				entry.set_attribute_uint64 (FileAttribute.TIME_MODIFIED, 1000, FileQueryInfoFlags.NONE);
+				uint64 inode = query_inode (entry);
+
+				timer.start ();
+				run_sleeper (gadget_filename);
+				double warm = timer.elapsed ();
+
+				assert_true (list_cache_entries (cache_dir).length == 1);
+				assert_true (query_inode (entry) == inode);
+				assert_true (entry.query_info (FileAttribute.TIME_MODIFIED, FileQueryInfoFlags.NONE)
+					.get_attribute_uint64 (FileAttribute.TIME_MODIFIED) > 1000);
+
+				if (GLib.Test.verbose ())
+					stdout.printf ("<cold: %.0f ms, warm: %.0f ms> ", cold * 1000.0, warm * 1000.0);
+			} catch (GLib.Error e) {
+				printerr ("\nFAIL: %s\n\n", e.message);
+				assert_not_reached ();
+			} finally {
+				if (cache_dir != null)
+					remove_directory (cache_dir);
+			}
+		}
+
+		private static string[] list_cache_entries (string cache_dir) throws FileError {
+			string[] entries = {};
+			var dir = Dir.open (cache_dir);
+			string? name;
+			while ((name = dir.read_name ()) != null) {
+				if (name.has_suffix (".qjsbc"))
+					entries += name;
+			}
+			return entries;
+		}
+
+		private static uint64 query_inode (File file) throws GLib.Error {
+			return file.query_info (FileAttribute.UNIX_INODE, FileQueryInfoFlags.NONE)
+				.get_attribute_uint64 (FileAttribute.UNIX_INODE);
+		}
+
+		private static void remove_directory (string path) {
+			try {
+				var dir = Dir.open (path);
+				string? name;
+				while ((name = dir.read_name ()) != null)
+					FileUtils.unlink (Path.build_filename (path, name));
+			} catch (FileError e) {
+			}
+			DirUtils.remove (path);
+		}
+
+		private static bool locate_files (out string gadget_filename, out string config_filename, out string script_filename) {
 			string gadget_dir;
 			string data_dir;
 			switch (Frida.Test.os ()) {
-				case Frida.Test.OS.MACOS: {
+				case Frida.Test.OS.MACOS:
+				case Frida.Test.OS.LINUX: {
 					var tests_dir = Path.get_dirname (Frida.Test.Process.current.filename);
 					var build_dir = Path.get_dirname (tests_dir);
 					var source_dir = Path.get_dirname (build_dir);
@@ -24,33 +125,28 @@ namespace Frida.GadgetTest {
 					break;
 				}
 				default:
-					stdout.printf ("<skipping, test only available on i/macOS for now> ");
-					return;
+					stdout.printf ("<skipping, test only available on i/macOS and Linux for now> ");
+					gadget_filename = null;
+					config_filename = null;
+					script_filename = null;
+					return false;
 			}
 
-			var gadget_filename = Path.build_filename (gadget_dir, "frida-gadget" + Frida.Test.os_library_suffix ());
-			var config_filename = Path.build_filename (gadget_dir, "frida-gadget.config");
-			var script_filename = Path.build_filename (data_dir, "test-gadget-standalone.js");
+			gadget_filename = Path.build_filename (gadget_dir, "frida-gadget" + Frida.Test.os_library_suffix ());
+			config_filename = Path.build_filename (gadget_dir, "frida-gadget.config");
+			script_filename = Path.build_filename (data_dir, "test-gadget-standalone.js");
+			return true;
+		}
 
+		private static void run_sleeper (string gadget_filename) throws GLib.Error {
+			string preload_variable = (Frida.Test.os () == Frida.Test.OS.LINUX) ? "LD_PRELOAD" : "DYLD_INSERT_LIBRARIES";
 			var envp = new string[] {
-				"DYLD_INSERT_LIBRARIES=" + gadget_filename,
+				preload_variable + "=" + gadget_filename,
 			};
 
-			try {
-				FileUtils.set_contents (config_filename, """{
-						"interaction": {
-							"type": "script",
-							"path": "%s"
-						}
-					}""".printf (script_filename));
-
-				var process = Frida.Test.Process.start (Frida.Test.Labrats.path_to_executable ("sleeper"), null, envp);
-				var exitcode = process.join (5000);
-				assert_true (exitcode == 123);
-			} catch (GLib.Error e) {
-				printerr ("\nFAIL: %s\n\n", e.message);
-				assert_not_reached ();
-			}
+			var process = Frida.Test.Process.start (Frida.Test.Labrats.path_to_executable ("sleeper"), null, envp);
+			var exitcode = process.join (5000);
+			assert_true (exitcode == 123);
 		}
 	}
 }
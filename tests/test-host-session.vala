@@ -10,6 +10,46 @@ namespace Frida.HostSessionTest {
 			h.run ();
 		});
 
+		GLib.Test.add_func ("/HostSession/Service/web-frame-negotiation", () => {
+			var h = new Harness ((h) => Service.web_frame_negotiation.begin (h as Harness));
+			h.run ();
+		});
+
+		GLib.Test.add_func ("/HostSession/Service/web-compression-defaults", () => {
+			var h = new Harness ((h) => Service.web_compression_defaults.begin (h as Harness));
+			h.run ();
+		});
+
+		GLib.Test.add_func ("/HostSession/Service/web-frame-negotiation-with-legacy-peer", () => {
+			var h = new Harness ((h) => Service.web_frame_negotiation_with_legacy_peer.begin (h as Harness));
+			h.run ();
+		});
+
+		GLib.Test.add_func ("/HostSession/Service/web-throughput", () => {
+			var h = new Harness ((h) => Service.web_throughput.begin (h as Harness));
+			h.run ();
+		});
+
+		GLib.Test.add_func ("/HostSession/Service/rpc-throughput", () => {
+			var h = new Harness ((h) => Service.rpc_throughput.begin (h as Harness));
+			h.run ();
+		});
+
+		GLib.Test.add_func ("/HostSession/Service/gdb-memory-cache", () => {
+			var h = new Harness ((h) => Service.gdb_memory_cache.begin (h as Harness));
+			h.run ();
+		});
+
+		GLib.Test.add_func ("/HostSession/Service/gdb-binary-transfer", () => {
+			var h = new Harness ((h) => Service.gdb_memory_transfer.begin (h as Harness, true));
+			h.run ();
+		});
+
+		GLib.Test.add_func ("/HostSession/Service/gdb-hex-transfer", () => {
+			var h = new Harness ((h) => Service.gdb_memory_transfer.begin (h as Harness, false));
+			h.run ();
+		});
+
 #if HAVE_LOCAL_BACKEND
 		GLib.Test.add_func ("/HostSession/Manual/full-cycle", () => {
 			var h = new Harness.without_timeout ((h) => Service.Manual.full_cycle.begin (h as Harness));
@@ -46,6 +86,22 @@ namespace Frida.HostSessionTest {
 			Fruity.Plist.to_xml_yields_complete_document ();
 		});
 
+		GLib.Test.add_func ("/HostSession/Fruity/Plist/binary-round-trip-shares-nothing-mutable", () => {
+			Fruity.Plist.binary_round_trip_shares_nothing_mutable ();
+		});
+
+		GLib.Test.add_func ("/HostSession/Fruity/Plist/binary-parser-survives-corrupt-input", () => {
+			Fruity.Plist.binary_parser_survives_corrupt_input ();
+		});
+
+		GLib.Test.add_func ("/HostSession/Fruity/Plist/binary-parser-collapses-duplicate-keys", () => {
+			Fruity.Plist.binary_parser_collapses_duplicate_keys ();
+		});
+
+		GLib.Test.add_func ("/HostSession/Fruity/Plist/binary-parser-performance", () => {
+			Fruity.Plist.binary_parser_performance ();
+		});
+
 #if DARWIN
 		GLib.Test.add_func ("/HostSession/Fruity/Plist/output-matches-apple-implementation", () => {
 			Fruity.Plist.output_matches_apple_implementation ();
@@ -62,6 +118,11 @@ namespace Frida.HostSessionTest {
 			h.run ();
 		});
 
+		GLib.Test.add_func ("/HostSession/Fruity/network-stack-throughput", () => {
+			var h = new Harness ((h) => Fruity.network_stack_throughput.begin (h as Harness));
+			h.run ();
+		});
+
 		GLib.Test.add_func ("/HostSession/Fruity/Manual/lockdown", () => {
 			var h = new Harness ((h) => Fruity.Manual.lockdown.begin (h as Harness));
 			h.run ();
@@ -107,6 +168,16 @@ namespace Frida.HostSessionTest {
 			h.run ();
 		});
 
+		GLib.Test.add_func ("/HostSession/Linux/warm-attach", () => {
+			var h = new Harness ((h) => Linux.warm_attach.begin (h as Harness));
+			h.run ();
+		});
+
+		GLib.Test.add_func ("/HostSession/Linux/message-ring", () => {
+			var h = new Harness ((h) => Linux.message_ring.begin (h as Harness));
+			h.run ();
+		});
+
 		GLib.Test.add_func ("/HostSession/Linux/ChildGating/fork", () => {
 			var h = new Harness ((h) => Linux.fork.begin (h as Harness));
 			h.run ();
@@ -151,6 +222,11 @@ namespace Frida.HostSessionTest {
 			var h = new Harness ((h) => Linux.Manual.spawn_android_app.begin (h as Harness));
 			h.run ();
 		});
+
+		GLib.Test.add_func ("/HostSession/Linux/Manual/agent-footprint", () => {
+			var h = new Harness ((h) => Linux.Manual.agent_footprint.begin (h as Harness));
+			h.run ();
+		});
 #endif
 
 #if DARWIN
@@ -387,6 +463,21 @@ namespace Frida.HostSessionTest {
 				h.run ();
 			});
 		}
+
+		GLib.Test.add_func ("/HostSession/Connectivity/Server/message-compression-throughput", () => {
+			var h = new Harness ((h) => Connectivity.message_compression_throughput.begin (h as Harness));
+			h.run ();
+		});
+
+		GLib.Test.add_func ("/HostSession/Connectivity/Peer/reliable-channel-preserves-large-messages", () => {
+			var h = new Harness ((h) => Connectivity.reliable_channel_preserves_large_messages.begin (h as Harness));
+			h.run ();
+		});
+
+		GLib.Test.add_func ("/HostSession/Connectivity/Peer/tail-latency-under-mixed-load", () => {
+			var h = new Harness ((h) => Connectivity.tail_latency_under_mixed_load.begin (h as Harness));
+			h.run ();
+		});
 #endif
 	}
 
@@ -433,6 +524,700 @@ namespace Frida.HostSessionTest {
 			h.done ();
 		}
 
+		private static async void web_throughput (Harness h) {
+			if (!GLib.Test.slow ()) {
+				stdout.printf ("<skipping, run in slow mode> ");
+				h.done ();
+				return;
+			}
+
+			try {
+				var service = new WebService (new EndpointParameters ("127.0.0.1", 1337), CONTROL,
+					PortConflictBehavior.PICK_NEXT);
+				var incoming = new Promise<IOStream> ();
+				service.incoming.connect ((connection, remote_address) => {
+					incoming.resolve (connection);
+				});
+				yield service.start (null);
+
+				var port = (uint16) ((InetSocketAddress) service.listen_address).port;
+				var client = new SocketClient ();
+				SocketConnection raw_connection = yield client.connect_async (
+					new InetSocketAddress.from_string ("127.0.0.1", port), null);
+				IOStream client_stream = yield negotiate_connection (raw_connection, PLAIN, "lolcathost", null, null,
+					null);
+				IOStream server_stream = yield incoming.future.wait_async (null);
+
+				size_t chunk_size = 1024 * 1024;
+				size_t total_size = 64 * chunk_size;
+				var chunk = new uint8[chunk_size];
+				for (size_t i = 0; i != chunk_size; i++)
+					chunk[i] = (uint8) i;
+
+				var timer = new Timer ();
+
+				send_payload.begin (client_stream.output_stream, chunk, total_size / chunk_size);
+
+				var buffer = new uint8[64 * 1024];
+				size_t received = 0;
+				while (received != total_size) {
+					ssize_t n = yield server_stream.input_stream.read_async (buffer, Priority.DEFAULT, null);
+					assert_true (n > 0);
+					assert_true (buffer[0] == (uint8) received);
+					received += n;
+				}
+
+				double elapsed = timer.elapsed ();
+				if (GLib.Test.verbose ()) {
+					stdout.printf (" [%.1f MB/s] ", (total_size / (1024.0 * 1024.0)) / elapsed);
+					stdout.flush ();
+				}
+
+				yield client_stream.close_async ();
+				yield server_stream.close_async ();
+				service.stop ();
+			} catch (GLib.Error e) {
+				printerr ("\nFAIL: %s\n\n", e.message);
+				assert_not_reached ();
+			}
+
+			h.done ();
+		}
+
+		private static async void web_frame_negotiation (Harness h) {
+			try {
+				var server_params = new EndpointParameters ("127.0.0.1", 1337);
+				server_params.max_frame_size = 64 * 1024;
+				server_params.compression = DEFLATE;
+				var service = new WebService (server_params, CONTROL, PortConflictBehavior.PICK_NEXT);
+				var incoming = new Promise<IOStream> ();
+				service.incoming.connect ((connection, remote_address) => {
+					incoming.resolve (connection);
+				});
+				yield service.start (null);
+				var port = (uint16) ((InetSocketAddress) service.listen_address).port;
+
+				string response = yield probe_websocket_handshake (port, {
+					"X-Frida-Max-Frame-Size: 131072",
+					"Sec-WebSocket-Extensions: permessage-deflate; client_max_window_bits",
+				});
+				assert_true ("x-frida-max-frame-size: 65536" in response);
+				assert_true ("sec-websocket-extensions: permessage-deflate" in response);
+				yield incoming.future.wait_async (null);
+				incoming = new Promise<IOStream> ();
+
+				var client_params = new EndpointParameters ();
+				client_params.max_frame_size = 128 * 1024;
+				client_params.compression = DEFLATE;
+
+				var client = new SocketClient ();
+				SocketConnection raw_connection = yield client.connect_async (
+					new InetSocketAddress.from_string ("127.0.0.1", port), null);
+				IOStream client_connection = yield negotiate_connection (raw_connection, PLAIN, "lolcathost", null,
+					client_params, null);
+				IOStream server_connection = yield incoming.future.wait_async (null);
+
+				// Both sides would drop the connection if the other sent frames beyond the limit it advertised.
+				var payload = new uint8[1024 * 1024];
+				for (size_t i = 0; i != payload.length; i++)
+					payload[i] = (uint8) (i % 251);
+
+				send_payload.begin (client_connection.output_stream, payload, 1);
+				yield receive_and_check_payload (server_connection.input_stream, payload);
+
+				send_payload.begin (server_connection.output_stream, payload, 1);
+				yield receive_and_check_payload (client_connection.input_stream, payload);
+
+				yield client_connection.close_async ();
+				yield server_connection.close_async ();
+				service.stop ();
+			} catch (GLib.Error e) {
+				printerr ("\nFAIL: %s\n\n", e.message);
+				assert_not_reached ();
+			}
+
+			h.done ();
+		}
+
+		private static async void web_compression_defaults (Harness h) {
+			try {
+				var offer = new string[] { "Sec-WebSocket-Extensions: permessage-deflate; client_max_window_bits" };
+
+				foreach (var compression in new WebCompression[] { DEFAULT, NONE }) {
+					var server_params = new EndpointParameters ("127.0.0.1", 1337);
+					server_params.compression = compression;
+					var service = new WebService (server_params, CONTROL, PortConflictBehavior.PICK_NEXT);
+					yield service.start (null);
+					var port = (uint16) ((InetSocketAddress) service.listen_address).port;
+
+					string response = yield probe_websocket_handshake (port, offer);
+					bool accepted = "sec-websocket-extensions: permessage-deflate" in response;
+					assert_true (accepted == (compression == DEFAULT));
+
+					service.stop ();
+				}
+			} catch (GLib.Error e) {
+				printerr ("\nFAIL: %s\n\n", e.message);
+				assert_not_reached ();
+			}
+
+			h.done ();
+		}
+
+		private static async void web_frame_negotiation_with_legacy_peer (Harness h) {
+			try {
+				var server_params = new EndpointParameters ("127.0.0.1", 1337);
+				server_params.max_frame_size = 1024 * 1024;
+				var service = new WebService (server_params, CONTROL, PortConflictBehavior.PICK_NEXT);
+				var incoming = new Promise<IOStream> ();
+				service.incoming.connect ((connection, remote_address) => {
+					incoming.resolve (connection);
+				});
+				yield service.start (null);
+
+				var port = (uint16) ((InetSocketAddress) service.listen_address).port;
+				var client = new SocketClient ();
+				SocketConnection raw_connection = yield client.connect_async (
+					new InetSocketAddress.from_string ("127.0.0.1", port), null);
+				var input = new DataInputStream (raw_connection.input_stream);
+				input.close_base_stream = false;
+				yield perform_websocket_handshake (raw_connection, input, {});
+
+				IOStream server_connection = yield incoming.future.wait_async (null);
+
+				var payload = new uint8[1024 * 1024];
+				send_payload.begin (server_connection.output_stream, payload, 1);
+
+				size_t received = 0;
+				while (received != payload.length) {
+					size_t frame_size = yield read_websocket_frame (input);
+					assert_true (frame_size <= DEFAULT_WEB_FRAME_SIZE);
+					received += frame_size;
+				}
+
+				yield server_connection.close_async ();
+				yield raw_connection.close_async ();
+				service.stop ();
+			} catch (GLib.Error e) {
+				printerr ("\nFAIL: %s\n\n", e.message);
+				assert_not_reached ();
+			}
+
+			h.done ();
+		}
+
+		private static async string probe_websocket_handshake (uint16 port, string[] extra_headers) throws GLib.Error {
+			var client = new SocketClient ();
+			SocketConnection connection = yield client.connect_async (new InetSocketAddress.from_string ("127.0.0.1", port),
+				null);
+			var input = new DataInputStream (connection.input_stream);
+			input.close_base_stream = false;
+
+			string response = yield perform_websocket_handshake (connection, input, extra_headers);
+
+			yield connection.close_async ();
+
+			return response;
+		}
+
+		private static async string perform_websocket_handshake (SocketConnection connection, DataInputStream input,
+				string[] extra_headers) throws GLib.Error {
+			var request = new StringBuilder ();
+			string[] headers = {
+				"GET /ws HTTP/1.1",
+				"Host: lolcathost",
+				"Upgrade: websocket",
+				"Connection: Upgrade",
+				"Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==",
+				"Sec-WebSocket-Version: 13",
+			};
+			foreach (unowned string header in headers)
+				request.append (header).append ("\r\n");
+			foreach (unowned string header in extra_headers)
+				request.append (header).append ("\r\n");
+			request.append ("\r\n");
+			size_t bytes_written;
+			yield connection.output_stream.write_all_async (request.str.data, Priority.DEFAULT, null, out bytes_written);
+
+			var response = new StringBuilder ();
+			string? line;
+			while ((line = yield input.read_line_async (Priority.DEFAULT, null)) != null) {
+				line = line.strip ();
+				if (line == "")
+					break;
+				response.append (line.down ()).append_c ('\n');
+			}
+			assert_true (response.str.has_prefix ("http/1.1 101"));
+
+			return response.str;
+		}
+
+		private static async size_t read_websocket_frame (InputStream input) throws GLib.Error {
+			uint8[] header = yield read_exactly (input, 2);
+			assert_true ((header[1] & 0x80) == 0);
+
+			size_t size = header[1] & 0x7f;
+			if (size == 126) {
+				uint8[] extended = yield read_exactly (input, 2);
+				size = (extended[0] << 8) | extended[1];
+			} else if (size == 127) {
+				uint8[] extended = yield read_exactly (input, 8);
+				size = 0;
+				foreach (uint8 b in extended)
+					size = (size << 8) | b;
+			}
+
+			yield read_exactly (input, size);
+
+			return size;
+		}
+
+		private static async uint8[] read_exactly (InputStream input, size_t size) throws GLib.Error {
+			var buffer = new uint8[size];
+			size_t bytes_read;
+			yield input.read_all_async (buffer, Priority.DEFAULT, null, out bytes_read);
+			if (bytes_read != size)
+				throw new IOError.CLOSED ("Connection closed");
+			return buffer;
+		}
+
+		private static async void receive_and_check_payload (InputStream input, uint8[] expected) throws GLib.Error {
+			var buffer = new uint8[expected.length];
+			size_t bytes_read;
+			yield input.read_all_async (buffer, Priority.DEFAULT, null, out bytes_read);
+			assert_true (bytes_read == expected.length);
+			assert_true (Memory.cmp (buffer, expected, expected.length) == 0);
+		}
+
+		private static async void send_payload (OutputStream output, uint8[] chunk, size_t count) {
+			try {
+				for (size_t i = 0; i != count; i++) {
+					size_t bytes_written;
+					yield output.write_all_async (chunk, Priority.DEFAULT, null, out bytes_written);
+				}
+			} catch (GLib.Error e) {
+				printerr ("\nFAIL: %s\n\n", e.message);
+				assert_not_reached ();
+			}
+		}
+
+		private static async void rpc_throughput (Harness h) {
+			if (!GLib.Test.slow ()) {
+				stdout.printf ("<skipping, run in slow mode> ");
+				h.done ();
+				return;
+			}
+
+			var peer = new LoopbackRpcPeer ();
+			var client = new RpcClient (peer);
+			peer.client = client;
+
+			string unrelated_message = "{\"type\":\"send\",\"payload\":\"%s\"}".printf (string.nfill (64 * 1024, 'x'));
+
+			uint num_calls = 10000;
+			var timer = new Timer ();
+			try {
+				for (uint i = 0; i != num_calls; i++) {
+					assert_false (client.try_handle_message (unrelated_message));
+
+					var result = yield client.call ("ping", {}, null, null);
+					assert_true (result.get_int () == i);
+				}
+			} catch (GLib.Error e) {
+				printerr ("\nFAIL: %s\n\n", e.message);
+				assert_not_reached ();
+			}
+			double elapsed = timer.elapsed ();
+
+			if (GLib.Test.verbose ()) {
+				stdout.printf (" [%u calls in %u ms, %.1f us per call] ", num_calls, (uint) (elapsed * 1000.0),
+					(elapsed * 1000000.0) / num_calls);
+				stdout.flush ();
+			}
+
+			h.done ();
+		}
+
+		private static async void gdb_memory_cache (Harness h) {
+			try {
+				var listener = new SocketListener ();
+				uint16 port = listener.add_any_inet_port (null);
+				var client = new SocketClient ();
+				SocketConnection client_connection = yield client.connect_async (
+					new InetSocketAddress.from_string ("127.0.0.1", port), null);
+				SocketConnection server_connection = yield listener.accept_async (null);
+
+				var stub = new FakeGdbStub (server_connection);
+				stub.run.begin ();
+
+				var gdb = yield GDB.Client.open (client_connection, null);
+				yield gdb.enable_memory_cache (null);
+
+				Bytes data = yield gdb.read_byte_array (0x10010, 16, null);
+				assert_true (data.get (0) == 0x10);
+				assert_true (stub.last_read_address == 0x10000);
+				assert_true (stub.last_read_size == 0x1000);
+				uint reads = stub.reads;
+
+				data = yield gdb.read_byte_array (0x10100, 32, null);
+				assert_true (data.get (31) == 0x1f);
+				assert_true (stub.reads == reads);
+				assert_true (gdb.memory_cache_hits == 1);
+				assert_true (gdb.memory_cache_misses == 1);
+
+				yield gdb.write_byte_array (0x10100, new Bytes (new uint8[] { 0xaa }), null);
+				data = yield gdb.read_byte_array (0x10100, 1, null);
+				assert_true (data.get (0) == 0xaa);
+				assert_true (stub.reads == reads + 1);
+
+				yield gdb.query_simple ("Qqemu.PhyMemMode:1", null);
+				data = yield gdb.read_byte_array (0x10010, 1, null);
+				assert_true (data.get (0) == (0x10 ^ 0xff));
+				assert_true (stub.reads == reads + 2);
+
+				data = yield gdb.read_byte_array (0x14000, 4, null);
+				assert_true (stub.last_read_address == 0x14000);
+				assert_true (stub.last_read_size == 4);
+				uint8 first_sample = data.get (0);
+				data = yield gdb.read_byte_array (0x14000, 4, null);
+				assert_true (data.get (0) != first_sample);
+				assert_true (stub.reads == reads + 4);
+
+				yield gdb.close (null);
+				listener.close ();
+			} catch (GLib.Error e) {
+				printerr ("\nFAIL: %s\n\n", e.message);
+				assert_not_reached ();
+			}
+
+			h.done ();
+		}
+
+		private static async void gdb_memory_transfer (Harness h, bool binary) {
+			try {
+				var listener = new SocketListener ();
+				uint16 port = listener.add_any_inet_port (null);
+				var client = new SocketClient ();
+				SocketConnection client_connection = yield client.connect_async (
+					new InetSocketAddress.from_string ("127.0.0.1", port), null);
+				SocketConnection server_connection = yield listener.accept_async (null);
+
+				var stub = new FakeGdbStub (server_connection);
+				stub.packet_size = 0x100;
+				stub.binary_transfer = binary;
+				stub.run.begin ();
+
+				var gdb = yield GDB.Client.open (client_connection, null);
+
+				const uint64 ADDRESS = 0x10800;
+				const size_t SIZE = 0x2000;
+
+				var original = new uint8[SIZE];
+				for (size_t i = 0; i != SIZE; i++)
+					original[i] = (uint8) (ADDRESS + i);
+				Bytes data = yield gdb.read_byte_array (ADDRESS, SIZE, null);
+				assert_true (data.compare (new Bytes (original)) == 0);
+				assert_true (stub.reads > 8);
+				assert_true (stub.max_reads_in_flight > 1);
+				assert_true (stub.binary_reads == (binary ? stub.reads : 0));
+
+				var payload = new uint8[SIZE];
+				for (size_t i = 0; i != SIZE; i++)
+					payload[i] = (uint8) Random.next_int ();
+				payload[0] = '$';
+				payload[1] = '#';
+				payload[2] = '}';
+				payload[3] = '*';
+				payload[4] = 0;
+				var payload_bytes = new Bytes (payload);
+				yield gdb.write_byte_array (ADDRESS, payload_bytes, null);
+				assert_true (stub.writes > 1);
+				if (binary) {
+					assert_true (stub.rejected_binary_writes == 0);
+					assert_true (stub.binary_writes == stub.writes);
+				} else {
+					assert_true (stub.rejected_binary_writes == 1);
+					assert_true (stub.binary_writes == 0);
+				}
+
+				data = yield gdb.read_byte_array (ADDRESS, SIZE, null);
+				assert_true (data.compare (payload_bytes) == 0);
+
+				yield gdb.close (null);
+				listener.close ();
+			} catch (GLib.Error e) {
+				printerr ("\nFAIL: %s\n\n", e.message);
+				assert_not_reached ();
+			}
+
+			h.done ();
+		}
+
+		private sealed class FakeGdbStub : Object {
+			public size_t packet_size = 0x4000;
+			public bool binary_transfer = false;
+
+			public uint reads = 0;
+			public uint binary_reads = 0;
+			public uint max_reads_in_flight = 0;
+			public uint writes = 0;
+			public uint binary_writes = 0;
+			public uint rejected_binary_writes = 0;
+			public uint64 last_read_address = 0;
+			public size_t last_read_size = 0;
+
+			private IOStream stream;
+			private DataInputStream input;
+			private uint8[] memory = new uint8[MEMORY_SIZE];
+			private bool physical_mode = false;
+			private uint8 mmio_counter = 0;
+
+			private const uint64 RAM_BASE = 0x10000;
+			private const uint64 RAM_SIZE = 0x4000;
+			private const uint64 MMIO_BASE = RAM_BASE + RAM_SIZE;
+			private const size_t MEMORY_SIZE = 0x5000;
+			private const size_t PACKET_OVERHEAD = 4;
+
+			public FakeGdbStub (IOStream stream) {
+				this.stream = stream;
+				this.input = new DataInputStream (stream.input_stream);
+
+				for (size_t i = 0; i != RAM_SIZE; i++)
+					memory[i] = (uint8) (RAM_BASE + i);
+			}
+
+			public async void run () {
+				try {
+					while (true) {
+						Bytes request = yield read_packet ();
+
+						uint reads_in_flight = count_buffered_reads () + (is_read (request) ? 1 : 0);
+						max_reads_in_flight = uint.max (max_reads_in_flight, reads_in_flight);
+
+						yield write_packet (handle_request (request));
+					}
+				} catch (GLib.Error e) {
+				}
+			}
+
+			private Bytes handle_request (Bytes raw_request) {
+				unowned uint8[] raw = raw_request.get_data ();
+				if (raw.length != 0 && raw[0] == 'X')
+					return handle_binary_write (raw);
+
+				string request = (string) raw;
+				if (request.has_prefix ("qSupported")) {
+					string features = "PacketSize=%x;QStartNoAckMode+;qXfer:memory-map:read+".printf ((uint) packet_size);
+					if (binary_transfer)
+						features += ";binary-upload+";
+					return reply (features);
+				}
+				if (request == "QStartNoAckMode" || request.has_prefix ("qRcmd,"))
+					return reply ("OK");
+				if (request == "qqemu.PhyMemMode")
+					return reply (physical_mode ? "1" : "0");
+				if (request.has_prefix ("Qqemu.PhyMemMode:")) {
+					physical_mode = request.has_suffix ("1");
+					return reply ("OK");
+				}
+				if (request == "qAttached")
+					return reply ("0");
+				if (request.has_prefix ("qXfer:memory-map:read::")) {
+					if (!request.has_suffix (":0,1ffff"))
+						return reply ("l");
+					return reply (("l<memory-map><memory type=\"ram\" start=\"0x%" + uint64.FORMAT_MODIFIER +
+						"x\" length=\"0x%" + uint64.FORMAT_MODIFIER + "x\"/></memory-map>").printf (RAM_BASE, RAM_SIZE));
+				}
+				if (request[0] == 'm')
+					return handle_read (request[1:], false);
+				if (request[0] == 'x' && binary_transfer)
+					return handle_read (request[1:], true);
+				if (request[0] == 'M')
+					return reply (handle_hex_write (request[1:]));
+				return reply ("");
+			}
+
+			private Bytes handle_read (string args, bool binary) {
+				string[] tokens = args.split (",");
+				uint64 address = uint64.parse (tokens[0], 16);
+				size_t size = (size_t) uint64.parse (tokens[1], 16);
+
+				reads++;
+				if (binary)
+					binary_reads++;
+				last_read_address = address;
+				last_read_size = size;
+
+				if (address < RAM_BASE || address + size > RAM_BASE + MEMORY_SIZE)
+					return reply ("E01");
+
+				var values = new uint8[size];
+				for (size_t i = 0; i != size; i++) {
+					uint64 cur = address + i;
+					uint8 val = (cur >= MMIO_BASE) ? mmio_counter++ : memory[cur - RAM_BASE];
+					if (physical_mode)
+						val ^= 0xff;
+					values[i] = val;
+				}
+
+				if (!binary) {
+					var result = new StringBuilder.sized (size * 2);
+					foreach (uint8 val in values)
+						result.append_printf ("%02x", val);
+					return reply (result.str);
+				}
+
+				// Like real stubs, stop early when escaping would overflow the packet.
+				var result = new ByteArray ();
+				result.append ({ (uint8) 'b' });
+				size_t encoded_size = 1;
+				foreach (uint8 val in values) {
+					size_t n = needs_escaping (val) ? 2 : 1;
+					if (encoded_size + n > packet_size - PACKET_OVERHEAD)
+						break;
+					result.append ({ val });
+					encoded_size += n;
+				}
+				return ByteArray.free_to_bytes ((owned) result);
+			}
+
+			private string handle_hex_write (string args) {
+				string[] tokens = args.split (":");
+				string[] location = tokens[0].split (",");
+				uint64 address = uint64.parse (location[0], 16);
+				size_t size = (size_t) uint64.parse (location[1], 16);
+
+				writes++;
+
+				unowned string hex = tokens[1];
+				for (size_t i = 0; i != size; i++)
+					memory[address - RAM_BASE + i] = (uint8) uint64.parse (hex.substring ((long) (i * 2), 2), 16);
+				return "OK";
+			}
+
+			private Bytes handle_binary_write (uint8[] raw) {
+				if (!binary_transfer) {
+					rejected_binary_writes++;
+					return reply ("");
+				}
+
+				int colon = 0;
+				while (raw[colon] != ':')
+					colon++;
+				string[] location = ((string) raw).substring (1, colon - 1).split (",");
+				uint64 address = uint64.parse (location[0], 16);
+				size_t size = (size_t) uint64.parse (location[1], 16);
+				assert_true (raw.length - (colon + 1) == size);
+
+				writes++;
+				binary_writes++;
+
+				Memory.copy ((uint8 *) memory + (address - RAM_BASE), (uint8 *) raw + colon + 1, size);
+				return reply ("OK");
+			}
+
+			private uint count_buffered_reads () {
+				unowned uint8[] pending = input.peek_buffer ();
+				uint n = 0;
+				for (int i = 0; i < pending.length - 1; i++) {
+					if (pending[i] == '$' && (pending[i + 1] == 'm' || pending[i + 1] == 'x'))
+						n++;
+				}
+				return n;
+			}
+
+			private static bool is_read (Bytes request) {
+				unowned uint8[] raw = request.get_data ();
+				return raw.length != 0 && (raw[0] == 'm' || raw[0] == 'x');
+			}
+
+			private static bool needs_escaping (uint8 val) {
+				return val == '$' || val == '#' || val == '}' || val == '*';
+			}
+
+			private static Bytes reply (string str) {
+				return new Bytes (str.data);
+			}
+
+			private async Bytes read_packet () throws GLib.Error {
+				var header = new uint8[1];
+				size_t n;
+				do {
+					yield input.read_all_async (header, Priority.DEFAULT, null, out n);
+					if (n == 0)
+						throw new IOError.CLOSED ("Connection closed");
+				} while (header[0] != '$');
+
+				var payload = new ByteArray ();
+				var cur = new uint8[1];
+				while (true) {
+					yield input.read_all_async (cur, Priority.DEFAULT, null, out n);
+					if (n == 0)
+						throw new IOError.CLOSED ("Connection closed");
+					if (cur[0] == '#')
+						break;
+					if (cur[0] == '}') {
+						yield input.read_all_async (cur, Priority.DEFAULT, null, out n);
+						cur[0] ^= 0x20;
+					}
+					payload.append (cur);
+				}
+
+				var trailer = new uint8[2];
+				yield input.read_all_async (trailer, Priority.DEFAULT, null, out n);
+
+				// Keep a NUL after the payload so textual requests can be treated as strings.
+				payload.append ({ 0 });
+				payload.set_size (payload.len - 1);
+				return ByteArray.free_to_bytes ((owned) payload);
+			}
+
+			private async void write_packet (Bytes payload) throws GLib.Error {
+				var packet = new ByteArray ();
+				packet.append ({ (uint8) '$' });
+				uint8 checksum = 0;
+				foreach (uint8 val in payload.get_data ()) {
+					if (needs_escaping (val)) {
+						packet.append ({ (uint8) '}', val ^ 0x20 });
+						checksum += (uint8) '}';
+						checksum += val ^ 0x20;
+					} else {
+						packet.append ({ val });
+						checksum += val;
+					}
+				}
+				packet.append ("#%02x".printf (checksum).data);
+
+				size_t bytes_written;
+				yield stream.output_stream.write_all_async (packet.data, Priority.DEFAULT, null, out bytes_written);
+			}
+		}
+
+		private sealed class LoopbackRpcPeer : Object, RpcPeer {
+			public RpcClient client;
+
+			private uint calls = 0;
+
+			public async void post_rpc_message (string json, Bytes? data, Cancellable? cancellable) throws Error, IOError {
+				Json.Reader reader;
+				try {
+					reader = new Json.Reader (Json.from_string (json));
+				} catch (GLib.Error e) {
+					assert_not_reached ();
+				}
+				reader.read_element (1);
+				int64 id = reader.get_int_value ();
+				reader.end_element ();
+
+				string reply = ("{\"type\":\"send\",\"payload\":[\"frida:rpc\",%" + int64.FORMAT + ",\"ok\",%u]}").printf (id,
+					calls++);
+				Idle.add (() => {
+					assert_true (client.try_handle_message (reply));
+					return Source.REMOVE;
+				});
+			}
+		}
+
 		private sealed class StubBackend : Object, HostSessionBackend {
 			private StubProvider provider = new StubProvider ();
 
@@ -1357,7 +2142,7 @@ namespace Frida.HostSessionTest {
 					WebServiceTransport transport = PLAIN;
 					string? origin = null;
 
-					target_stream = yield negotiate_connection (target_stream, transport, "lolcathost", origin,
+					target_stream = yield negotiate_connection (target_stream, transport, "lolcathost", origin, null,
 						cancellable);
 
 					handle_io.begin (Direction.OUT, proxy_connection.input_stream, target_stream.output_stream,
@@ -1404,58 +2189,374 @@ namespace Frida.HostSessionTest {
 
 					var message = new DBusMessage.from_blob (data, DBusCapabilityFlags.NONE);
 
-					Action action = on_message (message, direction);
+					Action action = on_message (message, direction);
+
+					if (action == DISRUPT) {
+						cancellable.cancel ();
+						break;
+					}
+
+					size_t bytes_written;
+					yield output.write_all_async (data, io_priority, cancellable, out bytes_written);
+
+					if (action == FORWARD_THEN_DISRUPT) {
+						cancellable.cancel ();
+						break;
+					}
+				}
+			}
+		}
+
+		private static async void latency_should_be_nominal (Harness h, Strategy strategy) {
+			h.disable_timeout ();
+
+			try {
+				ControlService control_service;
+				uint16 control_port = 27042;
+				while (true) {
+					var ep = new EndpointParameters ("127.0.0.1", control_port);
+					control_service = new ControlService (ep);
+					try {
+						yield control_service.start ();
+						break;
+					} catch (Error e) {
+						if (e is Error.ADDRESS_IN_USE) {
+							control_port++;
+							continue;
+						}
+						throw e;
+					}
+				}
+
+				var device_manager = new DeviceManager ();
+				var device = yield device_manager.add_remote_device ("127.0.0.1:%u".printf (control_port));
+
+				yield measure_latency (h, device, strategy);
+
+				yield device_manager.close ();
+				yield control_service.stop ();
+			} catch (GLib.Error e) {
+				printerr ("Oops: %s\n", e.message);
+				assert_not_reached ();
+			}
+
+			h.done ();
+		}
+
+		private static async void reliable_channel_preserves_large_messages (Harness h) {
+			try {
+				ControlService control_service;
+				var device_manager = new DeviceManager ();
+				var device = yield add_local_control_device (device_manager, out control_service);
+
+				var process = Frida.Test.Process.create (Frida.Test.Labrats.path_to_executable ("sleeper"));
+				var session = yield device.attach (process.id);
+				yield session.setup_peer_connection ();
+
+				var options = new ScriptOptions ();
+				options.message_priority = HIGH;
+				var script = yield session.create_script ("""
+					const big = new Uint8Array(1024 * 1024);
+					for (let i = 0; i !== big.length; i++)
+					  big[i] = i % 251;
+					for (let i = 0; i !== 6; i++)
+					  send({ serial: i }, (i % 2 === 0) ? big.buffer : null);
+					""", options);
+
+				var serials = new Gee.ArrayList<int> ();
+				script.message.connect ((json, data) => {
+					var parser = new Json.Parser ();
+					try {
+						parser.load_from_data (json);
+					} catch (GLib.Error e) {
+						assert_not_reached ();
+					}
+					var reader = new Json.Reader (parser.get_root ());
+					assert_true (reader.read_member ("payload"));
+					assert_true (reader.read_member ("serial"));
+					int serial = (int) reader.get_int_value ();
+
+					if (serial % 2 == 0) {
+						assert_nonnull (data);
+						assert_true (data.length == 1024 * 1024);
+						unowned uint8[] raw = data.get_data ();
+						for (int i = 0; i != raw.length; i++)
+							assert_true (raw[i] == i % 251);
+					} else {
+						assert_null (data);
+					}
+
+					serials.add (serial);
+					if (serials.size == 6)
+						reliable_channel_preserves_large_messages.callback ();
+				});
+
+				yield script.load ();
+				if (serials.size != 6)
+					yield;
+
+				for (int i = 0; i != 6; i++)
+					assert_true (serials[i] == i);
+
+				yield script.unload ();
+				yield session.detach ();
+
+				yield device_manager.close ();
+				yield control_service.stop ();
+			} catch (GLib.Error e) {
+				printerr ("Oops: %s\n", e.message);
+				assert_not_reached ();
+			}
+
+			h.done ();
+		}
+
+		private static async void message_compression_throughput (Harness h) {
+			if (!GLib.Test.slow ()) {
+				stdout.printf ("<skipping, run in slow mode> ");
+				h.done ();
+				return;
+			}
+
+			h.disable_timeout ();
+
+			try {
+				ControlService control_service;
+				var device_manager = new DeviceManager ();
+				var device = yield add_local_control_device (device_manager, out control_service);
+
+				var process = Frida.Test.Process.create (Frida.Test.Labrats.path_to_executable ("sleeper"));
+
+				foreach (var compression in new MessageCompression[] { NONE, ZLIB }) {
+					var options = new SessionOptions ();
+					options.message_compression = compression;
+					var session = yield device.attach (process.id, options);
+
+					double elapsed = yield measure_message_throughput (session);
+					if (GLib.Test.verbose ()) {
+						stdout.printf ("<%s: %.1f messages/ms> ", compression.to_nick (),
+							THROUGHPUT_MESSAGE_COUNT / (elapsed * 1000.0));
+						stdout.flush ();
+					}
+
+					yield session.detach ();
+				}
+
+				yield device_manager.close ();
+				yield control_service.stop ();
+			} catch (GLib.Error e) {
+				printerr ("Oops: %s\n", e.message);
+				assert_not_reached ();
+			}
+
+			h.done ();
+		}
+
+		private const uint THROUGHPUT_MESSAGE_COUNT = 50000;
+
+		private static async double measure_message_throughput (Session session) throws GLib.Error {
+			var script = yield session.create_script ("""
+				recv('go', () => {
+				  for (let i = 0; i !== %u; i++)
+				    send({ type: 'log', serial: i, text: `open("/data/app/com.example/base.apk", O_RDONLY) = ${i %% 1024}` });
+				});
+				""".printf (THROUGHPUT_MESSAGE_COUNT));
+
+			uint received = 0;
+			script.message.connect ((json, data) => {
+				received++;
+				if (received == THROUGHPUT_MESSAGE_COUNT)
+					measure_message_throughput.callback ();
+			});
+
+			yield script.load ();
+
+			var timer = new Timer ();
+			script.post ("""{"type":"go"}""");
+			yield;
+			double elapsed = timer.elapsed ();
+
+			yield script.unload ();
+
+			return elapsed;
+		}
+
+		private static async Device add_local_control_device (DeviceManager device_manager, out ControlService control_service)
+				throws GLib.Error {
+			uint16 control_port = 27042;
+			while (true) {
+				var ep = new EndpointParameters ("127.0.0.1", control_port);
+				control_service = new ControlService (ep);
+				try {
+					yield control_service.start ();
+					break;
+				} catch (Error e) {
+					if (e is Error.ADDRESS_IN_USE) {
+						control_port++;
+						continue;
+					}
+					throw e;
+				}
+			}
+
+			return yield device_manager.add_remote_device ("127.0.0.1:%u".printf (control_port));
+		}
+
+		private static async void tail_latency_under_mixed_load (Harness h) {
+			if (!GLib.Test.slow ()) {
+				stdout.printf ("<skipping, run in slow mode> ");
+				h.done ();
+				return;
+			}
+
+			h.disable_timeout ();
+
+			try {
+				ControlService control_service;
+				var device_manager = new DeviceManager ();
+				var device = yield add_local_control_device (device_manager, out control_service);
+
+				var process = Frida.Test.Process.create (Frida.Test.Labrats.path_to_executable ("sleeper"));
+				var session = yield device.attach (process.id);
+				yield session.setup_peer_connection ();
+
+				var bulk = yield session.create_script ("""
+					const blob = new ArrayBuffer(192 * 1024);
+					setInterval(() => {
+					  for (let i = 0; i !== 4; i++)
+					    send({ type: 'bulk' }, blob);
+					}, 5);
+					""");
+				yield bulk.load ();
+
+				var shared = yield measure_tail_latency (session, null);
+
+				var options = new ScriptOptions ();
+				options.message_delivery = LOSSY;
+				options.message_priority = HIGH;
+				var dedicated = yield measure_tail_latency (session, options);
+
+				yield bulk.unload ();
+
+				if (GLib.Test.verbose ()) {
+					stdout.printf ("<shared stream: p50=%.2f p99=%.2f max=%.2f ms, lost=%u> ", shared.percentile (50),
+						shared.percentile (99), shared.percentile (100), shared.lost);
+					stdout.printf ("<lossy channel: p50=%.2f p99=%.2f max=%.2f ms, lost=%u> ", dedicated.percentile (50),
+						dedicated.percentile (99), dedicated.percentile (100), dedicated.lost);
+				}
+
+				assert_true (dedicated.lost <= LatencySamples.ITERATIONS / 100);
+				assert_true (dedicated.percentile (99) < LatencySamples.MAX_P99);
+				assert_true (dedicated.percentile (99) <= shared.percentile (99));
+
+				yield session.detach ();
+
+				yield device_manager.close ();
+				yield control_service.stop ();
+			} catch (GLib.Error e) {
+				printerr ("Oops: %s\n", e.message);
+				assert_not_reached ();
+			}
+
+			h.done ();
+		}
+
+		private static async LatencySamples measure_tail_latency (Session session, ScriptOptions? options)
+				throws GLib.Error {
+			var script = yield session.create_script ("""
+				recv('ping', onPing);
+				function onPing(message) {
+				  send({ type: 'pong', serial: message.serial });
+				  recv('ping', onPing);
+				}
+				""", options);
+
+			int64 expected_serial = 0;
+			Promise<bool>? pong = null;
+			var message_handler = script.message.connect ((json, data) => {
+				var parser = new Json.Parser ();
+				try {
+					parser.load_from_data (json);
+				} catch (GLib.Error e) {
+					assert_not_reached ();
+				}
+
+				var reader = new Json.Reader (parser.get_root ());
+				if (!reader.read_member ("payload") || !reader.read_member ("serial"))
+					return;
+
+				if (pong != null && reader.get_int_value () == expected_serial) {
+					pong.resolve (true);
+					pong = null;
+				}
+			});
+
+			var samples = new LatencySamples ();
+			try {
+				yield script.load ();
+
+				var timer = new Timer ();
+				for (uint i = 0; i != LatencySamples.ITERATIONS; i++) {
+					expected_serial = i + 1;
+					pong = new Promise<bool> ();
+					var future = pong.future;
+
+					var timeout_cancellable = new Cancellable ();
+					var timeout = new TimeoutSource (LatencySamples.PONG_TIMEOUT);
+					timeout.set_callback (() => {
+						timeout_cancellable.cancel ();
+						return Source.REMOVE;
+					});
+					timeout.attach (MainContext.get_thread_default ());
 
-					if (action == DISRUPT) {
-						cancellable.cancel ();
-						break;
+					timer.reset ();
+					script.post ("{\"type\":\"ping\",\"serial\":%u}".printf (i + 1));
+					try {
+						yield future.wait_async (timeout_cancellable);
+						samples.add (timer.elapsed () * 1000.0);
+					} catch (IOError e) {
+						pong = null;
+						samples.lost++;
 					}
 
-					size_t bytes_written;
-					yield output.write_all_async (data, io_priority, cancellable, out bytes_written);
-
-					if (action == FORWARD_THEN_DISRUPT) {
-						cancellable.cancel ();
-						break;
-					}
+					timeout.destroy ();
 				}
+			} finally {
+				script.disconnect (message_handler);
 			}
-		}
 
-		private static async void latency_should_be_nominal (Harness h, Strategy strategy) {
-			h.disable_timeout ();
+			yield script.unload ();
 
-			try {
-				ControlService control_service;
-				uint16 control_port = 27042;
-				while (true) {
-					var ep = new EndpointParameters ("127.0.0.1", control_port);
-					control_service = new ControlService (ep);
-					try {
-						yield control_service.start ();
-						break;
-					} catch (Error e) {
-						if (e is Error.ADDRESS_IN_USE) {
-							control_port++;
-							continue;
-						}
-						throw e;
-					}
-				}
+			return samples;
+		}
 
-				var device_manager = new DeviceManager ();
-				var device = yield device_manager.add_remote_device ("127.0.0.1:%u".printf (control_port));
+		private class LatencySamples {
+			public const uint ITERATIONS = 500;
+			public const uint PONG_TIMEOUT = 1000;
+			public const double MAX_P99 = 50.0;
 
-				yield measure_latency (h, device, strategy);
+			public uint lost = 0;
 
-				yield device_manager.close ();
-				yield control_service.stop ();
-			} catch (GLib.Error e) {
-				printerr ("Oops: %s\n", e.message);
-				assert_not_reached ();
+			private Gee.ArrayList<double?> millis = new Gee.ArrayList<double?> ();
+			private bool sorted = true;
+
+			public void add (double elapsed_millis) {
+				millis.add (elapsed_millis);
+				sorted = false;
 			}
 
-			h.done ();
+			public double percentile (uint p) {
+				if (millis.is_empty)
+					return 0;
+
+				if (!sorted) {
+					millis.sort ((a, b) => (a < b) ? -1 : ((a > b) ? 1 : 0));
+					sorted = true;
+				}
+
+				int index = (int) Math.ceil ((p / 100.0) * millis.size) - 1;
+				return millis[index.clamp (0, millis.size - 1)];
+			}
 		}
 #endif // HAVE_SOCKET_BACKEND
 
@@ -1658,6 +2759,176 @@ namespace Frida.HostSessionTest {
 			h.done ();
 		}
 
+		private static async void warm_attach (Harness h) {
+			if (!GLib.Test.slow ()) {
+				stdout.printf ("<skipping, run in slow mode> ");
+				h.done ();
+				return;
+			}
+
+			h.disable_timeout ();
+
+			try {
+				var cold = new Gee.ArrayList<double?> ();
+				var warm = new Gee.ArrayList<double?> ();
+				var warm_ptrace = new Gee.ArrayList<double?> ();
+				for (int i = 0; i != 10; i++) {
+					bool warm_agents = i % 2 == 1;
+
+					// Otherwise the cold runs would reuse the memfds that the previous warm run left behind.
+					SealedMemfdCache.get_default ().clear ();
+
+					double ptrace_time;
+					double elapsed = yield measure_attach (warm_agents, out ptrace_time);
+					if (warm_agents) {
+						warm.add (elapsed);
+						warm_ptrace.add (ptrace_time);
+					} else {
+						cold.add (elapsed);
+					}
+				}
+
+				if (GLib.Test.verbose ()) {
+					Gee.Comparator<double?> by_value = (a, b) => (a < b) ? -1 : ((a > b) ? 1 : 0);
+					cold.sort (by_value);
+					warm.sort (by_value);
+					warm_ptrace.sort (by_value);
+
+					double warm_p50 = median (warm);
+					stdout.printf (" [cold p50: %.1f ms, cold max: %.1f ms, warm p50: %.1f ms, warm max: %.1f ms, " +
+						"warm ptrace p50: %.1f ms, sub-10 ms target: %s] ", median (cold) * 1000.0, cold.last () * 1000.0,
+						warm_p50 * 1000.0, warm.last () * 1000.0, median (warm_ptrace) * 1000.0,
+						(warm_p50 < 0.010) ? "met" : "missed");
+				}
+			} catch (GLib.Error e) {
+				printerr ("Unexpected error: %s\n", e.message);
+				assert_not_reached ();
+			}
+
+			h.done ();
+		}
+
+		private static async double measure_attach (bool warm_agents, out double ptrace_time) throws GLib.Error {
+			Cancellable? cancellable = null;
+
+			var tempdir = new TemporaryDirectory ();
+			var host_session = new LinuxHostSession (new LinuxHelperProcess (tempdir), tempdir, false, warm_agents);
+			yield host_session.preload (cancellable);
+
+			// Spawned without the host session so that cold runs still have to spawn the helper while being timed.
+			var process = Frida.Test.Process.create (Frida.Test.Labrats.path_to_executable ("sleeper"));
+			uint pid = process.id;
+
+			var timer = new Timer ();
+			yield host_session.attach (pid, make_parameters_dict (), cancellable);
+			double elapsed = timer.elapsed ();
+
+			var phases = yield host_session.query_injection_timeline (pid, cancellable);
+			var phase_names = new Gee.HashSet<string> ();
+			int64 ptrace_usec = 0;
+			foreach (var phase in phases) {
+				phase_names.add (phase.name);
+				if (phase.name in PTRACE_PHASES)
+					ptrace_usec += phase.end_time - phase.start_time;
+			}
+			assert_true (phase_names.contains ("obtain-helper"));
+			assert_true (phase_names.contains ("allocate"));
+			assert_true (phase_names.contains ("inject"));
+			assert_true (phase_names.contains ("dbus-handshake"));
+			ptrace_time = ptrace_usec / 1000000.0;
+
+			yield host_session.close (cancellable);
+			process.kill ();
+
+			return elapsed;
+		}
+
+		// Work done by the helper while the target is stopped, which is the floor for attach latency.
+		private const string[] PTRACE_PHASES = { "seize", "bootstrap", "write-loader", "run-loader" };
+
+		private static double median (Gee.List<double?> sorted) {
+			return sorted[sorted.size / 2];
+		}
+
+		private static async void message_ring (Harness h) {
+			if (!MemoryFileDescriptor.is_supported ()) {
+				stdout.printf ("<skipping, kernel too old> ");
+				h.done ();
+				return;
+			}
+
+			try {
+				Cancellable? cancellable = null;
+
+				var tempdir = new TemporaryDirectory ();
+				var host_session = new LinuxHostSession (new LinuxHelperProcess (tempdir), tempdir, false);
+				host_session.enable_message_ring = true;
+
+				var options = HostSpawnOptions ();
+				uint pid = yield host_session.spawn (Frida.Test.Labrats.path_to_executable ("sleeper"), options, cancellable);
+
+				var id = yield host_session.attach (pid, make_parameters_dict (), cancellable);
+				var session = yield host_session.link_agent_session (id, h, cancellable);
+				assert_true (host_session.is_using_message_ring (id));
+
+				var received = new Gee.ArrayList<string> ();
+				size_t big_size = 0;
+				bool waiting = false;
+				var message_handler = h.message_from_script.connect ((script_id, message, data) => {
+					received.add (message);
+					if (data != null)
+						big_size = data.get_size ();
+					if (waiting)
+						message_ring.callback ();
+				});
+
+				// The large one doesn't fit in the ring, so it has to take D-Bus without overtaking its neighbors.
+				var script_id = yield session.create_script ("""
+					send('a');
+					setTimeout(() => {
+					  send('big', new ArrayBuffer(2 * 1024 * 1024));
+					  setTimeout(() => send('c'), 50);
+					}, 50);
+					recv('ping', () => send('pong'));
+					""", make_parameters_dict (), cancellable);
+				yield session.load_script (script_id, cancellable);
+
+				while (received.size < 3) {
+					waiting = true;
+					yield;
+					waiting = false;
+				}
+				assert_true (received[0] == "{\"type\":\"send\",\"payload\":\"a\"}");
+				assert_true (received[1] == "{\"type\":\"send\",\"payload\":\"big\"}");
+				assert_true (received[2] == "{\"type\":\"send\",\"payload\":\"c\"}");
+				assert_true (big_size == 2 * 1024 * 1024);
+
+				host_session.unlink_agent_session (id);
+				assert_false (host_session.is_using_message_ring (id));
+
+				session = yield host_session.link_agent_session (id, h, cancellable);
+				assert_true (host_session.is_using_message_ring (id));
+
+				yield session.post_messages ({ AgentMessage (SCRIPT, script_id, "{\"type\":\"ping\"}", false, {}) }, 0,
+					cancellable);
+				while (received.size < 4) {
+					waiting = true;
+					yield;
+					waiting = false;
+				}
+				assert_true (received[3] == "{\"type\":\"send\",\"payload\":\"pong\"}");
+				h.disconnect (message_handler);
+
+				yield host_session.kill (pid, cancellable);
+				yield host_session.close (cancellable);
+			} catch (GLib.Error e) {
+				printerr ("Unexpected error: %s\n", e.message);
+				assert_not_reached ();
+			}
+
+			h.done ();
+		}
+
 		private static async void fork (Harness h) {
 			yield Unix.run_fork_scenario (h, Frida.Test.Labrats.path_to_executable ("forker"));
 		}
@@ -1745,6 +3016,57 @@ namespace Frida.HostSessionTest {
 				}
 			}
 
+			private static async void agent_footprint (Harness h) {
+				if (!GLib.Test.slow ()) {
+					stdout.printf ("<skipping, run in slow mode> ");
+					h.done ();
+					return;
+				}
+
+				try {
+					Cancellable? cancellable = null;
+
+					int64 rss_before = read_rss ();
+					var timer = new Timer ();
+
+					var tempdir = new TemporaryDirectory ();
+					var host_session = new LinuxHostSession (new LinuxHelperProcess (tempdir), tempdir, false);
+					yield host_session.preload (cancellable);
+					int64 rss_idle = read_rss ();
+
+					var options = HostSpawnOptions ();
+					uint pid = yield host_session.spawn (Frida.Test.Labrats.path_to_executable ("sleeper"), options,
+						cancellable);
+					yield host_session.attach (pid, make_parameters_dict (), cancellable);
+					double cold_start = timer.elapsed ();
+					int64 rss_attached = read_rss ();
+
+					yield host_session.kill (pid, cancellable);
+					yield host_session.close (cancellable);
+
+					if (GLib.Test.verbose ()) {
+						stdout.printf (" [cold start to first attach: %.1f ms, RSS growth idle: %" + int64.FORMAT + " KiB, " +
+							"attached: %" + int64.FORMAT + " KiB] ", cold_start * 1000.0, rss_idle - rss_before,
+							rss_attached - rss_before);
+					}
+				} catch (GLib.Error e) {
+					printerr ("Unexpected error: %s\n", e.message);
+					assert_not_reached ();
+				}
+
+				h.done ();
+			}
+
+			private static int64 read_rss () throws GLib.Error {
+				string status;
+				FileUtils.get_contents ("/proc/self/status", out status);
+				foreach (unowned string line in status.split ("\n")) {
+					if (line.has_prefix ("VmRSS:"))
+						return int64.parse (line.substring (6).strip ().split (" ")[0]);
+				}
+				return 0;
+			}
+
 		}
 
 	}
@@ -3554,6 +4876,103 @@ namespace Frida.HostSessionTest {
 #if HAVE_FRUITY_BACKEND
 	namespace Fruity {
 
+		private static async void network_stack_throughput (Harness h) {
+			if (!GLib.Test.slow ()) {
+				stdout.printf ("<skipping, run in slow mode> ");
+				h.done ();
+				return;
+			}
+
+			h.disable_timeout ();
+
+			const size_t TOTAL_SIZE = 64 * 1024 * 1024;
+			const size_t CHUNK_SIZE = 64 * 1024;
+			const uint16 PORT = 1337;
+
+			var client_stack = new Frida.Fruity.VirtualNetworkStack (null, new InetAddress.from_string ("fd00::1"), 1500);
+			var server_stack = new Frida.Fruity.VirtualNetworkStack (null, new InetAddress.from_string ("fd00::2"), 1500);
+			client_stack.outgoing_datagrams.connect (datagrams => {
+				try {
+					server_stack.handle_incoming_datagrams (datagrams);
+				} catch (Error e) {
+				}
+			});
+			server_stack.outgoing_datagrams.connect (datagrams => {
+				try {
+					client_stack.handle_incoming_datagrams (datagrams);
+				} catch (Error e) {
+				}
+			});
+
+			try {
+				var listener = server_stack.create_tcp_listener (PORT);
+
+				var accept_request = new Promise<IOStream> ();
+				listener.accept.begin (null, (obj, res) => {
+					try {
+						accept_request.resolve (listener.accept.end (res));
+					} catch (GLib.Error e) {
+						accept_request.reject (e);
+					}
+				});
+
+				var client = yield client_stack.open_tcp_connection (new InetSocketAddress (server_stack.listener_ip, PORT));
+				var server = yield accept_request.future.wait_async (null);
+
+				var timer = new Timer ();
+
+				var send_request = new Promise<bool> ();
+				send_chunks.begin (client.output_stream, CHUNK_SIZE, TOTAL_SIZE / CHUNK_SIZE, send_request);
+
+				var buffer = new uint8[CHUNK_SIZE];
+				size_t received = 0;
+				while (received != TOTAL_SIZE) {
+					ssize_t n = yield server.input_stream.read_async (buffer);
+					assert_true (n > 0);
+					for (ssize_t i = 0; i != n; i++)
+						assert_true (buffer[i] == pattern_byte_at (received + i));
+					received += n;
+				}
+				yield send_request.future.wait_async (null);
+
+				double elapsed = timer.elapsed ();
+				if (GLib.Test.verbose ())
+					stdout.printf ("<%.0f MB/s> ", (TOTAL_SIZE / (1024.0 * 1024.0)) / elapsed);
+
+				yield client.close_async ();
+				yield server.close_async ();
+				listener.close ();
+			} catch (GLib.Error e) {
+				printerr ("\nFAIL: %s\n\n", e.message);
+				assert_not_reached ();
+			}
+
+			client_stack.stop ();
+			server_stack.stop ();
+
+			h.done ();
+		}
+
+		private static async void send_chunks (OutputStream output, size_t chunk_size, size_t count, Promise<bool> request) {
+			var chunk = new uint8[chunk_size];
+			try {
+				for (size_t i = 0; i != count; i++) {
+					for (size_t j = 0; j != chunk_size; j++)
+						chunk[j] = pattern_byte_at ((i * chunk_size) + j);
+
+					size_t bytes_written;
+					yield output.write_all_async (chunk, Priority.DEFAULT, null, out bytes_written);
+				}
+				request.resolve (true);
+			} catch (GLib.Error e) {
+				request.reject (e);
+			}
+		}
+
+		private static uint8 pattern_byte_at (size_t offset) {
+			return (uint8) (offset % 251);
+		}
+
 		private static async void backend (Harness h) {
 			if (!GLib.Test.slow ()) {
 				stdout.printf ("<skipping, run in slow mode with iOS device connected> ");
@@ -4147,6 +5566,170 @@ namespace Frida.HostSessionTest {
 				assert_true (actual_xml == expected_xml);
 			}
 
+			private static void binary_round_trip_shares_nothing_mutable () {
+				var original = make_app_list (3);
+				var a = new Frida.Fruity.PlistDict ();
+				a.set_string ("Kind", "twin");
+				var b = new Frida.Fruity.PlistDict ();
+				b.set_string ("Kind", "twin");
+				original.set_dict ("A", a);
+				original.set_dict ("B", b);
+
+				try {
+					var plist = new Frida.Fruity.Plist.from_binary (original.to_binary ());
+					assert_true (plist.size == original.size);
+
+					var apps = plist.get_array ("CurrentList");
+					assert_true (apps.length == 3);
+					for (int i = 0; i != 3; i++) {
+						var app = apps.get_dict (i);
+						assert_true (app.size == 6);
+						assert_true (app.get_string ("CFBundleIdentifier") == "re.frida.App%d".printf (i));
+						assert_true (app.get_string ("ApplicationType") == "User");
+						assert_true (app.get_integer ("StaticDiskUsage") == 1000000LL * (i + 1));
+						assert_true (app.get_bytes ("Token").length == 32);
+						assert_true (app.get_uid ("Owner").uid == 42);
+
+						var entitlements = app.get_dict ("Entitlements");
+						assert_true (entitlements.get_boolean ("get-task-allow"));
+						assert_true (entitlements.get_array ("keychain-access-groups").get_string (1) == "shared");
+					}
+
+					plist.get_dict ("A").set_string ("Kind", "changed");
+					assert_true (plist.get_dict ("A").get_string ("Kind") == "changed");
+					assert_true (plist.get_dict ("B").get_string ("Kind") == "twin");
+
+					apps.get_dict (0).get_dict ("Entitlements").remove ("get-task-allow");
+					assert_true (apps.get_dict (1).get_dict ("Entitlements").has ("get-task-allow"));
+
+					var reencoded = new Frida.Fruity.Plist.from_binary (plist.to_binary ());
+					assert_true (reencoded.get_dict ("A").get_string ("Kind") == "changed");
+				} catch (Frida.Fruity.PlistError e) {
+					printerr ("%s\n", e.message);
+					assert_not_reached ();
+				}
+			}
+
+			private static void binary_parser_survives_corrupt_input () {
+				uint8[] cyclic = {
+					'b', 'p', 'l', 'i', 's', 't', '0', '0',
+					0xd1, 0x01, 0x02,
+					0x51, 'a',
+					0xa1, 0x02,
+					0x08, 0x0b, 0x0d,
+					0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01,
+					0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03,
+					0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+					0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0f,
+				};
+				try {
+					new Frida.Fruity.Plist.from_binary (cyclic);
+					assert_not_reached ();
+				} catch (Frida.Fruity.PlistError e) {
+					assert_true (e is Frida.Fruity.PlistError.INVALID_DATA);
+				}
+
+				uint8[] fixture = make_app_list (4).to_binary ();
+
+				for (int length = 0; length != fixture.length; length++) {
+					try {
+						new Frida.Fruity.Plist.from_binary (fixture[0:length]);
+					} catch (Frida.Fruity.PlistError e) {
+						assert_true (e is Frida.Fruity.PlistError.INVALID_DATA);
+					}
+				}
+
+				var rng = new Rand.with_seed (1337);
+				for (int iteration = 0; iteration != 20000; iteration++) {
+					uint8[] mutated = fixture;
+					uint n = rng.int_range (1, 5);
+					for (uint i = 0; i != n; i++)
+						mutated[rng.int_range (0, mutated.length)] = (uint8) rng.int_range (0, 256);
+
+					try {
+						var plist = new Frida.Fruity.Plist.from_binary (mutated);
+						plist.to_binary ();
+					} catch (Frida.Fruity.PlistError e) {
+						assert_true (e is Frida.Fruity.PlistError.INVALID_DATA);
+					}
+				}
+			}
+
+			private static void binary_parser_collapses_duplicate_keys () {
+				uint8[] data = {
+					'b', 'p', 'l', 'i', 's', 't', '0', '0',
+					0xd1, 0x01, 0x02,
+					0x51, 'd',
+					0xd2, 0x03, 0x03, 0x04, 0x05,
+					0x51, 'a',
+					0x10, 0x01,
+					0x10, 0x02,
+					0x08, 0x0b, 0x0d, 0x12, 0x14, 0x16,
+					0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01,
+					0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06,
+					0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+					0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18,
+				};
+				try {
+					var plist = new Frida.Fruity.Plist.from_binary (data);
+					var dict = plist.get_dict ("d");
+					assert_true (dict.size == 1);
+					assert_true (dict.get_integer ("a") == 2);
+				} catch (Frida.Fruity.PlistError e) {
+					printerr ("%s\n", e.message);
+					assert_not_reached ();
+				}
+			}
+
+			private static void binary_parser_performance () {
+				uint8[] fixture = make_app_list (GLib.Test.slow () ? 2000 : 200).to_binary ();
+				const uint ITERATIONS = 50;
+
+				try {
+					var timer = new Timer ();
+					for (uint i = 0; i != ITERATIONS; i++) {
+						var plist = new Frida.Fruity.Plist.from_binary (fixture);
+						var apps = plist.get_array ("CurrentList");
+						for (int j = 0; j != apps.length; j++)
+							apps.get_dict (j).get_string ("CFBundleIdentifier");
+					}
+					double elapsed = timer.elapsed ();
+					if (GLib.Test.verbose ())
+						stdout.printf ("<%.0f MB/s> ", ((fixture.length * ITERATIONS) / (1024.0 * 1024.0)) / elapsed);
+				} catch (Frida.Fruity.PlistError e) {
+					printerr ("%s\n", e.message);
+					assert_not_reached ();
+				}
+			}
+
+			private static Frida.Fruity.Plist make_app_list (uint n) {
+				var plist = new Frida.Fruity.Plist ();
+				plist.set_string ("Status", "Complete");
+
+				var apps = new Frida.Fruity.PlistArray ();
+				for (uint i = 0; i != n; i++) {
+					var app = new Frida.Fruity.PlistDict ();
+					app.set_string ("CFBundleIdentifier", "re.frida.App%u".printf (i));
+					app.set_string ("ApplicationType", "User");
+					app.set_integer ("StaticDiskUsage", 1000000LL * (i + 1));
+					app.set_bytes ("Token", new Bytes (new uint8[32]));
+					app.set_uid ("Owner", new Frida.Fruity.PlistUid (42));
+
+					var entitlements = new Frida.Fruity.PlistDict ();
+					entitlements.set_boolean ("get-task-allow", true);
+					var groups = new Frida.Fruity.PlistArray ();
+					groups.add_string ("re.frida.App%u".printf (i));
+					groups.add_string ("shared");
+					entitlements.set_array ("keychain-access-groups", groups);
+					app.set_dict ("Entitlements", entitlements);
+
+					apps.add_dict (app);
+				}
+				plist.set_array ("CurrentList", apps);
+
+				return plist;
+			}
+
 #if DARWIN
 			private static void output_matches_apple_implementation () {
 				var request = new Frida.Fruity.Plist ();
@@ -22,6 +22,26 @@ namespace Frida.InjectorTest {
 
 		GLib.Test.add_func ("/Injector/resource-leaks", test_resource_leaks);
 
+		GLib.Test.add_func ("/Injector/Manual/performance", test_injection_performance);
+
+#if LINUX
+		GLib.Test.add_func ("/Injector/memfd-cache", test_memfd_cache);
+		GLib.Test.add_func ("/Injector/Manual/blob-injection-performance", test_blob_injection_performance);
+		GLib.Test.add_func ("/Injector/proc-maps", test_proc_maps);
+		GLib.Test.add_func ("/Injector/proc-maps-performance", test_proc_maps_performance);
+		GLib.Test.add_func ("/Injector/thread-suspend-scope", test_thread_suspend_scope);
+		GLib.Test.add_func ("/Injector/remote-memory-io", () => {
+			test_remote_memory_io (AUTO);
+		});
+		GLib.Test.add_func ("/Injector/remote-memory-io-via-proc-mem", () => {
+			test_remote_memory_io (PROC_MEM);
+		});
+		GLib.Test.add_func ("/Injector/remote-memory-io-via-ptrace", () => {
+			test_remote_memory_io (PTRACE);
+		});
+		GLib.Test.add_func ("/Injector/remote-memory-io-performance", test_remote_memory_io_performance);
+#endif
+
 #if DARWIN
 		GLib.Test.add_func ("/Injector/suspended-injection-current-arch", () => {
 			test_suspended_injection (Frida.Test.Arch.CURRENT);
@@ -145,6 +165,607 @@ namespace Frida.InjectorTest {
 		rat.close ();
 	}
 
+	private static void test_injection_performance () {
+		if (!GLib.Test.slow ()) {
+			stdout.printf ("<skipping, run in slow mode> ");
+			return;
+		}
+
+		var logfile = File.new_for_path (Frida.Test.path_to_temporary_file ("performance.log"));
+		var envp = new string[] {
+			"FRIDA_LABRAT_LOGFILE=" + logfile.get_path ()
+		};
+
+		var rat = new Labrat ("sleeper", envp);
+
+		var timer = new Timer ();
+		var durations = new double[100];
+#if LINUX
+		var phase_totals = new Gee.LinkedHashMap<string, int64?> ();
+#endif
+		for (int i = 0; i != durations.length; i++) {
+			timer.start ();
+			rat.inject ("simple-agent", "");
+			durations[i] = timer.elapsed ();
+
+#if LINUX
+			var phases = rat.query_injection_timeline ();
+			assert_true (phases.length != 0);
+			int64 previous_start = 0;
+			foreach (var phase in phases) {
+				assert_true (phase.start_time >= previous_start);
+				assert_true (phase.end_time >= phase.start_time);
+				previous_start = phase.start_time;
+
+				int64? total = phase_totals[phase.name];
+				phase_totals[phase.name] = ((total != null) ? total : 0) + (phase.end_time - phase.start_time);
+			}
+			assert_true (phase_totals.has_key ("inject"));
+#endif
+
+			rat.wait_for_uninject ();
+		}
+
+		if (GLib.Test.verbose ()) {
+			double total = 0;
+			var sorted = new Gee.ArrayList<double?> ();
+			foreach (var d in durations) {
+				total += d;
+				sorted.add (d);
+			}
+			sorted.sort ((a, b) => (a < b) ? -1 : ((a > b) ? 1 : 0));
+			stdout.printf (" [first: %.1f ms, average: %.1f ms, p50: %.1f ms, p90: %.1f ms, p99: %.1f ms, max: %.1f ms] ",
+				durations[0] * 1000.0, (total / durations.length) * 1000.0, percentile (sorted, 50) * 1000.0,
+				percentile (sorted, 90) * 1000.0, percentile (sorted, 99) * 1000.0, sorted.last () * 1000.0);
+#if LINUX
+			foreach (var e in phase_totals.entries)
+				stdout.printf ("[%s: %.2f ms] ", e.key, (e.value / durations.length) / 1000.0);
+#endif
+		}
+
+		rat.inject ("simple-agent", "0");
+		rat.wait_for_uninject ();
+		rat.wait_for_process_to_exit ();
+
+		try {
+			logfile.delete ();
+		} catch (GLib.Error delete_error) {
+			assert_not_reached ();
+		}
+
+		rat.close ();
+
+#if LINUX
+		measure_spawn_latency ();
+#endif
+	}
+
+	private static double percentile (Gee.List<double?> sorted, uint p) {
+		int index = (int) Math.ceil ((p / 100.0) * sorted.size) - 1;
+		return sorted[index.clamp (0, sorted.size - 1)];
+	}
+
+#if LINUX
+	private static void test_memfd_cache () {
+		if (!MemoryFileDescriptor.is_supported ()) {
+			stdout.printf ("<skipping, kernel too old> ");
+			return;
+		}
+
+		var cache = new SealedMemfdCache ();
+
+		var raw_blob = new uint8[64 * 1024];
+		for (uint i = 0; i != raw_blob.length; i++)
+			raw_blob[i] = (uint8) (i * 31);
+		var blob = new Bytes.take ((owned) raw_blob);
+
+		var first = cache.obtain ("memfd-cache-test.so", blob);
+
+		var second = cache.obtain ("memfd-cache-test.so", blob);
+		assert_true (second.fd == first.fd);
+
+		var third = cache.obtain ("memfd-cache-test.so", new Bytes (blob.get_data ()));
+		assert_true (third.fd == first.fd);
+
+		assert_true (cache.hits == 2);
+		assert_true (cache.misses == 1);
+
+		uint8 byte = 0x42;
+		Posix.lseek (first.fd, 0, Posix.SEEK_SET);
+		assert_true (Posix.write (first.fd, &byte, 1) == -1);
+
+		cache.max_entries = 1;
+		var other = cache.obtain ("memfd-cache-other.so", new Bytes ({ 1, 2, 3 }));
+		assert_true (other.fd != first.fd);
+		cache.obtain ("memfd-cache-test.so", blob);
+		assert_true (cache.misses == 3);
+	}
+
+	private static void test_blob_injection_performance () {
+		if (!GLib.Test.slow ()) {
+			stdout.printf ("<skipping, run in slow mode> ");
+			return;
+		}
+
+		if (!MemoryFileDescriptor.is_supported ()) {
+			stdout.printf ("<skipping, kernel too old> ");
+			return;
+		}
+
+		var logfile = File.new_for_path (Frida.Test.path_to_temporary_file ("blob-injection-performance.log"));
+		var envp = new string[] {
+			"FRIDA_LABRAT_LOGFILE=" + logfile.get_path ()
+		};
+
+		var rat = new Labrat ("sleeper", envp);
+
+		Bytes blob;
+		try {
+			uint8[] contents;
+			FileUtils.get_data (Frida.Test.Labrats.path_to_library ("simple-agent"), out contents);
+			blob = new Bytes.take ((owned) contents);
+		} catch (FileError e) {
+			assert_not_reached ();
+		}
+
+		var cache = SealedMemfdCache.get_default ();
+		var timer = new Timer ();
+		var cold = new Gee.ArrayList<double?> ();
+		var warm = new Gee.ArrayList<double?> ();
+		for (int i = 0; i != 20; i++) {
+			bool is_cold = i % 2 == 0;
+			if (is_cold)
+				cache.clear ();
+
+			uint64 hits_before = cache.hits;
+			timer.start ();
+			rat.inject_blob (blob, "");
+			double duration = timer.elapsed ();
+			assert_true (cache.hits == (is_cold ? hits_before : hits_before + 1));
+
+			if (is_cold)
+				cold.add (duration);
+			else
+				warm.add (duration);
+
+			rat.wait_for_uninject ();
+		}
+
+		if (GLib.Test.verbose ()) {
+			Gee.Comparator<double?> by_value = (a, b) => (a < b) ? -1 : ((a > b) ? 1 : 0);
+			cold.sort (by_value);
+			warm.sort (by_value);
+			stdout.printf (" [cold p50: %.1f ms, warm p50: %.1f ms, cold max: %.1f ms, warm max: %.1f ms] ",
+				percentile (cold, 50) * 1000.0, percentile (warm, 50) * 1000.0, cold.last () * 1000.0,
+				warm.last () * 1000.0);
+		}
+
+		rat.inject ("simple-agent", "0");
+		rat.wait_for_uninject ();
+		rat.wait_for_process_to_exit ();
+
+		try {
+			logfile.delete ();
+		} catch (GLib.Error delete_error) {
+		}
+
+		rat.close ();
+	}
+
+	private static void test_proc_maps () {
+		var maps = ProcMaps.parse ("""
+5581c4a00000-5581c4a02000 r--p 00000000 fd:01 1234                       /usr/bin/cat
+7f0000000000-7f0000001000 r--p 00000000 fd:01 9999                       /usr/lib/libfoo.so
+7f0000001000-7f0000002000 rw-p 00000000 00:00 0
+7f0000002000-7f0000004000 r-xp 00001000 fd:01 9999                       /usr/lib/libfoo.so
+7f0000004000-7f0000005000 r--p 00003000 fd:01 9999                       /usr/lib/libfoo.so
+7f0000005000-7f0000006000 rw-p 00000000 00:00 0
+7f0000006000-7f0000007000 rw-p 00004000 fd:01 9999                       /usr/lib/libfoo.so
+7f0000100000-7f0000101000 r--p 00000000 fd:01 9999                       /usr/lib/libfoo.so
+7ffd00000000-7ffd00021000 rw-p 00000000 00:00 0                          [stack]
+""");
+
+		var module = maps.find_so_by_path ("/usr/lib/libfoo.so");
+		assert_nonnull (module);
+		assert_true (module.base_address == 0x7f0000000000);
+		assert_true (module.identity == "fd:01 9999");
+
+		assert_null (maps.find_so_by_path ("/usr/lib/libbar.so"));
+		assert_null (maps.find_so_by_path (""));
+
+		var code = maps.find_so_by_address (0x7f0000002800);
+		assert_nonnull (code);
+		assert_true (code.base_address == 0x7f0000002000);
+		assert_true (code.path == "/usr/lib/libfoo.so");
+
+		assert_null (maps.find_so_by_address (0x7f0000001800));
+		assert_null (maps.find_so_by_address (0x7f0000050000));
+	}
+
+	private static void test_proc_maps_performance () {
+		if (!GLib.Test.slow ()) {
+			stdout.printf ("<skipping, run in slow mode> ");
+			return;
+		}
+
+		const uint NUM_MODULES = 12500;
+		const uint NUM_ITERATIONS = 10;
+
+		var builder = new StringBuilder.sized (NUM_MODULES * 4 * 96);
+		uint64 address = 0x7f0000000000;
+		string[] protections = { "r--p", "r-xp", "r--p", "rw-p" };
+		for (uint i = 0; i != NUM_MODULES; i++) {
+			var path = "/usr/lib/libmodule%u.so".printf (i);
+			for (uint j = 0; j != protections.length; j++) {
+				builder.append_printf ("%" + uint64.FORMAT_MODIFIER + "x-%" + uint64.FORMAT_MODIFIER +
+					"x %s %08x fd:01 %u                    %s\n",
+					address, address + 0x1000, protections[j], j * 0x1000, 1000 + i, path);
+				address += 0x1000;
+			}
+		}
+		string contents = builder.str;
+		string needle = "/usr/lib/libmodule%u.so".printf (NUM_MODULES - 1);
+		uint64 expected_base = address - 0x4000;
+
+		var timer = new Timer ();
+		for (uint i = 0; i != NUM_ITERATIONS; i++) {
+			var module = ProcMaps.parse (contents).find_so_by_path (needle);
+			assert_nonnull (module);
+			assert_true (module.base_address == expected_base);
+		}
+		double indexed = timer.elapsed ();
+
+		timer.start ();
+		for (uint i = 0; i != NUM_ITERATIONS; i++)
+			assert_true (find_base_by_path_using_regex (contents, needle) == expected_base);
+		double regex = timer.elapsed ();
+
+		if (GLib.Test.verbose ()) {
+			stdout.printf (" [%u mappings: indexed %.2f ms, regex %.2f ms] ", NUM_MODULES * 4,
+				(indexed / NUM_ITERATIONS) * 1000.0, (regex / NUM_ITERATIONS) * 1000.0);
+		}
+	}
+
+	private static uint64 find_base_by_path_using_regex (string contents, string path) {
+		MatchInfo info;
+		if (!/^([0-9a-f]+)-([0-9a-f]+) (\S{4}) ([0-9a-f]+) ([0-9a-f]{2,}:[0-9a-f]{2,} \d+) +([^\n]+)$/m.match (contents, 0,
+				out info)) {
+			return 0;
+		}
+
+		uint64 base_address = 0;
+		do {
+			if (info.fetch (6) == path && uint64.parse (info.fetch (4), 16) == 0)
+				base_address = uint64.parse (info.fetch (1), 16);
+			try {
+				info.next ();
+			} catch (RegexError e) {
+				break;
+			}
+		} while (info.matches ());
+
+		return base_address;
+	}
+
+	private static void test_thread_suspend_scope () {
+		var loop = new MainLoop ();
+		perform_thread_suspend_scope.begin (loop);
+		loop.run ();
+	}
+
+	private static async void perform_thread_suspend_scope (MainLoop loop) {
+		const uint NUM_THREADS = 8;
+
+		var pid = Posix.fork ();
+		assert_true (pid != -1);
+		if (pid == 0) {
+			for (uint i = 0; i != NUM_THREADS; i++) {
+				new Thread<bool> ("idler", () => {
+					while (true)
+						Posix.pause ();
+				});
+			}
+			while (true)
+				Posix.pause ();
+		}
+
+		try {
+			int64 deadline = get_monotonic_time () + (5 * TimeSpan.SECOND);
+			while (enumerate_thread_states (pid).size != NUM_THREADS + 1) {
+				assert_true (get_monotonic_time () < deadline);
+				yield sleep (10);
+			}
+
+			var scope = new ThreadSuspendScope (pid);
+			yield scope.enable (null);
+			foreach (var state in enumerate_thread_states (pid))
+				assert_true (state == "t");
+			scope.disable ();
+			yield wait_until_untraced (pid);
+
+			var cancellable = new Cancellable ();
+			cancellable.cancel ();
+			scope = new ThreadSuspendScope (pid);
+			try {
+				yield scope.enable (cancellable);
+				assert_not_reached ();
+			} catch (IOError e) {
+				assert_true (e is IOError.CANCELLED);
+			}
+			yield wait_until_untraced (pid);
+
+			scope = new ThreadSuspendScope (pid);
+			yield scope.enable (null);
+			scope.disable ();
+			yield wait_until_untraced (pid);
+		} catch (GLib.Error e) {
+			printerr ("\nFAIL: %s\n\n", e.message);
+			assert_not_reached ();
+		} finally {
+			reap_memory_twin (pid);
+		}
+
+		loop.quit ();
+	}
+
+	private static Gee.List<string> enumerate_thread_states (Posix.pid_t pid) {
+		var states = new Gee.ArrayList<string> ();
+		try {
+			var dir = Dir.open ("/proc/%u/task".printf (pid));
+			string? name;
+			while ((name = dir.read_name ()) != null) {
+				string stat;
+				FileUtils.get_contents ("/proc/%u/task/%s/stat".printf (pid, name), out stat);
+				states.add (stat.substring (stat.last_index_of_char (')') + 2, 1));
+			}
+		} catch (FileError e) {
+			assert_not_reached ();
+		}
+		return states;
+	}
+
+	private static async void wait_until_untraced (Posix.pid_t pid) {
+		int64 deadline = get_monotonic_time () + (10 * TimeSpan.SECOND);
+		while (true) {
+			bool any_traced = false;
+			try {
+				var dir = Dir.open ("/proc/%u/task".printf (pid));
+				string? name;
+				while ((name = dir.read_name ()) != null) {
+					string status;
+					FileUtils.get_contents ("/proc/%u/task/%s/status".printf (pid, name), out status);
+					if (!("\nTracerPid:\t0\n" in status))
+						any_traced = true;
+				}
+			} catch (FileError e) {
+				assert_not_reached ();
+			}
+			if (!any_traced)
+				return;
+
+			assert_true (get_monotonic_time () < deadline);
+			yield sleep (10);
+		}
+	}
+
+	private static async void sleep (uint milliseconds) {
+		var source = new TimeoutSource (milliseconds);
+		source.set_callback (sleep.callback);
+		source.attach (MainContext.get_thread_default ());
+		yield;
+	}
+
+	private static void measure_spawn_latency () {
+		var loop = new MainLoop ();
+		perform_spawn_latency_measurement.begin (loop);
+		loop.run ();
+	}
+
+	private static async void perform_spawn_latency_measurement (MainLoop loop) {
+		var backend = new LinuxHelperBackend ();
+		var path = Frida.Test.Labrats.path_to_executable ("sleeper");
+
+		var durations = new Gee.ArrayList<double?> ();
+		var timer = new Timer ();
+		try {
+			for (int i = 0; i != 20; i++) {
+				timer.start ();
+				uint pid = yield backend.spawn (path, HostSpawnOptions (), null);
+				durations.add (timer.elapsed ());
+
+				yield backend.kill (pid, null);
+			}
+
+			yield backend.close (null);
+		} catch (GLib.Error e) {
+			printerr ("\nFAIL: %s\n\n", e.message);
+			assert_not_reached ();
+		}
+
+		if (GLib.Test.verbose ()) {
+			durations.sort ((a, b) => (a < b) ? -1 : ((a > b) ? 1 : 0));
+			stdout.printf ("[spawn until gated p50: %.2f ms, p90: %.2f ms] ", percentile (durations, 50) * 1000.0,
+				percentile (durations, 90) * 1000.0);
+		}
+
+		loop.quit ();
+	}
+
+	private static void test_remote_memory_io (SeizeSession.MemoryBackend backend) {
+		var loop = new MainLoop ();
+		perform_remote_memory_io.begin (backend, loop);
+		loop.run ();
+	}
+
+	private static async void perform_remote_memory_io (SeizeSession.MemoryBackend backend, MainLoop loop) {
+		size_t page_size = Gum.query_page_size ();
+		size_t size = 3 * page_size;
+		uint8 * pages = Gum.Memory.allocate (null, size, page_size, READ | WRITE);
+		for (size_t i = 0; i != size; i++)
+			pages[i] = (uint8) (i * 7 + 3);
+		Gum.mprotect (pages + page_size, page_size, NO_ACCESS);
+
+		var twin = fork_memory_twin ();
+		try {
+			var session = yield seize (twin);
+			session.memory_backend = backend;
+			uint64 base_address = (uint64) (uintptr) pages;
+
+			var ranges = new RemoteMemoryRange[3000];
+			size_t expected_size = 0;
+			for (uint i = 0; i != ranges.length; i++) {
+				size_t offset = ((i % 2 == 0) ? 0 : 2 * page_size) + ((i * 37) % (page_size - 5));
+				size_t n = 1 + (i % 5);
+				ranges[ranges.length - 1 - i] = RemoteMemoryRange (base_address + offset, n);
+				expected_size += n;
+			}
+			var gathered = session.read_memory_ranges (ranges);
+			assert_true (gathered.length == expected_size);
+			size_t cursor = 0;
+			foreach (var r in ranges) {
+				assert_true (Memory.cmp ((uint8 *) gathered + cursor, (void *) (uintptr) r.address, r.size) == 0);
+				cursor += r.size;
+			}
+
+			var whole = session.read_memory_ranges ({
+				RemoteMemoryRange (base_address + page_size - 16, 16),
+				RemoteMemoryRange (base_address, size),
+			});
+			Gum.mprotect (pages + page_size, page_size, READ);
+			assert_true (Memory.cmp (whole, pages + page_size - 16, 16) == 0);
+			assert_true (Memory.cmp ((uint8 *) whole + 16, pages, size) == 0);
+
+			var payload = new uint8[64];
+			for (uint i = 0; i != payload.length; i++)
+				payload[i] = (uint8) (0xff - i);
+			var writes = new RemoteMemoryRange[] {
+				RemoteMemoryRange (base_address + 2 * page_size + 100, 16),
+				RemoteMemoryRange (base_address + page_size - 8, 16),
+				RemoteMemoryRange (base_address + 4, 32),
+			};
+			session.write_memory_ranges (writes, payload);
+			var written = session.read_memory_ranges (writes);
+			assert_true (Memory.cmp (written, payload, payload.length) == 0);
+
+			session.close ();
+		} catch (GLib.Error e) {
+			printerr ("\nFAIL: %s\n\n", e.message);
+			assert_not_reached ();
+		} finally {
+			reap_memory_twin (twin);
+			Gum.Memory.free (pages, size);
+		}
+
+		loop.quit ();
+	}
+
+	private static void test_remote_memory_io_performance () {
+		if (!GLib.Test.slow ()) {
+			stdout.printf ("<skipping, run in slow mode> ");
+			return;
+		}
+
+		var loop = new MainLoop ();
+		perform_remote_memory_io_performance.begin (loop);
+		loop.run ();
+	}
+
+	private static async void perform_remote_memory_io_performance (MainLoop loop) {
+		const uint NUM_RANGES = 4096;
+		const size_t RANGE_SIZE = 64;
+		const uint NUM_ITERATIONS = 50;
+		const size_t LARGE_SIZE = 8 * 1024 * 1024;
+		const uint NUM_LARGE_ITERATIONS = 4;
+
+		var buffer = new uint8[NUM_RANGES * RANGE_SIZE * 2];
+		for (uint i = 0; i != buffer.length; i++)
+			buffer[i] = (uint8) (i * 13);
+		uint64 base_address = (uint64) (uintptr) buffer;
+
+		var ranges = new RemoteMemoryRange[NUM_RANGES];
+		for (uint i = 0; i != NUM_RANGES; i++)
+			ranges[i] = RemoteMemoryRange (base_address + (i * 2 * RANGE_SIZE), RANGE_SIZE);
+
+		var large = new uint8[LARGE_SIZE];
+		for (uint i = 0; i != large.length; i++)
+			large[i] = (uint8) (i * 7);
+
+		var twin = fork_memory_twin ();
+		try {
+			var session = yield seize (twin);
+
+			var timer = new Timer ();
+			for (uint i = 0; i != NUM_ITERATIONS; i++) {
+				foreach (var r in ranges)
+					session.read_memory (r.address, r.size);
+			}
+			double per_range = timer.elapsed ();
+
+			if (GLib.Test.verbose ()) {
+				stdout.printf (" [%u ranges of %u bytes: per-range %.2f ms] ", NUM_RANGES, (uint) RANGE_SIZE,
+					(per_range / NUM_ITERATIONS) * 1000.0);
+			}
+
+			var backends = new SeizeSession.MemoryBackend[] { AUTO, PROC_MEM, PTRACE };
+			string[] backend_names = { "auto", "/proc/pid/mem", "ptrace" };
+			for (uint b = 0; b != backends.length; b++) {
+				session.memory_backend = backends[b];
+
+				timer.start ();
+				for (uint i = 0; i != NUM_ITERATIONS; i++) {
+					var data = session.read_memory_ranges (ranges);
+					assert_true (data.length == NUM_RANGES * RANGE_SIZE);
+				}
+				double scattered = timer.elapsed ();
+
+				timer.start ();
+				for (uint i = 0; i != NUM_LARGE_ITERATIONS; i++) {
+					var data = session.read_memory ((uint64) (uintptr) large, large.length);
+					assert_true (Memory.cmp (data, large, large.length) == 0);
+				}
+				double contiguous = timer.elapsed ();
+
+				if (GLib.Test.verbose ()) {
+					stdout.printf ("[%s: scattered %.2f ms, %u MiB contiguous %.2f ms] ", backend_names[b],
+						(scattered / NUM_ITERATIONS) * 1000.0, (uint) (LARGE_SIZE / (1024 * 1024)),
+						(contiguous / NUM_LARGE_ITERATIONS) * 1000.0);
+				}
+			}
+
+			session.close ();
+		} catch (GLib.Error e) {
+			printerr ("\nFAIL: %s\n\n", e.message);
+			assert_not_reached ();
+		} finally {
+			reap_memory_twin (twin);
+		}
+
+		loop.quit ();
+	}
+
+	private static Posix.pid_t fork_memory_twin () {
+		var pid = Posix.fork ();
+		assert_true (pid != -1);
+		if (pid == 0) {
+			while (true)
+				Posix.pause ();
+		}
+		return pid;
+	}
+
+	private static void reap_memory_twin (Posix.pid_t pid) {
+		Posix.kill (pid, Posix.Signal.KILL);
+		int status;
+		Posix.waitpid (pid, out status, 0);
+	}
+
+	private static async SeizeSession seize (Posix.pid_t pid) throws GLib.Error {
+		var session = (SeizeSession) Object.new (typeof (SeizeSession), "pid", (uint) pid);
+		yield ((AsyncInitable) session).init_async (Priority.DEFAULT, null);
+		return session;
+	}
+#endif
+
 #if DARWIN
 	private static void test_suspended_injection (Frida.Test.Arch arch) {
 		var logfile = File.new_for_path (Frida.Test.path_to_temporary_file ("suspended-injection.log"));
@@ -185,6 +806,7 @@ namespace Frida.InjectorTest {
 		}
 
 		private Injector? injector;
+		private uint last_id;
 		private Gee.Queue<uint> uninjections = new Gee.ArrayQueue<uint> ();
 		private PendingUninject? pending_uninject;
 
@@ -258,7 +880,7 @@ namespace Frida.InjectorTest {
 				var path = Frida.Test.Labrats.path_to_library (name, arch);
 				assert_true (FileUtils.test (path, FileTest.EXISTS));
 
-				yield injector.inject_library_file (process.id, path, "frida_agent_main", data);
+				last_id = yield injector.inject_library_file (process.id, path, "frida_agent_main", data);
 			} catch (GLib.Error e) {
 				printerr ("\nFAIL: %s\n\n", e.message);
 				assert_not_reached ();
@@ -267,6 +889,50 @@ namespace Frida.InjectorTest {
 			loop.quit ();
 		}
 
+#if LINUX
+		public void inject_blob (Bytes blob, string data) {
+			var loop = new MainLoop ();
+			Idle.add (() => {
+				perform_blob_injection.begin (blob, data, loop);
+				return false;
+			});
+			loop.run ();
+		}
+
+		private async void perform_blob_injection (Bytes blob, string data, MainLoop loop) {
+			if (injector == null) {
+				injector = Injector.new ();
+				injector.uninjected.connect (on_uninjected);
+			}
+
+			try {
+				last_id = yield injector.inject_library_blob (process.id, blob, "frida_agent_main", data);
+			} catch (GLib.Error e) {
+				printerr ("\nFAIL: %s\n\n", e.message);
+				assert_not_reached ();
+			}
+
+			loop.quit ();
+		}
+
+		public InjectionPhaseInfo[] query_injection_timeline () {
+			InjectionPhaseInfo[] phases = {};
+			var loop = new MainLoop ();
+			var linjector = (Linjector) injector;
+			linjector.query_injection_timeline.begin (last_id, null, (obj, res) => {
+				try {
+					phases = linjector.query_injection_timeline.end (res);
+				} catch (GLib.Error e) {
+					printerr ("\nFAIL: %s\n\n", e.message);
+					assert_not_reached ();
+				}
+				loop.quit ();
+			});
+			loop.run ();
+			return phases;
+		}
+
+#endif
 		public void wait_for_uninject () {
 			var success = try_wait_for_uninject (5000);
 			assert_true (success);
@@ -0,0 +1,470 @@
+namespace Frida.PackageManagerTest {
+	public static void add_tests () {
+		GLib.Test.add_func ("/PackageManager/warm-cache-avoids-registry", () => {
+			var h = new Harness ((h) => warm_cache_avoids_registry.begin (h as Harness));
+			h.run ();
+		});
+
+		GLib.Test.add_func ("/PackageManager/corrupt-cache-entry-is-refetched", () => {
+			var h = new Harness ((h) => corrupt_cache_entry_is_refetched.begin (h as Harness));
+			h.run ();
+		});
+
+		GLib.Test.add_func ("/PackageManager/search-is-not-cached", () => {
+			var h = new Harness ((h) => search_is_not_cached.begin (h as Harness));
+			h.run ();
+		});
+
+		GLib.Test.add_func ("/PackageManager/cache-is-pruned-to-size", () => {
+			var h = new Harness ((h) => cache_is_pruned_to_size.begin (h as Harness));
+			h.run ();
+		});
+
+		GLib.Test.add_func ("/PackageManager/cached-tarball-survives-extraction-failure", () => {
+			var h = new Harness ((h) => cached_tarball_survives_extraction_failure.begin (h as Harness));
+			h.run ();
+		});
+
+		GLib.Test.add_func ("/PackageManager/tampered-tarball-is-evicted", () => {
+			var h = new Harness ((h) => tampered_tarball_is_evicted.begin (h as Harness));
+			h.run ();
+		});
+
+		GLib.Test.add_func ("/PackageManager/downloads-are-bounded", () => {
+			var h = new Harness ((h) => downloads_are_bounded.begin (h as Harness));
+			h.run ();
+		});
+	}
+
+	private static async void warm_cache_avoids_registry (Harness h) {
+		try {
+			var registry = new StandInRegistry ();
+			var workspace = new Workspace ();
+
+			var pm = registry.make_package_manager (workspace);
+			yield pm.install (workspace.make_install_options ("a"));
+			assert_true (registry.manifest_requests == 1);
+			assert_true (registry.tarball_requests == 1);
+			assert_true (workspace.project_file ("a", "node_modules/frida-test-pkg/index.js").query_exists ());
+
+			yield pm.install (workspace.make_install_options ("b"));
+			assert_true (registry.manifest_requests == 1);
+			assert_true (registry.tarball_requests == 1);
+			assert_true (workspace.project_file ("b", "node_modules/frida-test-pkg/index.js").query_exists ());
+
+			workspace.destroy ();
+			registry.stop ();
+		} catch (GLib.Error e) {
+			printerr ("\nFAIL: %s\n\n", e.message);
+			assert_not_reached ();
+		}
+
+		h.done ();
+	}
+
+	private static async void corrupt_cache_entry_is_refetched (Harness h) {
+		try {
+			var registry = new StandInRegistry ();
+			var workspace = new Workspace ();
+
+			var pm = registry.make_package_manager (workspace);
+			yield pm.install (workspace.make_install_options ("a"));
+			assert_true (registry.manifest_requests == 1);
+
+			workspace.corrupt_cached_responses ();
+
+			yield pm.install (workspace.make_install_options ("b"));
+			assert_true (registry.manifest_requests == 2);
+			assert_true (registry.tarball_requests == 1);
+
+			pm.offline = true;
+			yield pm.install (workspace.make_install_options ("c"));
+			assert_true (registry.manifest_requests == 2);
+
+			workspace.corrupt_cached_responses ();
+			try {
+				yield pm.install (workspace.make_install_options ("d"));
+				assert_not_reached ();
+			} catch (Error e) {
+				assert_true (e is Error.TRANSPORT);
+			}
+			assert_true (registry.manifest_requests == 2);
+
+			workspace.destroy ();
+			registry.stop ();
+		} catch (GLib.Error e) {
+			printerr ("\nFAIL: %s\n\n", e.message);
+			assert_not_reached ();
+		}
+
+		h.done ();
+	}
+
+	private static async void search_is_not_cached (Harness h) {
+		try {
+			var registry = new StandInRegistry ();
+			var workspace = new Workspace ();
+
+			var pm = registry.make_package_manager (workspace);
+			var result = yield pm.search ("test");
+			assert_true (result.total == 1);
+			result = yield pm.search ("test");
+			assert_true (result.total == 1);
+			assert_true (registry.search_requests == 2);
+			assert_false (workspace.cache_dir.get_child ("index").query_exists ());
+
+			workspace.destroy ();
+			registry.stop ();
+		} catch (GLib.Error e) {
+			printerr ("\nFAIL: %s\n\n", e.message);
+			assert_not_reached ();
+		}
+
+		h.done ();
+	}
+
+	private static async void cache_is_pruned_to_size (Harness h) {
+		try {
+			var registry = new StandInRegistry ();
+			var workspace = new Workspace ();
+
+			var pm = registry.make_package_manager (workspace);
+			pm.cache_max_size = 0;
+			yield pm.install (workspace.make_install_options ("a"));
+			assert_true (workspace.count_cached_blobs () == 0);
+
+			pm.cache_max_size = 1024 * 1024;
+			yield pm.install (workspace.make_install_options ("b"));
+			assert_true (workspace.count_cached_blobs () == 2);
+			assert_true (registry.tarball_requests == 2);
+
+			workspace.destroy ();
+			registry.stop ();
+		} catch (GLib.Error e) {
+			printerr ("\nFAIL: %s\n\n", e.message);
+			assert_not_reached ();
+		}
+
+		h.done ();
+	}
+
+	private static async void cached_tarball_survives_extraction_failure (Harness h) {
+		try {
+			var registry = new StandInRegistry ();
+			var workspace = new Workspace ();
+
+			var pm = registry.make_package_manager (workspace);
+			yield pm.install (workspace.make_install_options ("a"));
+			assert_true (workspace.count_cached_blobs () == 2);
+
+			var options = workspace.make_install_options ("b");
+			FileUtils.set_contents (workspace.project_file ("b", "node_modules").get_path (), "");
+			try {
+				yield pm.install (options);
+				assert_not_reached ();
+			} catch (Error e) {
+			}
+			assert_true (workspace.count_cached_blobs () == 2);
+
+			yield pm.install (workspace.make_install_options ("c"));
+			assert_true (registry.tarball_requests == 1);
+
+			workspace.destroy ();
+			registry.stop ();
+		} catch (GLib.Error e) {
+			printerr ("\nFAIL: %s\n\n", e.message);
+			assert_not_reached ();
+		}
+
+		h.done ();
+	}
+
+	private static async void tampered_tarball_is_evicted (Harness h) {
+		try {
+			var registry = new StandInRegistry ();
+			var workspace = new Workspace ();
+
+			var pm = registry.make_package_manager (workspace);
+			yield pm.install (workspace.make_install_options ("a"));
+
+			workspace.tamper_with_cached_tarballs ();
+			try {
+				yield pm.install (workspace.make_install_options ("b"));
+				assert_not_reached ();
+			} catch (Error e) {
+				assert_true (e is Error.PROTOCOL);
+			}
+			assert_true (workspace.count_cached_blobs () == 1);
+
+			yield pm.install (workspace.make_install_options ("c"));
+			assert_true (registry.tarball_requests == 2);
+			assert_true (workspace.project_file ("c", "node_modules/frida-test-pkg/index.js").query_exists ());
+
+			workspace.destroy ();
+			registry.stop ();
+		} catch (GLib.Error e) {
+			printerr ("\nFAIL: %s\n\n", e.message);
+			assert_not_reached ();
+		}
+
+		h.done ();
+	}
+
+	private static async void downloads_are_bounded (Harness h) {
+		try {
+			var registry = new StandInRegistry (5);
+			registry.tarball_delay = 100;
+			var workspace = new Workspace ();
+
+			var pm = registry.make_package_manager (workspace);
+			var options = workspace.make_install_options ("a");
+			for (uint i = 1; i <= 5; i++)
+				options.add_spec ("frida-test-pkg-%u@1.0.0".printf (i));
+			options.max_concurrent_downloads = 2;
+			yield pm.install (options);
+
+			assert_true (registry.tarball_requests == 6);
+			assert_true (registry.max_tarballs_in_flight == 2);
+			for (uint i = 1; i <= 5; i++) {
+				assert_true (workspace.project_file ("a",
+					"node_modules/frida-test-pkg-%u/index.js".printf (i)).query_exists ());
+			}
+
+			workspace.destroy ();
+			registry.stop ();
+		} catch (GLib.Error e) {
+			printerr ("\nFAIL: %s\n\n", e.message);
+			assert_not_reached ();
+		}
+
+		h.done ();
+	}
+
+	private sealed class StandInRegistry : Object {
+		public uint manifest_requests = 0;
+		public uint tarball_requests = 0;
+		public uint search_requests = 0;
+
+		public uint tarball_delay = 0;
+		public uint tarballs_in_flight = 0;
+		public uint max_tarballs_in_flight = 0;
+
+		public string base_url {
+			get;
+			private set;
+		}
+
+		private Soup.Server server;
+		private Gee.Map<string, Package> packages = new Gee.HashMap<string, Package> ();
+
+		private const string PACKAGE_NAME = "frida-test-pkg";
+		private const string PACKAGE_VERSION = "1.0.0";
+
+		private class Package {
+			public Bytes tarball;
+			public string integrity;
+		}
+
+		public StandInRegistry (uint extra_packages = 0) throws GLib.Error {
+			add_package (PACKAGE_NAME);
+			for (uint i = 1; i <= extra_packages; i++)
+				add_package ("%s-%u".printf (PACKAGE_NAME, i));
+
+			server = (Soup.Server) Object.new (typeof (Soup.Server));
+			server.add_handler (null, on_request);
+			server.listen_local (0, IPV4_ONLY);
+
+			SList<Uri> uris = server.get_uris ();
+			base_url = "http://127.0.0.1:%d".printf (uris.data.get_port ());
+		}
+
+		public void stop () {
+			server.disconnect ();
+		}
+
+		private void add_package (string name) throws GLib.Error {
+			string package_json = "{\"name\":\"%s\",\"version\":\"%s\"}".printf (name, PACKAGE_VERSION);
+			var package = new Package ();
+			package.tarball = make_tarball ({
+				"package/package.json", package_json,
+				"package/index.js", "module.exports = 42;\n",
+			});
+			package.integrity = compute_integrity (package.tarball);
+			packages[name] = package;
+		}
+
+		public PackageManager make_package_manager (Workspace workspace) {
+			var pm = new PackageManager ();
+			pm.registry = base_url;
+			pm.cache_dir = workspace.cache_dir.get_path ();
+			return pm;
+		}
+
+		private void on_request (Soup.Server server, Soup.ServerMessage msg, string path, HashTable<string, string>? query) {
+			string body;
+			if (path == "/-/v1/search") {
+				search_requests++;
+				body = ("{\"objects\":[{\"package\":{\"name\":\"%s\",\"version\":\"%s\",\"description\":\"Test\"," +
+					"\"links\":{\"npm\":\"%s/%s\"}}}],\"total\":1}").printf (PACKAGE_NAME, PACKAGE_VERSION, base_url,
+					PACKAGE_NAME);
+			} else {
+				string[] tokens = path.split ("/");
+				Package? package = (tokens.length >= 3) ? packages[tokens[1]] : null;
+				if (package == null) {
+					msg.set_status (Soup.Status.NOT_FOUND, null);
+					return;
+				}
+				unowned string name = tokens[1];
+
+				if (path == "/%s/%s".printf (name, PACKAGE_VERSION)) {
+					manifest_requests++;
+					body = ("{\"name\":\"%s\",\"version\":\"%s\",\"dist\":{\"tarball\":\"%s/%s/-/%s-%s.tgz\"," +
+						"\"integrity\":\"%s\"}}").printf (name, PACKAGE_VERSION, base_url, name, name, PACKAGE_VERSION,
+						package.integrity);
+				} else if (path == "/%s/-/%s-%s.tgz".printf (name, name, PACKAGE_VERSION)) {
+					tarball_requests++;
+					if (tarball_delay != 0)
+						serve_tarball_slowly (msg, package.tarball);
+					else
+						serve_tarball (msg, package.tarball);
+					return;
+				} else {
+					msg.set_status (Soup.Status.NOT_FOUND, null);
+					return;
+				}
+			}
+
+			msg.set_status (Soup.Status.OK, null);
+			msg.set_response ("application/json", Soup.MemoryUse.COPY, body.data);
+		}
+
+		private static void serve_tarball (Soup.ServerMessage msg, Bytes tarball) {
+			msg.set_status (Soup.Status.OK, null);
+			msg.set_response ("application/octet-stream", Soup.MemoryUse.COPY, tarball.get_data ());
+		}
+
+		private void serve_tarball_slowly (Soup.ServerMessage msg, Bytes tarball) {
+			tarballs_in_flight++;
+			max_tarballs_in_flight = uint.max (max_tarballs_in_flight, tarballs_in_flight);
+
+			msg.pause ();
+			var source = new TimeoutSource (tarball_delay);
+			source.set_callback (() => {
+				tarballs_in_flight--;
+				serve_tarball (msg, tarball);
+				msg.unpause ();
+				return Source.REMOVE;
+			});
+			source.attach (MainContext.get_thread_default ());
+		}
+
+		private static Bytes make_tarball (string[] entries) throws GLib.Error {
+			var tar = new ByteArray ();
+			for (int i = 0; i != entries.length; i += 2) {
+				unowned string name = entries[i];
+				unowned string contents = entries[i + 1];
+
+				var header = new uint8[512];
+				Memory.copy (header, name, name.length);
+				Memory.copy ((uint8 *) header + 100, "0000644", 7);
+				string size = "%011o".printf (contents.length);
+				Memory.copy ((uint8 *) header + 124, size, size.length);
+				header[156] = '0';
+				tar.append (header);
+
+				tar.append (contents.data);
+				tar.append (new uint8[(512 - (contents.length % 512)) % 512]);
+			}
+			tar.append (new uint8[1024]);
+
+			var compressed = new MemoryOutputStream.resizable ();
+			var gzip = new ConverterOutputStream (compressed, new ZlibCompressor (GZIP));
+			size_t bytes_written;
+			gzip.write_all (tar.data, out bytes_written);
+			gzip.close ();
+			return compressed.steal_as_bytes ();
+		}
+
+		private static string compute_integrity (Bytes data) {
+			var checksum = new Checksum (SHA512);
+			checksum.update (data.get_data (), data.get_size ());
+			var digest = new uint8[64];
+			size_t digest_length = digest.length;
+			checksum.get_digest (digest, ref digest_length);
+			return "sha512-" + Base64.encode (digest);
+		}
+	}
+
+	private sealed class Workspace : Object {
+		public File root {
+			get;
+			private set;
+		}
+
+		public File cache_dir {
+			owned get {
+				return root.get_child ("cache");
+			}
+		}
+
+		public Workspace () throws GLib.Error {
+			root = File.new_for_path (DirUtils.make_tmp ("frida-package-manager-test.XXXXXX"));
+		}
+
+		public void destroy () throws GLib.Error {
+			FS.rmtree (root);
+		}
+
+		public PackageInstallOptions make_install_options (string project) throws GLib.Error {
+			File project_root = root.get_child (project);
+			project_root.make_directory ();
+
+			var options = new PackageInstallOptions ();
+			options.project_root = project_root.get_path ();
+			options.add_spec ("frida-test-pkg@1.0.0");
+			return options;
+		}
+
+		public File project_file (string project, string path) {
+			return root.get_child (project).resolve_relative_path (path);
+		}
+
+		public void corrupt_cached_responses () throws GLib.Error {
+			File dir = cache_dir.get_child ("content").get_child ("sha256");
+			var enumerator = dir.enumerate_children (FileAttribute.STANDARD_NAME, NOFOLLOW_SYMLINKS);
+			FileInfo? info;
+			while ((info = enumerator.next_file ()) != null)
+				FileUtils.set_contents (dir.get_child (info.get_name ()).get_path (), "{\"truncated\":");
+		}
+
+		public void tamper_with_cached_tarballs () throws GLib.Error {
+			File dir = cache_dir.get_child ("content").get_child ("sha512");
+			var enumerator = dir.enumerate_children (FileAttribute.STANDARD_NAME, NOFOLLOW_SYMLINKS);
+			FileInfo? info;
+			while ((info = enumerator.next_file ()) != null)
+				FileUtils.set_contents (dir.get_child (info.get_name ()).get_path (), "not a tarball");
+		}
+
+		public uint count_cached_blobs () throws GLib.Error {
+			uint count = 0;
+			File content_dir = cache_dir.get_child ("content");
+			if (!content_dir.query_exists ())
+				return 0;
+			var algo_dirs = content_dir.enumerate_children (FileAttribute.STANDARD_NAME, NOFOLLOW_SYMLINKS);
+			FileInfo? algo_info;
+			while ((algo_info = algo_dirs.next_file ()) != null) {
+				var blobs = content_dir.get_child (algo_info.get_name ()).enumerate_children (FileAttribute.STANDARD_NAME,
+					NOFOLLOW_SYMLINKS);
+				while (blobs.next_file () != null)
+					count++;
+			}
+			return count;
+		}
+	}
+
+	private sealed class Harness : Frida.Test.AsyncHarness {
+		public Harness (owned Frida.Test.AsyncHarness.TestSequenceFunc func) {
+			base ((owned) func);
+		}
+	}
+}
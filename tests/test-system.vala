@@ -30,5 +30,52 @@ namespace Frida.SystemTest {
 			if (GLib.Test.verbose ())
 				stdout.printf (" [spent %f and %f] ", time_spent_on_first_run, time_spent_on_second_run);
 		});
+
+		GLib.Test.add_func ("/System/enumerate-processes-since-snapshot", () => {
+			if (Frida.Test.os () != Frida.Test.OS.LINUX) {
+				stdout.printf ("<skipping, test only available on Linux for now> ");
+				return;
+			}
+
+			var options = new ProcessQueryOptions ();
+			options.snapshot = "test";
+
+			var initial = System.enumerate_processes (options);
+			assert_true (initial.length > 0);
+
+			var delta = System.enumerate_processes (options);
+			assert_true (delta.length < initial.length);
+		});
+
+		GLib.Test.add_func ("/System/process-snapshots-are-private-to-each-enumerator", () => {
+			var loop = new MainLoop ();
+			check_snapshot_scoping.begin (loop);
+			loop.run ();
+		});
+	}
+
+	private static async void check_snapshot_scoping (MainLoop loop) {
+		var first = new ProcessEnumerator ();
+		var second = new ProcessEnumerator ();
+
+		var options = new ProcessQueryOptions ();
+		options.snapshot = "shared-name";
+
+		try {
+			var initial = yield first.enumerate_processes (options);
+			assert_true (Frida.Test.os () == Frida.Test.OS.LINUX);
+			assert_true (options.snapshot == "shared-name");
+
+			var delta = yield first.enumerate_processes (options);
+			assert_true (delta.length < initial.length);
+
+			var other = yield second.enumerate_processes (options);
+			assert_true (other.length > delta.length);
+		} catch (Error e) {
+			assert_true (Frida.Test.os () != Frida.Test.OS.LINUX);
+			assert_true (e is Error.NOT_SUPPORTED);
+		}
+
+		loop.quit ();
 	}
 }